@@ -396,12 +396,14 @@ int SpriteCache::SaveToFile(const String &filename, int store_flags, SpriteCompr
 }
 
 HError SpriteCache::InitFile(std::unique_ptr<Stream> &&sprite_file,
-                             std::unique_ptr<Stream> &&index_file)
+                             std::unique_ptr<Stream> &&index_file,
+                             std::unique_ptr<Stream> &&alt_index_file)
 {
     Reset();
 
     std::vector<GraphicResolution> metrics;
-    HError err = _file.OpenFile(std::move(sprite_file), std::move(index_file), metrics);
+    HError err = _file.OpenFile(std::move(sprite_file), std::move(index_file), metrics,
+                                std::move(alt_index_file));
     if (!err)
         return err;
 
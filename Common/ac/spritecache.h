@@ -85,9 +85,11 @@ public:
     SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks);
     ~SpriteCache() = default;
 
-    // Loads sprite reference information and inits sprite stream
+    // Loads sprite reference information and inits sprite stream;
+    // optional alternate index file is used if the main one does not match
     HError      InitFile(std::unique_ptr<Stream> &&sprite_file,
-                         std::unique_ptr<Stream> &&index_file);
+                         std::unique_ptr<Stream> &&index_file,
+                         std::unique_ptr<Stream> &&alt_index_file = nullptr);
     // Saves current cache contents to the file
     int         SaveToFile(const String &filename, int store_flags, SpriteCompression compress, SpriteFileIndex &index);
     // Closes an active sprite file stream
@@ -95,6 +97,8 @@ public:
 
     inline int GetStoreFlags() const { return _file.GetStoreFlags(); }
     inline SpriteCompression GetSpriteCompression() const { return _file.GetSpriteCompression(); }
+    // Returns the sprite index if it had to be rebuilt when opening the file
+    inline std::unique_ptr<SpriteFileIndex> ReleaseRebuiltIndex() { return _file.ReleaseRebuiltIndex(); }
 
     // Tells if there is a sprite registered for the given index;
     // this includes sprites that were explicitly assigned but failed to init and were remapped
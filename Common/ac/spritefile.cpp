@@ -165,8 +165,32 @@ SpriteFile::SpriteFile()
     _curPos = -2;
 }
 
+// Calculates a checksum of the sprite index data (FNV-1a),
+// in a way that does not depend on the system byte order
+static uint32_t CalcIndexChecksum(const SpriteFileIndex &index)
+{
+    uint32_t hash = 2166136261u;
+    auto hash_value = [&hash](uint64_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i, value >>= 8)
+            hash = (hash ^ static_cast<uint8_t>(value)) * 16777619u;
+    };
+    hash_value(static_cast<uint32_t>(index.SpriteFileIDCheck), sizeof(int32_t));
+    hash_value(index.GetCount(), sizeof(int32_t));
+    for (size_t i = 0; i < index.GetCount(); ++i)
+    {
+        hash_value(static_cast<uint16_t>(index.Widths[i]), sizeof(int16_t));
+        hash_value(static_cast<uint16_t>(index.Heights[i]), sizeof(int16_t));
+        hash_value(static_cast<uint8_t>(index.Depths[i]), sizeof(int8_t));
+        hash_value(static_cast<uint64_t>(index.Offsets[i]), sizeof(int64_t));
+    }
+    hash_value(static_cast<uint64_t>(index.SpriteFileSize), sizeof(int64_t));
+    return hash;
+}
+
 HError SpriteFile::OpenFile(std::unique_ptr<Stream> &&sprite_file,
-    std::unique_ptr<Stream> &&index_file, std::vector<GraphicResolution> &metrics)
+    std::unique_ptr<Stream> &&index_file, std::vector<GraphicResolution> &metrics,
+    std::unique_ptr<Stream> &&alt_index_file)
 {
     Close();
 
@@ -236,15 +260,25 @@ HError SpriteFile::OpenFile(std::unique_ptr<Stream> &&sprite_file,
     }
 
     // if there is a sprite index file, use it
+    const soff_t spr_data_offs = _stream->GetPosition();
     if (LoadSpriteIndexFile(std::move(index_file), spriteFileID,
         spr_initial_offs, topmost, metrics))
     {
         // Succeeded
         return HError::None();
     }
+    if (LoadSpriteIndexFile(std::move(alt_index_file), spriteFileID,
+        spr_initial_offs, topmost, metrics))
+    {
+        return HError::None();
+    }
 
     // Failed, index file is invalid; index sprites manually
-    return RebuildSpriteIndex(_stream.get(), topmost, metrics);
+    _stream->Seek(spr_data_offs, kSeekBegin);
+    HError err = RebuildSpriteIndex(_stream.get(), topmost, spr_initial_offs, metrics);
+    if (_rebuiltIndex)
+        _rebuiltIndex->SpriteFileIDCheck = spriteFileID;
+    return err;
 }
 
 void SpriteFile::Close()
@@ -255,6 +289,7 @@ void SpriteFile::Close()
     _storeFlags = 0;
     _compress = kSprCompress_None;
     _curPos = -2;
+    _rebuiltIndex.reset();
 }
 
 int SpriteFile::GetStoreFlags() const
@@ -315,34 +350,53 @@ bool SpriteFile::LoadSpriteIndexFile(std::unique_ptr<Stream> &&fidx,
     }
 
     sprkey_t numsprits = topmost_index + 1;
-    std::vector<int16_t> spritewidths; spritewidths.resize(numsprits);
-    std::vector<int16_t> spriteheights; spriteheights.resize(numsprits);
-    std::vector<int8_t>  spritedepths; spritedepths.resize(numsprits);
-    std::vector<soff_t>  spriteoffs; spriteoffs.resize(numsprits);
-
-    fidx->ReadArrayOfInt16(&spritewidths[0], numsprits);
-    fidx->ReadArrayOfInt16(&spriteheights[0], numsprits);
+    SpriteFileIndex index;
+    index.SpriteFileIDCheck = expectedFileID;
+    index.Widths.resize(numsprits);
+    index.Heights.resize(numsprits);
+    index.Depths.resize(numsprits);
+    index.Offsets.resize(numsprits);
+
+    fidx->ReadArrayOfInt16(&index.Widths[0], numsprits);
+    fidx->ReadArrayOfInt16(&index.Heights[0], numsprits);
     if (vers <= kSpridxfVersion_Last32bit)
     {
         for (sprkey_t i = 0; i < numsprits; ++i)
-            spriteoffs[i] = fidx->ReadInt32();
+            index.Offsets[i] = fidx->ReadInt32();
     }
     else // large file support
     {
-        fidx->ReadArrayOfInt64(&spriteoffs[0], numsprits);
+        fidx->ReadArrayOfInt64(&index.Offsets[0], numsprits);
     }
 
     if (vers >= kSpridxfVersion_ColorDepths)
     {
-        fidx->ReadArrayOfInt8(&spritedepths[0], numsprits);
+        fidx->ReadArrayOfInt8(&index.Depths[0], numsprits);
+    }
+
+    if (vers >= kSpridxfVersion_Validated)
+    {
+        // test that the index data is intact, and made for the file of this size
+        index.SpriteFileSize = fidx->ReadInt64();
+        const uint32_t checksum = static_cast<uint32_t>(fidx->ReadInt32());
+        if (fidx->GetError() || (checksum != CalcIndexChecksum(index)) ||
+            (index.SpriteFileSize != _stream->GetLength() - spr_initial_offs))
+        {
+            return false;
+        }
+    }
+
+    if (!ValidateSpriteIndex(index, spr_initial_offs))
+    {
+        return false;
     }
 
     for (sprkey_t i = 0; i <= topmost_index; ++i)
     {
-        if (spriteoffs[i] != 0)
+        if (index.Offsets[i] != 0)
         {
-            _spriteData[i].Offset = spriteoffs[i] + spr_initial_offs;
-            metrics[i] = GraphicResolution(spritewidths[i], spriteheights[i], spritedepths[i]);
+            _spriteData[i].Offset = index.Offsets[i] + spr_initial_offs;
+            metrics[i] = GraphicResolution(index.Widths[i], index.Heights[i], index.Depths[i]);
         }
     }
     return true;
@@ -367,14 +421,47 @@ static inline void ReadSprHeader(SpriteDatHeader &hdr, Stream *in,
     hdr = SpriteDatHeader(bpp, sformat, pal_count, compress, w, h);
 }
 
-HError SpriteFile::RebuildSpriteIndex(Stream *in, sprkey_t topmost, std::vector<GraphicResolution> &metrics)
+bool SpriteFile::ValidateSpriteIndex(const SpriteFileIndex &index, soff_t spr_initial_offs)
+{
+    // Cross-check the last existing sprite's header with the index data:
+    // this requires only a single seek, but detects most of the outdated
+    // index files, since any change in the sprite set shifts the last sprite.
+    const soff_t file_len = _stream->GetLength();
+    for (size_t i = index.GetCount(); i-- > 0;)
+    {
+        if (index.Offsets[i] == 0 || index.Widths[i] == 0)
+            continue;
+        if (index.Offsets[i] + spr_initial_offs >= file_len)
+            return false;
+        const soff_t old_pos = _stream->GetPosition();
+        _stream->Seek(index.Offsets[i] + spr_initial_offs, kSeekBegin);
+        SpriteDatHeader hdr;
+        ReadSprHeader(hdr, _stream.get(), _version, _compress);
+        _stream->Seek(old_pos, kSeekBegin);
+        return (hdr.Width == index.Widths[i]) && (hdr.Height == index.Heights[i]) &&
+            ((index.Depths[i] == 0) || (hdr.BPP * 8 == index.Depths[i]));
+    }
+    return true;
+}
+
+HError SpriteFile::RebuildSpriteIndex(Stream *in, sprkey_t topmost, soff_t spr_initial_offs,
+    std::vector<GraphicResolution> &metrics)
 {
+    // NOTE: sprites are stored one after another, and each one's offset
+    // depends on the sizes of all the previous ones, therefore the headers
+    // have to be read in sequence.
     topmost = std::min(topmost, (sprkey_t)_spriteData.size() - 1);
-    for (sprkey_t i = 0; !in->EOS() && (i <= topmost); ++i)
+    std::unique_ptr<SpriteFileIndex> index(new SpriteFileIndex());
+    sprkey_t i = 0;
+    for (; !in->EOS() && (i <= topmost); ++i)
     {
         _spriteData[i].Offset = in->GetPosition();
         SpriteDatHeader hdr;
         ReadSprHeader(hdr, _stream.get(), _version, _compress);
+        index->Offsets.push_back(_spriteData[i].Offset - spr_initial_offs);
+        index->Widths.push_back(hdr.Width);
+        index->Heights.push_back(hdr.Height);
+        index->Depths.push_back(hdr.BPP * 8);
         if (hdr.BPP == 0) continue; // empty slot, this is normal
         int pal_bpp = GetPaletteBPP(hdr.SFormat);
         if (pal_bpp > 0) in->Seek(hdr.PalCount * pal_bpp); // skip palette
@@ -384,6 +471,14 @@ HError SpriteFile::RebuildSpriteIndex(Stream *in, sprkey_t topmost, std::vector<
         in->Seek(data_sz); // skip image data
         metrics[i] = GraphicResolution(hdr.Width, hdr.Height, hdr.BPP * 8);
     }
+
+    // Only keep the rebuilt index if it's complete, and the file has all
+    // the sprite slots, otherwise it won't pass the validation next time
+    if ((i > topmost) && (_version >= kSprfVersion_Last32bit))
+    {
+        index->SpriteFileSize = in->GetLength() - spr_initial_offs;
+        _rebuiltIndex = std::move(index);
+    }
     return HError::None();
 }
 
@@ -449,6 +544,8 @@ HError SpriteFile::LoadSprite(sprkey_t index, Common::Bitmap *&sprite)
             break;
         case kSprCompress_Deflate: result = inflate_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
             break;
+        case kSprCompress_LZ4: result = lz4_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
+            break;
         default: assert(!"Unsupported compression type!"); result = false; break;
         }
         // TODO: test that not more than data_size was read!
@@ -629,8 +726,11 @@ int SaveSpriteIndex(const String &filename, const SpriteFileIndex &index)
         out->WriteArrayOfInt16(&index.Widths[0], index.Widths.size());
         out->WriteArrayOfInt16(&index.Heights[0], index.Heights.size());
         out->WriteArrayOfInt64(&index.Offsets[0], index.Offsets.size());
+        out->WriteArrayOfInt8(&index.Depths[0], index.Depths.size());
     }
-    out->WriteArrayOfInt8(&index.Depths[0], index.Depths.size());
+    // write validation data
+    out->WriteInt64(index.SpriteFileSize);
+    out->WriteInt32(static_cast<int32_t>(CalcIndexChecksum(index)));
     return 0;
 }
 
@@ -712,6 +812,8 @@ void SpriteFileWriter::WriteBitmap(Bitmap *image)
             break;
         case kSprCompress_Deflate: result = deflate_compress(im_data.Buf, im_data.Size, im_data.BPP, &mems);
             break;
+        case kSprCompress_LZ4: result = lz4_compress(im_data.Buf, im_data.Size, im_data.BPP, &mems);
+            break;
         default: assert(!"Unsupported compression type!"); result = false; break;
         }
         // mark to write as a plain byte array
@@ -800,6 +902,7 @@ void SpriteFileWriter::WriteRawData(const SpriteDatHeader &hdr, const uint8_t *d
 void SpriteFileWriter::Finalize()
 {
     if (!_out || _lastSlotPos < 0) return;
+    _index.SpriteFileSize = _out->GetLength();
     _out->Seek(_lastSlotPos, kSeekBegin);
     _out->WriteInt32(_index.GetLastSlot());
     _out.reset();
@@ -57,7 +57,8 @@ enum SpriteIndexFileVersion
     kSpridxfVersion_64bit = 10,
     kSpridxfVersion_HighSpriteLimit = 11,
     kSpridxfVersion_ColorDepths = 12,
-    kSpridxfVersion_Current = kSpridxfVersion_ColorDepths
+    kSpridxfVersion_Validated = 13,
+    kSpridxfVersion_Current = kSpridxfVersion_Validated
 };
 
 // Instructions to how the sprites are allowed to be stored
@@ -85,7 +86,8 @@ enum SpriteCompression
     kSprCompress_None = 0,
     kSprCompress_RLE,
     kSprCompress_LZW,
-    kSprCompress_Deflate
+    kSprCompress_Deflate,
+    kSprCompress_LZ4
 };
 
 typedef int32_t sprkey_t;
@@ -98,6 +100,7 @@ struct SpriteFileIndex
     std::vector<int16_t> Heights;
     std::vector<int8_t>  Depths;
     std::vector<soff_t>  Offsets;
+    soff_t SpriteFileSize = 0; // length of the indexed sprite file, for validation
 
     inline size_t GetCount() const { return Offsets.size(); }
     inline sprkey_t GetLastSlot() const { return (sprkey_t)GetCount() - 1; }
@@ -131,10 +134,13 @@ public:
     static const String DefaultSpriteIndexName;
 
     SpriteFile();
-    // Loads sprite reference information and inits sprite stream
+    // Loads sprite reference information and inits sprite stream;
+    // tries the index file first, and the alternate index file next,
+    // if neither of them matches the sprite file then rebuilds the index.
     HError      OpenFile(std::unique_ptr<Stream> &&sprite_file,
                          std::unique_ptr<Stream> &&index_file,
-                         std::vector<GraphicResolution> &metrics);
+                         std::vector<GraphicResolution> &metrics,
+                         std::unique_ptr<Stream> &&alt_index_file = nullptr);
     // Closes stream; no reading will be possible unless opened again
     void        Close();
 
@@ -143,6 +149,9 @@ public:
     SpriteCompression GetSpriteCompression() const;
     // Tells the highest known sprite index
     sprkey_t    GetTopmostSprite() const;
+    // Returns the sprite index, if it had to be rebuilt when opening the file,
+    // which may be saved for the future use; otherwise returns null
+    std::unique_ptr<SpriteFileIndex> ReleaseRebuiltIndex() { return std::move(_rebuiltIndex); }
 
     // Loads sprite index file
     bool        LoadSpriteIndexFile(std::unique_ptr<Stream> &&index_file,
@@ -155,8 +164,11 @@ public:
     HError      LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data);
 
 private:
+    // Tests that the loaded sprite index matches the sprite file
+    bool        ValidateSpriteIndex(const SpriteFileIndex &index, soff_t spr_initial_offs);
     // Rebuilds sprite index from the main sprite file
-    HError      RebuildSpriteIndex(Stream *in, sprkey_t topmost, std::vector<GraphicResolution> &metrics);
+    HError      RebuildSpriteIndex(Stream *in, sprkey_t topmost, soff_t spr_initial_offs,
+                                   std::vector<GraphicResolution> &metrics);
     // Seek stream to sprite
     void        SeekToSprite(sprkey_t index);
 
@@ -175,6 +187,8 @@ private:
     int _storeFlags = 0; // storage flags, specify how sprites may be stored
     SpriteCompression _compress = kSprCompress_None; // sprite compression type
     sprkey_t _curPos; // current stream position (sprite slot)
+    // The sprite index rebuilt from the sprite file, if there was no valid one
+    std::unique_ptr<SpriteFileIndex> _rebuiltIndex;
 };
 
 
@@ -14,6 +14,7 @@
 #include "core/assetmanager.h"
 #include <algorithm>
 #include <regex>
+#include "core/platform.h"
 #include "util/directory.h"
 #include "util/file.h"
 #include "util/multifilelib.h"
@@ -100,6 +101,12 @@ AssetError AssetManager::AddLibrary(const String &path, const String &filters, c
             // already present, only assign new filters
             lib->FilterString = filters;
             lib->Filters = filters.Split(',');
+            // registering a directory again also rereads its contents,
+            // in case any files were added or removed since
+            {
+                std::lock_guard<std::mutex> lk(_dirIndexMutex);
+                lib->DirIndex.clear();
+            }
             if (out_lib)
                 *out_lib = lib.get();
             return kAssetNoError;
@@ -165,17 +172,13 @@ bool AssetManager::DoesAssetExist(const String &asset_name, const String &filter
 
         if (IsAssetLibDir(lib))
         {
-            String filename = File::FindFileCI(lib->BaseDir, asset_name);
-            if (!filename.IsEmpty())
+            if (!FindAssetInDir(lib, asset_name).IsEmpty())
                 return true;
         }
         else
         {
-            for (const auto &a : lib->AssetInfos)
-            {
-                if (a.FileName.CompareNoCase(asset_name) == 0)
-                    return true;
-            }
+            if (FindAssetInLib(lib, asset_name))
+                return true;
         }
     }
     return false;
@@ -224,9 +227,7 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
         lib.reset(new AssetLibEx());
         lib->BasePath = Path::MakeAbsolutePath(path);
         lib->BaseDir = Path::GetDirectoryPath(lib->BasePath);
-
-        // TODO: maybe parse directory for the faster file reference?
-        //       but if we do, then we likely would require a file watcher?
+        // NOTE: directory contents are indexed on demand, see FindAssetInDir
     }
     // ...else try open a data library
     else
@@ -251,6 +252,14 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
         {
             lib->RealLibFiles.push_back(File::FindFileCI(lib->BaseDir, lib->LibFileNames[i]));
         }
+
+        // Index assets for the fast lookup; if there are duplicate names,
+        // then the first one is used, same as the linear search would do
+        lib->AssetIndex.reserve(lib->AssetInfos.size());
+        for (size_t i = 0; i < lib->AssetInfos.size(); ++i)
+        {
+            lib->AssetIndex.emplace(lib->AssetInfos[i].FileName, i);
+        }
     }
 
     out_lib = lib.get();
@@ -275,24 +284,80 @@ std::unique_ptr<Stream> AssetManager::OpenAsset(const String &asset_name, const
     return nullptr;
 }
 
-std::unique_ptr<Stream> AssetManager::OpenAssetFromLib(const AssetLibEx *lib, const String &asset_name) const
+const AssetInfo *AssetManager::FindAssetInLib(const AssetLibEx *lib, const String &asset_name) const
 {
-    for (const auto &a : lib->AssetInfos)
+    auto it = lib->AssetIndex.find(asset_name);
+    if (it == lib->AssetIndex.end())
+        return nullptr;
+    return &lib->AssetInfos[it->second];
+}
+
+String AssetManager::FindAssetInDir(const AssetLibEx *lib, const String &asset_name) const
+{
+    String filename = asset_name;
+    Path::FixupPath(filename);
+    // Absolute paths are not indexed, pass them to the regular search
+    if (filename.IsEmpty() || !Path::IsRelativePath(filename))
+        return File::FindFileCI(lib->BaseDir, asset_name);
+
+    // Walk the path sections, looking each one up in the cached listing
+    // of the parent directory; listings are read on the first access.
+    std::lock_guard<std::mutex> lk(_dirIndexMutex);
+    String subdir; // relative subdir, in the real letter case
+    String path = lib->BaseDir;
+    const FileEntry *entry = nullptr;
+    for (size_t begin = 0u; begin < filename.GetLength();)
     {
-        if (a.FileName.CompareNoCase(asset_name) == 0)
+        const size_t end = std::min(filename.FindChar('/', begin), filename.GetLength());
+        const String section = filename.Mid(begin, end - begin);
+        begin = end + 1;
+        if (section.IsEmpty() || section == ".")
+            continue;
+        if (section == "..")
+            return File::FindFileCI(lib->BaseDir, asset_name); // not indexed
+        if (entry && !entry->IsDir)
+            return {}; // parent is not a directory
+
+        auto dir_it = lib->DirIndex.find(subdir);
+        if (dir_it == lib->DirIndex.end())
+        {
+            DirListing listing;
+            for (auto di = DirectoryIterator::Open(path); !di.AtEnd(); di.Next())
+                listing.emplace(di.Current(), di.GetEntry());
+            dir_it = lib->DirIndex.emplace(subdir, std::move(listing)).first;
+        }
+
+        auto file_it = dir_it->second.find(section);
+        if (file_it == dir_it->second.end())
         {
-            String libfile = lib->RealLibFiles[a.LibUid];
-            if (libfile.IsEmpty())
-                return nullptr;
-            return File::OpenFile(libfile, a.Offset, a.Offset + a.Size);
+#if AGS_PLATFORM_OS_ANDROID
+            // Android asset dirs do not list subdirectories, test the exact path
+            if (end < filename.GetLength())
+                return File::FindFileCI(lib->BaseDir, asset_name);
+#endif
+            return {}; // not found
         }
+        entry = &file_it->second;
+        subdir = Path::ConcatPaths(subdir, entry->Name);
+        path = Path::ConcatPaths(path, entry->Name);
     }
-    return nullptr;
+    return (entry && entry->IsFile) ? path : String();
+}
+
+std::unique_ptr<Stream> AssetManager::OpenAssetFromLib(const AssetLibEx *lib, const String &asset_name) const
+{
+    const AssetInfo *a = FindAssetInLib(lib, asset_name);
+    if (!a)
+        return nullptr;
+    String libfile = lib->RealLibFiles[a->LibUid];
+    if (libfile.IsEmpty())
+        return nullptr;
+    return File::OpenFile(libfile, a->Offset, a->Offset + a->Size);
 }
 
 std::unique_ptr<Stream> AssetManager::OpenAssetFromDir(const AssetLibEx *lib, const String &file_name) const
 {
-    String found_file = File::FindFileCI(lib->BaseDir, file_name);
+    String found_file = FindAssetInDir(lib, file_name);
     if (found_file.IsEmpty())
         return nullptr;
     return File::OpenFileRead(found_file);
@@ -38,8 +38,12 @@
 
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include "core/asset.h"
+#include "util/directory.h"
 #include "util/stream.h"
+#include "util/string_types.h"
 
 namespace AGS
 {
@@ -106,6 +110,7 @@ public:
     AssetError   AddLibrary(const String &path, const AssetLibInfo **lib = nullptr);
     // Add library location, specifying comma-separated list of filters;
     // if library was already added before, this method will overwrite the filters only
+    // (and make the contents of a library directory to be read anew)
     AssetError   AddLibrary(const String &path, const String &filters, const AssetLibInfo **lib = nullptr);
     // Remove library location from the list of asset locations
     void         RemoveLibrary(const String &path);
@@ -135,18 +140,31 @@ public:
         { return OpenAsset(apath.Name, apath.Filter); }
 
 private:
+    // Case-insensitive listing of a single directory
+    typedef std::unordered_map<String, FileEntry, HashStrNoCase, StrEqNoCase> DirListing;
+
     // AssetLibEx combines library info with extended internal data required for the manager
     struct AssetLibEx : AssetLibInfo
     {
         String FilterString; // filter string, as received on input (for diagnostic purposes)
         std::vector<String> Filters; // asset filters this library is matching to
         std::vector<String> RealLibFiles; // fixed up library filenames
+        // Case-insensitive lookup of assets in a library file: name -> AssetInfos index
+        std::unordered_map<String, size_t, HashStrNoCase, StrEqNoCase> AssetIndex;
+        // Directory listings of a library dir, keyed by relative subdir path;
+        // filled on demand, when a subdirectory is looked into for the first time
+        mutable std::unordered_map<String, DirListing, HashStrNoCase, StrEqNoCase> DirIndex;
 
         bool TestFilter(const String &filter) const;
     };
 
     // Loads library and registers its contents into the cache
     AssetError  RegisterAssetLib(const String &path, AssetLibEx *&lib);
+    // Finds asset in the library file, returns null if one is not present
+    const AssetInfo *FindAssetInLib(const AssetLibEx *lib, const String &asset_name) const;
+    // Finds file in the library directory, using case-insensitive search;
+    // returns the full path to the existing file, or empty string on failure
+    String      FindAssetInDir(const AssetLibEx *lib, const String &asset_name) const;
 
     // Tries to find asset in the given location, and then opens a stream for reading
     std::unique_ptr<Stream> OpenAssetFromLib(const AssetLibEx *lib, const String &asset_name) const;
@@ -157,6 +175,8 @@ private:
     AssetSearchPriority _libsPriority = kAssetPriorityDir;
     // Sorting function, depends on priority setting
     std::function<bool(const AssetLibInfo*, const AssetLibInfo*)> _libsSorter;
+    // Guards directory listings, which are filled on demand by const methods
+    mutable std::mutex _dirIndexMutex;
 };
 
 
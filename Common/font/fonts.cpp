@@ -24,6 +24,8 @@
 #include "gfx/bitmap.h"
 #include "gui/guidefines.h" // MAXLINE
 #include "util/path.h"
+#include "util/resourcecache.h"
+#include "util/string_types.h"
 #include "util/string_utils.h"
 #include "util/utf8.h"
 
@@ -60,12 +62,75 @@ struct Font
     Font &operator =(Font &&font) = default;
 };
 
+// TextLayoutKey describes the parameters of a split_lines call
+struct TextLayoutKey
+{
+    String Text;
+    int FontNumber = 0;
+    int Width = 0;
+    size_t MaxLines = 0u;
+    int UFormat = 0;
+
+    bool operator ==(const TextLayoutKey &other) const
+    {
+        return (FontNumber == other.FontNumber) && (Width == other.Width) &&
+            (MaxLines == other.MaxLines) && (UFormat == other.UFormat) &&
+            (Text == other.Text);
+    }
+};
+
+struct TextLayoutKeyHash
+{
+    size_t operator ()(const TextLayoutKey &key) const
+    {
+        size_t hash = FNV::Hash(key.Text.GetCStr(), key.Text.GetLength());
+        hash = (hash * FNV::SECONDARY_NUMBER) ^ static_cast<size_t>(key.FontNumber);
+        hash = (hash * FNV::SECONDARY_NUMBER) ^ static_cast<size_t>(key.Width);
+        hash = (hash * FNV::SECONDARY_NUMBER) ^ key.MaxLines;
+        return hash;
+    }
+};
+
+// TextLayoutCache remembers the results of the recent split_lines calls,
+// which lets skip measuring and breaking up the texts that are laid out
+// repeatedly, such as labels, speech and wrapped strings.
+class TextLayoutCache :
+    public ResourceCache<TextLayoutKey, std::vector<String>, size_t, TextLayoutKeyHash>
+{
+public:
+    // Max size of the cached lines, in bytes
+    static const size_t DefaultCacheSize = 256 * 1024;
+
+    TextLayoutCache()
+        : ResourceCache(DefaultCacheSize) {}
+
+protected:
+    size_t CalcSize(const std::vector<String> &lines) override
+    {
+        // Account for the key's text too, which is roughly the same length
+        size_t size = sizeof(TextLayoutKey) + sizeof(lines);
+        for (const auto &line : lines)
+            size += sizeof(String) + (line.GetLength() + 1) * 2;
+        return size;
+    }
+};
+
 } // Common
 } // AGS
 
 static std::vector<Font> fonts;
 static std::unique_ptr<TTFFontRenderer> ttfRenderer;
 static std::unique_ptr<WFNFontRenderer> wfnRenderer;
+static TextLayoutCache text_layouts;
+// Incremented each time when the text layouts may become invalid
+static uint32_t text_layout_version = 0u;
+
+// Resets all the text layouts, called whenever fonts are changed
+static void invalidate_text_layouts()
+{
+    text_layouts.Clear();
+    text_layout_version++;
+}
 
 
 FontInfo::FontInfo()
@@ -114,6 +179,9 @@ bool is_font_loaded(size_t fontNumber)
 // Finish font's initialization
 static void font_post_init(size_t fontNumber)
 {
+    // Font parameters may have changed, so previous layouts are no longer valid
+    invalidate_text_layouts();
+
     Font &font = fonts[fontNumber];
     // If no font height property was provided, then try several methods,
     // depending on which interface is available
@@ -303,6 +371,7 @@ void set_font_outline(size_t font_number, int outline_type,
     fonts[font_number].Info.Outline = outline_type;
     fonts[font_number].Info.AutoOutlineStyle = style;
     fonts[font_number].Info.AutoOutlineThickness = thickness;
+    invalidate_text_layouts();
 }
 
 bool is_font_antialiased(size_t font_number)
@@ -385,7 +454,7 @@ int get_text_lines_surf_height(size_t fontNumber, size_t numlines)
 namespace AGS { namespace Common { SplitLines Lines; } }
 
 // Break up the text into lines
-size_t split_lines(const char *todis, SplitLines &lines, int wii, int fonnt, size_t max_lines)
+static size_t split_lines_impl(const char *todis, SplitLines &lines, int wii, int fonnt, size_t max_lines)
 {
     lines.Reset();
 
@@ -465,6 +534,48 @@ size_t split_lines(const char *todis, SplitLines &lines, int wii, int fonnt, siz
     return lines.Count();
 }
 
+uint32_t get_text_layout_version()
+{
+    return text_layout_version;
+}
+
+bool font_supports_layout_cache(int fontNumber)
+{
+    // Only cache layouts for the built-in renderers, because plugins
+    // may change their fonts without notifying us
+    return (fontNumber >= 0) && (static_cast<size_t>(fontNumber) < fonts.size()) &&
+        fonts[fontNumber].RendererInt;
+}
+
+size_t split_lines(const char *todis, SplitLines &lines, int wii, int fonnt, size_t max_lines)
+{
+    if (!font_supports_layout_cache(fonnt))
+        return split_lines_impl(todis, lines, wii, fonnt, max_lines);
+
+    TextLayoutKey key;
+    key.Text = String::Wrapper(todis);
+    key.FontNumber = fonnt;
+    key.Width = wii;
+    key.MaxLines = max_lines;
+    key.UFormat = get_uformat();
+    if (text_layouts.Exists(key))
+    {
+        lines.Reset();
+        for (const auto &line : text_layouts.Get(key))
+            lines.Add(line.GetCStr());
+        return lines.Count();
+    }
+
+    split_lines_impl(todis, lines, wii, fonnt, max_lines);
+    std::vector<String> cached_lines;
+    cached_lines.reserve(lines.Count());
+    for (size_t i = 0; i < lines.Count(); ++i)
+        cached_lines.push_back(String(lines[i].GetCStr())); // make a unique copy
+    key.Text = String(todis); // cache must own the key text
+    text_layouts.Put(key, std::move(cached_lines));
+    return lines.Count();
+}
+
 void wouttextxy(Bitmap *ds, int xxx, int yyy, size_t fontNumber, color_t text_color, const char *texx)
 {
   if (fontNumber >= fonts.size())
@@ -594,6 +705,7 @@ void alloc_font_outline_buffers(size_t font_number,
 
 void adjust_fonts_for_render_mode(bool aa_mode)
 {
+    invalidate_text_layouts();
     for (size_t i = 0; i < fonts.size(); ++i)
     {
         if (fonts[i].RendererInt)
@@ -606,6 +718,7 @@ void wfreefont(size_t fontNumber)
   if (fontNumber >= fonts.size())
     return;
 
+  invalidate_text_layouts();
   fonts[fontNumber].TextStencilSub.Destroy();
   fonts[fontNumber].OutlineStencilSub.Destroy();
   fonts[fontNumber].TextStencil.Destroy();
@@ -618,6 +731,7 @@ void wfreefont(size_t fontNumber)
 
 void free_all_fonts()
 {
+    invalidate_text_layouts();
     for (size_t i = 0; i < fonts.size(); ++i)
     {
         if (fonts[i].Renderer != nullptr)
@@ -139,12 +139,18 @@ public:
 
 private:
     std::vector<AGS::Common::String> _pool;
-    size_t _count; // actual number of lines in use
+    size_t _count = 0u; // actual number of lines in use
 };
 
 // Break up the text into lines restricted by the given width;
 // returns number of lines, or 0 if text cannot be split well to fit in this width
 size_t split_lines(const char *texx, SplitLines &lines, int width, int fontNumber, size_t max_lines = -1);
+// Returns a number which is changed whenever any font is changed in a way
+// that may invalidate previously made text layouts
+uint32_t get_text_layout_version();
+// Tells whether text layouts made with this font may be cached,
+// that is whether get_text_layout_version tracks all of its changes
+bool font_supports_layout_cache(int fontNumber);
 
 namespace AGS { namespace Common { extern SplitLines Lines; } }
 
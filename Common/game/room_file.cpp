@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <thread>
 #include "ac/common.h" // update_polled_stuff
 #include "ac/common_defines.h"
 #include "ac/gamestructdefines.h"
@@ -75,8 +76,84 @@ void WriteRoomObjectBase(const RoomObjectInfo &obj, Stream *out)
     out->WriteInt16(0); // [OBSOLETE], old enabled + visible flag
 }
 
+// Decompresses room backgrounds on separate threads, while the rest of the
+// room data is being read. Room file contains up to 5 LZW-compressed
+// backgrounds, which make the largest part of the room loading time.
+class RoomBgDecoder
+{
+public:
+    ~RoomBgDecoder()
+    {
+        Wait();
+    }
+
+    // Begins decompressing the background frame
+    void Unpack(size_t frame, std::vector<uint8_t> &&lzw_data, size_t unpacked_sz, int dst_bpp)
+    {
+        std::unique_ptr<Job> job(new Job());
+        job->Frame = frame;
+        job->Data = std::move(lzw_data);
+        job->UnpackedSize = unpacked_sz;
+        job->BPP = dst_bpp;
+#if defined(AGS_DISABLE_THREADS)
+        job->Run();
+#else
+        Job *job_ptr = job.get();
+        _threads.emplace_back([job_ptr]() { job_ptr->Run(); });
+#endif
+        _jobs.push_back(std::move(job));
+    }
+
+    // Waits for all the pending backgrounds, and assigns them to the room
+    void Complete(RoomStruct *room)
+    {
+        Wait();
+        for (auto &job : _jobs)
+            room->BgFrames[job->Frame].Graphic = std::move(job->Result);
+        _jobs.clear();
+    }
+
+private:
+    struct Job
+    {
+        size_t Frame = 0u;
+        std::vector<uint8_t> Data;
+        size_t UnpackedSize = 0u;
+        int BPP = 0;
+        std::unique_ptr<Bitmap> Result;
+
+        void Run()
+        {
+            Result = unpack_lzw(Data, UnpackedSize, BPP);
+            Data = std::vector<uint8_t>(); // release memory
+        }
+    };
+
+    void Wait()
+    {
+        for (auto &thread : _threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+        _threads.clear();
+    }
+
+    std::vector<std::unique_ptr<Job>> _jobs;
+    std::vector<std::thread> _threads;
+};
+
+// Reads the compressed background frame, and schedules its decompression
+static void ReadRoomBackground(RoomStruct *room, size_t frame, RGB (*pal)[256], Stream *in, RoomBgDecoder &bg_decoder)
+{
+    std::vector<uint8_t> lzw_data;
+    size_t unpacked_sz;
+    read_lzw(in, lzw_data, unpacked_sz, pal);
+    bg_decoder.Unpack(frame, std::move(lzw_data), unpacked_sz, room->BackgroundBPP);
+}
+
 // Main room data
-HError ReadMainBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ver)
+HError ReadMainBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ver, RoomBgDecoder &bg_decoder)
 {
     room->BackgroundBPP = in->ReadInt32();
     if (room->BackgroundBPP < 1)
@@ -215,8 +292,8 @@ HError ReadMainBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ver)
     for (size_t i = 0; i < room->RegionCount; ++i)
         room->Regions[i].Tint = in->ReadInt32();
 
-    // Primary background
-    room->BgFrames[0].Graphic = load_lzw(in, room->BackgroundBPP, &room->Palette);
+    // Primary background; the masks are read while it's decompressed
+    ReadRoomBackground(room, 0, &room->Palette, in, bg_decoder);
     // Area masks
     room->RegionMask = load_rle_bitmap8(in);
     room->WalkAreaMask = load_rle_bitmap8(in);
@@ -241,9 +318,11 @@ HError ReadScriptBlock(char *&buf, Stream *in, RoomFileVersion /*data_ver*/)
 // Compiled room script
 HError ReadCompSc3Block(RoomStruct *room, Stream *in, RoomFileVersion /*data_ver*/)
 {
-    room->CompiledScript.reset(ccScript::CreateFromStream(in));
+    // NOTE: rooms may be loaded on a worker thread, so don't use the global script error
+    String error;
+    room->CompiledScript.reset(ccScript::CreateFromStream(in, error));
     if (room->CompiledScript == nullptr)
-        return new RoomFileError(kRoomFileErr_ScriptLoadFailed, cc_get_error().ErrorString);
+        return new RoomFileError(kRoomFileErr_ScriptLoadFailed, error);
     return HError::None();
 }
 
@@ -278,7 +357,7 @@ HError ReadObjScNamesBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ve
 }
 
 // Secondary backgrounds
-HError ReadAnimBgBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ver)
+HError ReadAnimBgBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ver, RoomBgDecoder &bg_decoder)
 {
     room->BgFrameCount = in->ReadInt8();
     if (room->BgFrameCount > MAX_ROOM_BGFRAMES)
@@ -290,8 +369,7 @@ HError ReadAnimBgBlock(RoomStruct *room, Stream *in, RoomFileVersion data_ver)
 
     for (size_t i = 1; i < room->BgFrameCount; ++i)
     {
-        room->BgFrames[i].Graphic =
-            load_lzw(in, room->BackgroundBPP, &room->BgFrames[i].Palette);
+        ReadRoomBackground(room, i, &room->BgFrames[i].Palette, in, bg_decoder);
     }
     return HError::None();
 }
@@ -356,7 +434,7 @@ HError ReadExt_400_WalkOpts(RoomStruct *room, Stream *in, RoomFileVersion data_v
 }
 
 HError ReadRoomBlock(RoomStruct *room, Stream *in, RoomFileBlock block, const String &ext_id,
-    soff_t block_len, RoomFileVersion data_ver)
+    soff_t block_len, RoomFileVersion data_ver, RoomBgDecoder &bg_decoder)
 {
     //
     // First check classic block types, identified with a numeric id
@@ -364,7 +442,7 @@ HError ReadRoomBlock(RoomStruct *room, Stream *in, RoomFileBlock block, const St
     switch (block)
     {
     case kRoomFblk_Main:
-        return ReadMainBlock(room, in, data_ver);
+        return ReadMainBlock(room, in, data_ver, bg_decoder);
     case kRoomFblk_Script:
         in->Seek(block_len); // no longer read source script text into RoomStruct
         return HError::None();
@@ -375,7 +453,7 @@ HError ReadRoomBlock(RoomStruct *room, Stream *in, RoomFileBlock block, const St
     case kRoomFblk_ObjectScNames:
         return ReadObjScNamesBlock(room, in, data_ver);
     case kRoomFblk_AnimBg:
-        return ReadAnimBgBlock(room, in, data_ver);
+        return ReadAnimBgBlock(room, in, data_ver, bg_decoder);
     case kRoomFblk_Properties:
         return ReadPropertiesBlock(room, in, data_ver);
     case kRoomFblk_CompScript:
@@ -433,6 +511,12 @@ public:
         return err;
     }
 
+    // Waits until all the room backgrounds are decompressed
+    void CompleteBackgrounds()
+    {
+        _bgDecoder.Complete(_room);
+    }
+
 private:
     String GetOldBlockName(int block_id) const override
     { return GetRoomBlockName((RoomFileBlock)block_id); }
@@ -440,11 +524,12 @@ private:
         soff_t block_len, bool &read_next) override
     {
         read_next = true;
-        return ReadRoomBlock(_room, in, (RoomFileBlock)block_id, ext_id, block_len, _dataVer);
+        return ReadRoomBlock(_room, in, (RoomFileBlock)block_id, ext_id, block_len, _dataVer, _bgDecoder);
     }
 
     RoomStruct *_room {};
     RoomFileVersion _dataVer {};
+    RoomBgDecoder _bgDecoder;
 };
 
 
@@ -453,6 +538,7 @@ HRoomFileError ReadRoomData(RoomStruct *room, std::unique_ptr<Stream> &&in, Room
     room->DataVersion = data_ver;
     RoomBlockReader reader(room, data_ver, std::move(in));
     HError err = reader.Read();
+    reader.CompleteBackgrounds();
     return err ? HRoomFileError::None() : new RoomFileError(kRoomFileErr_BlockListFailed, err);
 }
 
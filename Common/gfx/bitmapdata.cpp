@@ -14,6 +14,14 @@
 #include "gfx/bitmapdata.h"
 #include "util/memory.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define AGS_PIXELOP_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AGS_PIXELOP_NEON
+#include <arm_neon.h>
+#endif
+
 namespace AGS
 {
 namespace Common
@@ -99,6 +107,334 @@ bool CopyConvert(uint8_t *dst_buffer, const PixelFormat dst_fmt, const size_t ds
     return false;
 }
 
+size_t FindNonZero(const uint8_t *buffer, const size_t count)
+{
+    size_t i = 0;
+#if defined(AGS_PIXELOP_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0xFFFF)
+            break;
+    }
+#elif defined(AGS_PIXELOP_NEON)
+    for (; i + 16 <= count; i += 16)
+    {
+        if (vmaxvq_u8(vld1q_u8(buffer + i)) != 0)
+            break;
+    }
+#endif
+    // Find exact position within the last tested block, or in the remainder
+    for (; (i < count) && (buffer[i] == 0); ++i);
+    return i;
+}
+
+#if defined(AGS_PIXELOP_SSE2)
+// Selects 16 bytes from the source where the byte mask is set, and from the dest elsewhere
+static inline void BlendBytes16(uint8_t *dst, const uint8_t *src, const __m128i m)
+{
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+        _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, d)));
+}
+#elif defined(AGS_PIXELOP_NEON)
+// Selects 16 bytes from the source where the byte mask is set, and from the dest elsewhere
+static inline void BlendBytes16(uint8_t *dst, const uint8_t *src, const uint8x16_t m)
+{
+    vst1q_u8(dst, vbslq_u8(m, vld1q_u8(src), vld1q_u8(dst)));
+}
+#endif
+
+template <typename T>
+static inline void CopyPixelsMaskedImpl(T *dst, const T *src, const uint8_t *mask,
+    const uint8_t mask_value, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (mask[i] == mask_value)
+            dst[i] = src[i];
+    }
+}
+
+void CopyPixelsMasked(uint8_t *dst_buffer, const uint8_t *src_buffer, const uint8_t *mask,
+    const uint8_t mask_value, const int bpp, const size_t count)
+{
+    assert(bpp == 1 || bpp == 2 || bpp == 4);
+    size_t i = 0;
+    // Process 16 pixels at a time: compare the mask bytes with the value,
+    // widen the comparison result to the pixel size, and blend the pixels
+#if defined(AGS_PIXELOP_SSE2)
+    const __m128i mval = _mm_set1_epi8(static_cast<char>(mask_value));
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i m = _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i)), mval);
+        const int bits = _mm_movemask_epi8(m);
+        if (bits == 0)
+            continue; // no matching pixels
+        uint8_t *dst = dst_buffer + i * bpp;
+        const uint8_t *src = src_buffer + i * bpp;
+        if (bits == 0xFFFF)
+        {
+            memcpy(dst, src, 16 * bpp); // all pixels match
+            continue;
+        }
+        switch (bpp)
+        {
+        case 1:
+            BlendBytes16(dst, src, m);
+            break;
+        case 2:
+            BlendBytes16(dst, src, _mm_unpacklo_epi8(m, m));
+            BlendBytes16(dst + 16, src + 16, _mm_unpackhi_epi8(m, m));
+            break;
+        case 4:
+        {
+            const __m128i lo = _mm_unpacklo_epi8(m, m);
+            const __m128i hi = _mm_unpackhi_epi8(m, m);
+            BlendBytes16(dst, src, _mm_unpacklo_epi8(lo, lo));
+            BlendBytes16(dst + 16, src + 16, _mm_unpackhi_epi8(lo, lo));
+            BlendBytes16(dst + 32, src + 32, _mm_unpacklo_epi8(hi, hi));
+            BlendBytes16(dst + 48, src + 48, _mm_unpackhi_epi8(hi, hi));
+            break;
+        }
+        default: break;
+        }
+    }
+#elif defined(AGS_PIXELOP_NEON)
+    const uint8x16_t mval = vdupq_n_u8(mask_value);
+    for (; i + 16 <= count; i += 16)
+    {
+        const uint8x16_t m = vceqq_u8(vld1q_u8(mask + i), mval);
+        if (vmaxvq_u8(m) == 0)
+            continue; // no matching pixels
+        uint8_t *dst = dst_buffer + i * bpp;
+        const uint8_t *src = src_buffer + i * bpp;
+        if (vminvq_u8(m) == 0xFF)
+        {
+            memcpy(dst, src, 16 * bpp); // all pixels match
+            continue;
+        }
+        switch (bpp)
+        {
+        case 1:
+            BlendBytes16(dst, src, m);
+            break;
+        case 2:
+        {
+            const uint8x16x2_t m2 = vzipq_u8(m, m);
+            BlendBytes16(dst, src, m2.val[0]);
+            BlendBytes16(dst + 16, src + 16, m2.val[1]);
+            break;
+        }
+        case 4:
+        {
+            const uint8x16x2_t m2 = vzipq_u8(m, m);
+            const uint8x16x2_t lo = vzipq_u8(m2.val[0], m2.val[0]);
+            const uint8x16x2_t hi = vzipq_u8(m2.val[1], m2.val[1]);
+            BlendBytes16(dst, src, lo.val[0]);
+            BlendBytes16(dst + 16, src + 16, lo.val[1]);
+            BlendBytes16(dst + 32, src + 32, hi.val[0]);
+            BlendBytes16(dst + 48, src + 48, hi.val[1]);
+            break;
+        }
+        default: break;
+        }
+    }
+#endif
+    // Remaining pixels
+    switch (bpp)
+    {
+    case 1:
+        CopyPixelsMaskedImpl(dst_buffer + i, src_buffer + i, mask + i, mask_value, count - i);
+        break;
+    case 2:
+        CopyPixelsMaskedImpl(reinterpret_cast<uint16_t*>(dst_buffer) + i,
+            reinterpret_cast<const uint16_t*>(src_buffer) + i, mask + i, mask_value, count - i);
+        break;
+    case 4:
+        CopyPixelsMaskedImpl(reinterpret_cast<uint32_t*>(dst_buffer) + i,
+            reinterpret_cast<const uint32_t*>(src_buffer) + i, mask + i, mask_value, count - i);
+        break;
+    default: break;
+    }
+}
+
+template <typename T>
+static inline bool FillPixelsMaskedImpl(T *dst, const uint8_t *mask, const uint8_t *mask_lut,
+    const T color, const size_t count)
+{
+    bool filled = false;
+    // Skip the runs of zero mask in bulk, and test the rest one by one
+    for (size_t i = FindNonZero(mask, count); i < count; i += FindNonZero(mask + i, count - i))
+    {
+        for (; (i < count) && (mask[i] != 0); ++i)
+        {
+            if (mask_lut[mask[i]])
+            {
+                dst[i] = color;
+                filled = true;
+            }
+        }
+    }
+    return filled;
+}
+
+bool FillPixelsMasked(uint8_t *dst_buffer, const uint8_t *mask, const uint8_t *mask_lut,
+    const uint32_t color, const int bpp, const size_t count)
+{
+    assert(bpp == 1 || bpp == 2 || bpp == 4);
+    switch (bpp)
+    {
+    case 1:
+        return FillPixelsMaskedImpl(dst_buffer, mask, mask_lut, static_cast<uint8_t>(color), count);
+    case 2:
+        return FillPixelsMaskedImpl(reinterpret_cast<uint16_t*>(dst_buffer), mask, mask_lut,
+            static_cast<uint16_t>(color), count);
+    case 4:
+        return FillPixelsMaskedImpl(reinterpret_cast<uint32_t*>(dst_buffer), mask, mask_lut,
+            color, count);
+    default:
+        return false;
+    }
+}
+
+// YUV to RGB conversion coefficients, in 13-bit fixed point:
+//     R = 1.164 * (Y - 16)                   + 1.596 * (V - 128)
+//     G = 1.164 * (Y - 16) - 0.391 * (U - 128) - 0.813 * (V - 128)
+//     B = 1.164 * (Y - 16) + 2.018 * (U - 128)
+// these are small enough to let SIMD multiply 16-bit values.
+static const int YUV_Shift = 13;
+static const int YUV_Round = 1 << (YUV_Shift - 1);
+static const int YUV_Y  = 9539;
+static const int YUV_VR = 13074;
+static const int YUV_UG = 3203;
+static const int YUV_VG = 6660;
+static const int YUV_UB = 16531;
+
+static inline uint8_t ClampYUVResult(int value)
+{
+    value >>= YUV_Shift;
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static inline uint32_t YUVToARGB(int y, int u, int v)
+{
+    const int yt = YUV_Y * (y - 16) + YUV_Round;
+    u -= 128;
+    v -= 128;
+    return 0xFF000000u
+        | (ClampYUVResult(yt + YUV_VR * v) << 16)
+        | (ClampYUVResult(yt - YUV_UG * u - YUV_VG * v) << 8)
+        |  ClampYUVResult(yt + YUV_UB * u);
+}
+
+#if defined(AGS_PIXELOP_SSE2)
+// Converts 8 pixels, given as 16-bit Y, U and V values,
+// with 16 and 128 already subtracted, respectively
+static inline void YUVToARGB8(uint32_t *dst, const __m128i y, const __m128i u, const __m128i v)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(YUV_Round);
+    const __m128i coef_r = _mm_setr_epi16(YUV_Y, YUV_VR, YUV_Y, YUV_VR, YUV_Y, YUV_VR, YUV_Y, YUV_VR);
+    const __m128i coef_g = _mm_setr_epi16(YUV_Y, -YUV_UG, YUV_Y, -YUV_UG, YUV_Y, -YUV_UG, YUV_Y, -YUV_UG);
+    const __m128i coef_vg = _mm_setr_epi16(-YUV_VG, 0, -YUV_VG, 0, -YUV_VG, 0, -YUV_VG, 0);
+    const __m128i coef_b = _mm_setr_epi16(YUV_Y, YUV_UB, YUV_Y, YUV_UB, YUV_Y, YUV_UB, YUV_Y, YUV_UB);
+    // Interleave the components, so that each pair is multiplied and summed up
+    const __m128i yv_lo = _mm_unpacklo_epi16(y, v), yv_hi = _mm_unpackhi_epi16(y, v);
+    const __m128i yu_lo = _mm_unpacklo_epi16(y, u), yu_hi = _mm_unpackhi_epi16(y, u);
+    const __m128i v_lo = _mm_unpacklo_epi16(v, zero), v_hi = _mm_unpackhi_epi16(v, zero);
+    const __m128i r = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv_lo, coef_r), round), YUV_Shift),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv_hi, coef_r), round), YUV_Shift));
+    const __m128i g = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, coef_g),
+            _mm_madd_epi16(v_lo, coef_vg)), round), YUV_Shift),
+        _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, coef_g),
+            _mm_madd_epi16(v_hi, coef_vg)), round), YUV_Shift));
+    const __m128i b = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, coef_b), round), YUV_Shift),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, coef_b), round), YUV_Shift));
+    // Saturate to 8-bit, and interleave into B, G, R, A byte order
+    const __m128i rg = _mm_packus_epi16(r, g); // R in low half, G in high half
+    const __m128i ba = _mm_packus_epi16(b, _mm_set1_epi16(0xFF)); // B in low half, A in high half
+    const __m128i bg = _mm_unpacklo_epi8(ba, _mm_srli_si128(rg, 8));
+    const __m128i ra = _mm_unpacklo_epi8(rg, _mm_srli_si128(ba, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(bg, ra));
+}
+#elif defined(AGS_PIXELOP_NEON)
+static inline uint8x8_t YUVResult8(const int32x4_t lo, const int32x4_t hi)
+{
+    return vqmovun_s16(vcombine_s16(
+        vqmovn_s32(vrshrq_n_s32(lo, YUV_Shift)), vqmovn_s32(vrshrq_n_s32(hi, YUV_Shift))));
+}
+
+// Converts 8 pixels, given as 16-bit Y, U and V values,
+// with 16 and 128 already subtracted, respectively
+static inline void YUVToARGB8(uint32_t *dst, const int16x8_t y, const int16x8_t u, const int16x8_t v)
+{
+    const int16x4_t y_lo = vget_low_s16(y), y_hi = vget_high_s16(y);
+    const int16x4_t u_lo = vget_low_s16(u), u_hi = vget_high_s16(u);
+    const int16x4_t v_lo = vget_low_s16(v), v_hi = vget_high_s16(v);
+    const int32x4_t yt_lo = vmull_n_s16(y_lo, YUV_Y), yt_hi = vmull_n_s16(y_hi, YUV_Y);
+    uint8x8x4_t px;
+    px.val[0] = YUVResult8(vmlal_n_s16(yt_lo, u_lo, YUV_UB), vmlal_n_s16(yt_hi, u_hi, YUV_UB));
+    px.val[1] = YUVResult8(
+        vmlsl_n_s16(vmlsl_n_s16(yt_lo, u_lo, YUV_UG), v_lo, YUV_VG),
+        vmlsl_n_s16(vmlsl_n_s16(yt_hi, u_hi, YUV_UG), v_hi, YUV_VG));
+    px.val[2] = YUVResult8(vmlal_n_s16(yt_lo, v_lo, YUV_VR), vmlal_n_s16(yt_hi, v_hi, YUV_VR));
+    px.val[3] = vdup_n_u8(0xFF);
+    vst4_u8(reinterpret_cast<uint8_t*>(dst), px); // B, G, R, A byte order
+}
+#endif
+
+void ConvertYUVRowToARGB(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, const size_t width)
+{
+    size_t x = 0;
+    // Process 16 pixels at a time, which use 8 chroma samples
+#if defined(AGS_PIXELOP_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i off_y = _mm_set1_epi16(16);
+    const __m128i off_uv = _mm_set1_epi16(128);
+    for (; x + 16 <= width; x += 16)
+    {
+        const __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        const __m128i u16 = _mm_sub_epi16(_mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2)), zero), off_uv);
+        const __m128i v16 = _mm_sub_epi16(_mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2)), zero), off_uv);
+        // Duplicate each chroma sample for the two neighbouring pixels
+        YUVToARGB8(dst + x, _mm_sub_epi16(_mm_unpacklo_epi8(y8, zero), off_y),
+            _mm_unpacklo_epi16(u16, u16), _mm_unpacklo_epi16(v16, v16));
+        YUVToARGB8(dst + x + 8, _mm_sub_epi16(_mm_unpackhi_epi8(y8, zero), off_y),
+            _mm_unpackhi_epi16(u16, u16), _mm_unpackhi_epi16(v16, v16));
+    }
+#elif defined(AGS_PIXELOP_NEON)
+    const int16x8_t off_y = vdupq_n_s16(16);
+    const int16x8_t off_uv = vdupq_n_s16(128);
+    for (; x + 16 <= width; x += 16)
+    {
+        const uint8x16_t y8 = vld1q_u8(y + x);
+        const int16x8_t u16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + x / 2))), off_uv);
+        const int16x8_t v16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + x / 2))), off_uv);
+        // Duplicate each chroma sample for the two neighbouring pixels
+        const int16x8x2_t uu = vzipq_s16(u16, u16);
+        const int16x8x2_t vv = vzipq_s16(v16, v16);
+        YUVToARGB8(dst + x, vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y8))), off_y),
+            uu.val[0], vv.val[0]);
+        YUVToARGB8(dst + x + 8, vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y8))), off_y),
+            uu.val[1], vv.val[1]);
+    }
+#endif
+    // Remaining pixels
+    for (; x < width; ++x)
+        dst[x] = YUVToARGB(y[x], u[x / 2], v[x / 2]);
+}
+
 } // namespace PixelOperations
 
 } // namespace Common
@@ -209,6 +209,26 @@ namespace PixelOp
     //          add more common conversions later!
     bool CopyConvert(uint8_t *dst_buffer, const PixelFormat dst_fmt, const size_t dst_pitch,
         const int height, const uint8_t *src_buffer, const PixelFormat src_fmt, const size_t src_pitch);
+
+    // Finds the first non-zero byte in the buffer, checking multiple bytes
+    // at once where possible; returns its index, or count if there's none.
+    size_t FindNonZero(const uint8_t *buffer, const size_t count);
+    // Copies a span of pixels from source to dest buffer, but only those for which
+    // the respective byte in the 8-bit mask equals to mask_value; other dest pixels
+    // are left unchanged. Supports 1, 2 and 4 bytes per pixel.
+    void CopyPixelsMasked(uint8_t *dst_buffer, const uint8_t *src_buffer, const uint8_t *mask,
+        const uint8_t mask_value, const int bpp, const size_t count);
+    // Fills a span of pixels in dest buffer with the given color, but only those
+    // for which the respective byte in the 8-bit mask has a non-zero entry in the
+    // mask_lut (256 entries); zero mask bytes are always skipped.
+    // Supports 1, 2 and 4 bytes per pixel. Returns whether any pixel was filled.
+    bool FillPixelsMasked(uint8_t *dst_buffer, const uint8_t *mask, const uint8_t *mask_lut,
+        const uint32_t color, const int bpp, const size_t count);
+    // Converts a row of pixels from planar YUV with horizontally subsampled
+    // chroma (4:2:0 or 4:2:2) into 32-bit ARGB, using BT.601 coefficients;
+    // u and v rows must contain (width + 1) / 2 samples.
+    void ConvertYUVRowToARGB(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+        const uint8_t *v, const size_t width);
 }
 
 } // namespace Common
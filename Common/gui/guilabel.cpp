@@ -60,10 +60,10 @@ Rect GUILabel::CalcGraphicRect(bool clipped)
     int at_y = 0;
     Line max_line;
     for (size_t i = 0;
-        i < Lines.Count() && (!limit_by_label_frame || at_y <= _height);
+        i < _lines.Count() && (!limit_by_label_frame || at_y <= _height);
         ++i, at_y += linespacing)
     {
-        Line lpos = GUI::CalcTextPositionHor(Lines[i].GetCStr(), Font, 0, 0 + _width - 1, at_y,
+        Line lpos = GUI::CalcTextPositionHor(_lines[i].GetCStr(), Font, 0, 0 + _width - 1, at_y,
             (FrameAlignment)TextAlignment);
         max_line.X2 = std::max(max_line.X2, lpos.X2);
     }
@@ -77,8 +77,6 @@ Rect GUILabel::CalcGraphicRect(bool clipped)
 
 void GUILabel::Draw(Bitmap *ds, int x, int y)
 {
-    // TODO: need to find a way to cache text prior to drawing;
-    // but that will require to update all gui controls when translation is changed in game
     if (PrepareTextToDraw() == 0)
         return;
 
@@ -87,10 +85,10 @@ void GUILabel::Draw(Bitmap *ds, int x, int y)
     const bool limit_by_label_frame = true;
     int at_y = y;
     for (size_t i = 0;
-        i < Lines.Count() && (!limit_by_label_frame || at_y <= y + _height);
+        i < _lines.Count() && (!limit_by_label_frame || at_y <= y + _height);
         ++i, at_y += linespacing)
     {
-        GUI::DrawTextAlignedHor(ds, Lines[i].GetCStr(), Font, text_color, x, x + _width - 1, at_y,
+        GUI::DrawTextAlignedHor(ds, _lines[i].GetCStr(), Font, text_color, x, x + _width - 1, at_y,
             (FrameAlignment)TextAlignment);
     }
 }
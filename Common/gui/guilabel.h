@@ -15,6 +15,7 @@
 #define __AC_GUILABEL_H
 
 #include <vector>
+#include "font/fonts.h"
 #include "gui/guiobject.h"
 #include "util/string.h"
 
@@ -59,8 +60,16 @@ private:
     // Information on macros contained within Text field
     GUILabelMacro _textMacro;
     // prepared text buffer/cache
-    // TODO: cache split lines instead?
     String _textToDraw;
+    // Split lines of the drawn text, and the parameters they were made with;
+    // the lines are only split again when any of these change
+    SplitLines _lines;
+    String _linesText;
+    int _linesFont = -1;
+    int _linesWidth = -1;
+    int _linesFormat = 0; // text encoding format
+    bool _linesRtl = false; // right-to-left text direction
+    uint32_t _linesVersion = 0u; // fonts' layout version
 };
 
 } // namespace Common
@@ -70,6 +70,17 @@ ccScript *ccScript::CreateFromStream(Stream *in)
     return scri;
 }
 
+ccScript *ccScript::CreateFromStream(Stream *in, String &error)
+{
+    ccScript *scri = new ccScript();
+    if (!scri->Read(in, error))
+    {
+        delete scri;
+        return nullptr;
+    }
+    return scri;
+}
+
 ccScript::ccScript(const ccScript &src)
 {
     globaldata = src.globaldata;
@@ -148,8 +159,19 @@ void ccScript::Write(Stream *out)
 
 bool ccScript::Read(Stream *in)
 {
-    instances = 0;
     currentline = -1;
+    String error;
+    if (!Read(in, error))
+    {
+        cc_error("!%s", error.GetCStr());
+        return false;
+    }
+    return true;
+}
+
+bool ccScript::Read(Stream *in, String &error)
+{
+    instances = 0;
 
     char gotsig[5]{};
     in->Read(gotsig, 4);
@@ -157,7 +179,7 @@ bool ccScript::Read(Stream *in)
     int fileVer = in->ReadInt32();
     if ((strcmp(gotsig, scfilesig) != 0) || (fileVer > SCOM_VERSION_CURRENT))
     {
-        cc_error("file was not written by ccScript::Write or seek position is incorrect");
+        error = "file was not written by ccScript::Write or seek position is incorrect";
         return false;
     }
 
@@ -229,14 +251,14 @@ bool ccScript::Read(Stream *in)
         HError err = reader.Read();
         reader.ReleaseStream().release(); // FIXME: this double release is ugly
         if (!err) {
-            cc_error("!internal error reading script extensions: %s", err->FullMessage().GetCStr());
+            error = String::FromFormat("internal error reading script extensions: %s", err->FullMessage().GetCStr());
             return false;
         }
     }
 
     if (static_cast<uint32_t>(in->ReadInt32()) != ENDFILESIG)
     {
-        cc_error("!internal error reading script: end file signature not found");
+        error = "internal error reading script: end file signature not found";
         return false;
     }
     return true;
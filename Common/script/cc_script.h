@@ -24,6 +24,7 @@
 #include <vector>
 #include "core/types.h"
 #include "script/cc_reflect.h"
+#include "util/string.h"
 
 namespace AGS { namespace Common { class Stream; } }
 using namespace AGS; // FIXME later
@@ -50,6 +51,9 @@ public:
     int instances = 0; // reference count for this script object
 
     static ccScript *CreateFromStream(Common::Stream *in);
+    // Same as above, but returns the error description instead of setting
+    // the global script error; safe to call from a worker thread
+    static ccScript *CreateFromStream(Common::Stream *in, Common::String &error);
 
     ccScript() = default;
     ccScript(const ccScript &src);
@@ -59,6 +63,7 @@ public:
     void        Write(Common::Stream *out);
     // read back a script written with Write
     bool        Read(Common::Stream *in);
+    bool        Read(Common::Stream *in, Common::String &error);
     const char* GetSectionName(int32_t offset) const;
 };
 
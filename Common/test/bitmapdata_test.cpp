@@ -0,0 +1,189 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/bitmapdata.h"
+
+using namespace AGS::Common;
+
+// Generates a mask with runs of zero and non-zero values, resembling
+// a walk-behind mask, and a few isolated pixels
+static std::vector<uint8_t> MakeMask(std::mt19937 &rng, size_t count, int max_value)
+{
+    std::vector<uint8_t> mask(count);
+    for (size_t i = 0; i < count;)
+    {
+        const size_t run = std::min<size_t>(count - i, 1 + rng() % 40);
+        const uint8_t value = (rng() % 3 == 0) ? 0 : static_cast<uint8_t>(rng() % max_value);
+        for (size_t end = i + run; i < end; ++i)
+            mask[i] = (rng() % 16 == 0) ? static_cast<uint8_t>(rng() % max_value) : value;
+    }
+    return mask;
+}
+
+static std::vector<uint8_t> MakePixels(std::mt19937 &rng, size_t size)
+{
+    std::vector<uint8_t> px(size);
+    for (auto &b : px)
+        b = static_cast<uint8_t>(rng());
+    return px;
+}
+
+// Reference implementation: per-pixel copy, as previously done by walk-behind generation
+static void CopyPixelsMaskedRef(uint8_t *dst_line, const uint8_t *src_line,
+    const uint8_t *check_line, int wb, int bpp, int count)
+{
+    for (int x = 0; x < count; ++x)
+    {
+        if (check_line[x] != wb) continue;
+        switch (bpp)
+        {
+        case 1:
+            dst_line[x] = src_line[x];
+            break;
+        case 2:
+            reinterpret_cast<uint16_t*>(dst_line)[x] =
+                reinterpret_cast<const uint16_t*>(src_line)[x];
+            break;
+        case 4:
+            reinterpret_cast<uint32_t*>(dst_line)[x] =
+                reinterpret_cast<const uint32_t*>(src_line)[x];
+            break;
+        }
+    }
+}
+
+// Reference implementation: per-pixel fill, as previously done by walk-behind cropout
+static bool FillPixelsMaskedRef(uint8_t *dst_line, const uint8_t *check_line,
+    const uint8_t *covers, int maskcol, int bpp, int count)
+{
+    bool pixels_changed = false;
+    for (int x = 0; x < count; ++x)
+    {
+        const int wb = check_line[x];
+        if (wb < 1) continue;
+        if (!covers[wb]) continue;
+        pixels_changed = true;
+        switch (bpp)
+        {
+        case 1:
+            dst_line[x] = maskcol;
+            break;
+        case 2:
+            reinterpret_cast<uint16_t*>(dst_line)[x] = maskcol;
+            break;
+        case 4:
+            reinterpret_cast<uint32_t*>(dst_line)[x] = maskcol;
+            break;
+        }
+    }
+    return pixels_changed;
+}
+
+TEST(BitmapData, FindNonZero) {
+    std::vector<uint8_t> buf(100, 0);
+    ASSERT_EQ(PixelOp::FindNonZero(buf.data(), 0), 0u);
+    ASSERT_EQ(PixelOp::FindNonZero(buf.data(), buf.size()), buf.size());
+    for (size_t i = 0; i < buf.size(); ++i)
+    {
+        buf[i] = 1;
+        for (size_t start = 0; start <= i; ++start)
+            ASSERT_EQ(PixelOp::FindNonZero(buf.data() + start, buf.size() - start), i - start);
+        ASSERT_EQ(PixelOp::FindNonZero(buf.data(), i), i);
+        buf[i] = 0;
+    }
+}
+
+TEST(BitmapData, CopyPixelsMasked) {
+    std::mt19937 rng(1234);
+    const int bpps[] = { 1, 2, 4 };
+    for (int bpp : bpps)
+    {
+        for (int count = 0; count < 150; ++count)
+        {
+            // test unaligned offsets too
+            const int offset = rng() % 8;
+            const auto mask = MakeMask(rng, offset + count, 16);
+            const auto src = MakePixels(rng, (offset + count) * bpp);
+            const auto dst = MakePixels(rng, (offset + count) * bpp);
+            const uint8_t wb = static_cast<uint8_t>(rng() % 16);
+            auto dst_ref = dst;
+            auto dst_test = dst;
+            CopyPixelsMaskedRef(dst_ref.data() + offset * bpp, src.data() + offset * bpp, mask.data() + offset, wb, bpp, count);
+            PixelOp::CopyPixelsMasked(dst_test.data() + offset * bpp, src.data() + offset * bpp, mask.data() + offset, wb, bpp, count);
+            ASSERT_EQ(dst_ref, dst_test);
+        }
+    }
+}
+
+TEST(BitmapData, FillPixelsMasked) {
+    std::mt19937 rng(4321);
+    const int bpps[] = { 1, 2, 4 };
+    for (int bpp : bpps)
+    {
+        for (int count = 0; count < 150; ++count)
+        {
+            const int offset = rng() % 8;
+            const auto mask = MakeMask(rng, offset + count, 16);
+            const auto dst = MakePixels(rng, (offset + count) * bpp);
+            uint8_t covers[256] = {};
+            for (int wb = 1; wb < 16; ++wb)
+                covers[wb] = (rng() % 2) != 0;
+            const uint32_t maskcol = (bpp == 1) ? 0u : (bpp == 2) ? 0xF81Fu : 0x00FF00FFu;
+            auto dst_ref = dst;
+            auto dst_test = dst;
+            bool res_ref = FillPixelsMaskedRef(dst_ref.data() + offset * bpp, mask.data() + offset, covers, maskcol, bpp, count);
+            bool res_test = PixelOp::FillPixelsMasked(dst_test.data() + offset * bpp, mask.data() + offset, covers, maskcol, bpp, count);
+            ASSERT_EQ(res_ref, res_test);
+            ASSERT_EQ(dst_ref, dst_test);
+        }
+    }
+}
+
+// Reference implementation: APEG's table-based YUV to RGB conversion
+static uint32_t YUVToARGBRef(int y, int u, int v)
+{
+    const int yt = static_cast<int>((((y - 16) * 255.0 / 219.0) + 0.5) * 65536.0);
+    const int r = (yt + static_cast<int>((v - 128) * 1.596 * 65536.0)) >> 16;
+    const int g = (yt - static_cast<int>((u - 128) * 0.391 * 65536.0)
+        - static_cast<int>((v - 128) * 0.813 * 65536.0)) >> 16;
+    const int b = (yt + static_cast<int>((u - 128) * 2.018 * 65536.0)) >> 16;
+    return 0xFF000000u | (std::min(std::max(r, 0), 255) << 16) |
+        (std::min(std::max(g, 0), 255) << 8) | std::min(std::max(b, 0), 255);
+}
+
+TEST(BitmapData, ConvertYUVRowToARGB) {
+    std::mt19937 rng(5678);
+    for (size_t width = 1; width < 100; ++width)
+    {
+        const auto y = MakePixels(rng, width);
+        const auto u = MakePixels(rng, (width + 1) / 2);
+        const auto v = MakePixels(rng, (width + 1) / 2);
+        std::vector<uint32_t> dst(width);
+        PixelOp::ConvertYUVRowToARGB(dst.data(), y.data(), u.data(), v.data(), width);
+        for (size_t x = 0; x < width; ++x)
+        {
+            // may differ by 1 from the reference, due to different rounding
+            const uint32_t ref = YUVToARGBRef(y[x], u[x / 2], v[x / 2]);
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                const int c1 = (dst[x] >> shift) & 0xFF, c2 = (ref >> shift) & 0xFF;
+                ASSERT_LE(std::abs(c1 - c2), 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,147 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "util/compress.h"
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
+#include "util/stream.h"
+
+using namespace AGS::Common;
+
+// Number of guard bytes placed after the decompression buffer
+static const size_t GuardSize = 64;
+static const uint8_t GuardValue = 0xCD;
+
+static std::vector<uint8_t> LZ4Pack(const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> packed;
+    Stream out(std::make_unique<VectorStream>(packed, kStream_Write));
+    EXPECT_TRUE(lz4_compress(data.data(), data.size(), 1, &out));
+    out.Close();
+    return packed;
+}
+
+// Unpacks data into the buffer of the given size, followed by the guard
+// bytes; tests that the guard bytes have not been overwritten
+static bool LZ4Unpack(const std::vector<uint8_t> &packed, size_t data_sz, std::vector<uint8_t> &data)
+{
+    data.assign(data_sz + GuardSize, GuardValue);
+    Stream in(std::make_unique<VectorStream>(packed));
+    const bool result = lz4_decompress(data.data(), data_sz, 1, &in, packed.size());
+    for (size_t i = data_sz; i < data.size(); ++i)
+    {
+        EXPECT_EQ(GuardValue, data[i]);
+    }
+    data.resize(data_sz);
+    return result;
+}
+
+static std::vector<uint8_t> MakeRandomData(std::mt19937 &rng, size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (auto &b : data)
+        b = static_cast<uint8_t>(rng());
+    return data;
+}
+
+// Makes data of short repeated patterns and long runs, with occasional noise
+static std::vector<uint8_t> MakeRepetitiveData(std::mt19937 &rng, size_t size)
+{
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    while (data.size() < size)
+    {
+        const size_t pattern_len = 1 + rng() % 24;
+        const size_t repeat_len = 1 + rng() % 1000;
+        std::vector<uint8_t> pattern = MakeRandomData(rng, pattern_len);
+        for (size_t i = 0; i < repeat_len && data.size() < size; ++i)
+            data.push_back(pattern[i % pattern_len]);
+        if (rng() % 4 == 0)
+            data.push_back(static_cast<uint8_t>(rng()));
+    }
+    data.resize(size);
+    return data;
+}
+
+TEST(Compress, LZ4RoundTrip) {
+    std::mt19937 rng(4242);
+    // include sizes around the format's minimal match and end limits
+    const size_t sizes[] = { 0, 1, 4, 5, 12, 13, 16, 17, 64, 1000, 65535, 65536, 70000, 300000 };
+    for (size_t size : sizes)
+    {
+        std::vector<uint8_t> sources[] = {
+            MakeRandomData(rng, size),
+            MakeRepetitiveData(rng, size),
+            std::vector<uint8_t>(size, 0x55)
+        };
+        for (const auto &data : sources)
+        {
+            const auto packed = LZ4Pack(data);
+            std::vector<uint8_t> unpacked;
+            ASSERT_TRUE(LZ4Unpack(packed, data.size(), unpacked));
+            ASSERT_EQ(data, unpacked);
+        }
+    }
+
+    // repetitive data must actually be compressed
+    const auto data = std::vector<uint8_t>(100000, 0x55);
+    ASSERT_LT(LZ4Pack(data).size(), data.size() / 100);
+}
+
+TEST(Compress, LZ4TruncatedInput) {
+    std::mt19937 rng(777);
+    std::vector<uint8_t> sources[] = {
+        MakeRandomData(rng, 3000),
+        MakeRepetitiveData(rng, 3000)
+    };
+    for (const auto &data : sources)
+    {
+        const auto packed = LZ4Pack(data);
+        for (size_t len = 0; len < packed.size(); ++len)
+        {
+            const std::vector<uint8_t> truncated(packed.begin(), packed.begin() + len);
+            std::vector<uint8_t> unpacked;
+            ASSERT_FALSE(LZ4Unpack(truncated, data.size(), unpacked));
+        }
+        // too small output buffer
+        std::vector<uint8_t> unpacked;
+        ASSERT_FALSE(LZ4Unpack(packed, data.size() - 1, unpacked));
+    }
+}
+
+TEST(Compress, LZ4CorruptedInput) {
+    std::mt19937 rng(31337);
+    const auto data = MakeRepetitiveData(rng, 20000);
+    const auto packed = LZ4Pack(data);
+    // corrupted data must not be unpacked past the buffer,
+    // but otherwise the result may be anything
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto corrupted = packed;
+        const int changes = 1 + rng() % 8;
+        for (int c = 0; c < changes; ++c)
+            corrupted[rng() % corrupted.size()] = static_cast<uint8_t>(rng());
+        std::vector<uint8_t> unpacked;
+        LZ4Unpack(corrupted, data.size(), unpacked);
+    }
+    // completely random input
+    for (int i = 0; i < 500; ++i)
+    {
+        const auto noise = MakeRandomData(rng, 1 + rng() % 2000);
+        std::vector<uint8_t> unpacked;
+        LZ4Unpack(noise, 1 + rng() % 5000, unpacked);
+    }
+}
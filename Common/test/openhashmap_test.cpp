@@ -0,0 +1,126 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <unordered_map>
+#include "gtest/gtest.h"
+#include "util/openhashmap.h"
+#include "util/string.h"
+#include "util/string_types.h"
+
+using namespace AGS::Common;
+
+TEST(OpenHashMap, Basic) {
+    OpenHashMap<String, String> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.find("key") == map.end());
+    ASSERT_EQ(map.count("key"), 0u);
+
+    map["key1"] = "value1";
+    map["key2"] = "value2";
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_EQ(map.count("key1"), 1u);
+    ASSERT_STREQ(map.find("key1")->second.GetCStr(), "value1");
+    ASSERT_STREQ(map.find("key2")->second.GetCStr(), "value2");
+    ASSERT_TRUE(map.find("KEY1") == map.end());
+
+    map["key1"] = "value3";
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_STREQ(map.find("key1")->second.GetCStr(), "value3");
+    auto res = map.insert(std::make_pair(String("key2"), String("value4")));
+    ASSERT_FALSE(res.second);
+    ASSERT_STREQ(res.first->second.GetCStr(), "value2");
+
+    ASSERT_EQ(map.erase("key1"), 1u);
+    ASSERT_EQ(map.erase("key1"), 0u);
+    ASSERT_EQ(map.size(), 1u);
+    ASSERT_TRUE(map.find("key1") == map.end());
+    map.erase(map.find("key2"));
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(OpenHashMap, CaseInsensitive) {
+    OpenHashMap<String, String, HashStrNoCase, StrEqNoCase> map;
+    map["Key"] = "value1";
+    map["KEY"] = "value2";
+    ASSERT_EQ(map.size(), 1u);
+    ASSERT_STREQ(map.find("key")->first.GetCStr(), "Key");
+    ASSERT_STREQ(map.find("kEy")->second.GetCStr(), "value2");
+}
+
+TEST(OpenHashMap, Reserve) {
+    OpenHashMap<int, int> map;
+    ASSERT_EQ(map.capacity(), 0u);
+    map.reserve(100);
+    ASSERT_GE(map.capacity(), 100u);
+    const size_t buckets = map.bucket_count();
+    for (int i = 0; i < 100; ++i)
+        map[i] = i;
+    ASSERT_EQ(map.bucket_count(), buckets);
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.bucket_count(), buckets);
+}
+
+TEST(OpenHashMap, CompareToStd) {
+    // Run random operations on both containers, and compare results
+    OpenHashMap<int, int> map;
+    std::unordered_map<int, int> std_map;
+    uint32_t seed = 12345u;
+    for (int i = 0; i < 20000; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        const int key = (seed >> 8) % 1000;
+        switch ((seed >> 20) % 3)
+        {
+        case 0:
+        case 1:
+            map[key] = i;
+            std_map[key] = i;
+            break;
+        case 2:
+            ASSERT_EQ(map.erase(key), std_map.erase(key));
+            break;
+        }
+        ASSERT_EQ(map.size(), std_map.size());
+    }
+
+    size_t iterated = 0u;
+    for (const auto &item : map)
+    {
+        auto it = std_map.find(item.first);
+        ASSERT_TRUE(it != std_map.end());
+        ASSERT_EQ(item.second, it->second);
+        iterated++;
+    }
+    ASSERT_EQ(iterated, std_map.size());
+    for (const auto &item : std_map)
+    {
+        auto it = map.find(item.first);
+        ASSERT_TRUE(it != map.end());
+        ASSERT_EQ(it->second, item.second);
+    }
+}
+
+TEST(OpenHashSet, Basic) {
+    OpenHashSet<String, HashStrNoCase, StrEqNoCase> set;
+    ASSERT_TRUE(set.insert("item1").second);
+    ASSERT_TRUE(set.insert("item2").second);
+    ASSERT_FALSE(set.insert("ITEM1").second);
+    ASSERT_EQ(set.size(), 2u);
+    ASSERT_EQ(set.count("Item2"), 1u);
+    ASSERT_STREQ(set.find("iTem1")->GetCStr(), "item1");
+    ASSERT_EQ(set.erase("item1"), 1u);
+    ASSERT_EQ(set.count("item1"), 0u);
+    ASSERT_EQ(set.size(), 1u);
+}
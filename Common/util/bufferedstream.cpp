@@ -156,6 +156,13 @@ size_t BufferedStream::Read(void *buffer, size_t size)
 
 int32_t BufferedStream::ReadByte()
 {
+    // Fast path: the byte is already in the buffer
+    if (_position >= _bufferPosition &&
+        static_cast<uint64_t>(_position) < static_cast<uint64_t>(_bufferPosition + _buffer.size()))
+    {
+        return _buffer[static_cast<size_t>(_position++ - _bufferPosition)];
+    }
+
     uint8_t ch;
     auto bytesRead = Read(&ch, 1);
     if (bytesRead != 1) { return EOF; }
@@ -189,6 +196,21 @@ size_t BufferedStream::Write(const void *buffer, size_t size)
 
 int32_t BufferedStream::WriteByte(uint8_t val)
 {
+    // Fast path: the byte may be put into the buffer without flushing it
+    if (_position >= _bufferPosition &&
+        _position <= _bufferPosition + static_cast<soff_t>(_buffer.size()) &&
+        _position < _bufferPosition + static_cast<soff_t>(BufferSize))
+    {
+        size_t pos_in_buff = static_cast<size_t>(_position - _bufferPosition);
+        if (pos_in_buff == _buffer.size())
+            _buffer.push_back(val);
+        else
+            _buffer[pos_in_buff] = val;
+        _position++;
+        _end = std::max(_end, _position);
+        return val;
+    }
+
     auto sz = Write(&val, 1);
     if (sz != 1) { return -1; }
     return val;
@@ -14,6 +14,8 @@
 #include "util/compress.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include <vector>
 #include <miniz.h>
 #include "ac/common.h"	// quit, update_polled_stuff
@@ -404,21 +406,36 @@ void save_lzw(Stream *out, const Bitmap *bmpp, const RGB (*pal)[256])
 }
 
 std::unique_ptr<Bitmap> load_lzw(Stream *in, int dst_bpp, RGB (*pal)[256])
+{
+  std::vector<uint8_t> inbuf;
+  size_t uncomp_sz;
+  read_lzw(in, inbuf, uncomp_sz, pal);
+  return unpack_lzw(inbuf, uncomp_sz, dst_bpp);
+}
+
+void read_lzw(Stream *in, std::vector<uint8_t> &lzw_data, size_t &unpacked_sz, RGB (*pal)[256])
 {
   // NOTE: old format saves full RGB struct here (4 bytes, including the filler)
   if (pal)
     in->Read(*pal, sizeof(RGB) * 256);
   else
     in->Seek(sizeof(RGB) * 256);
-  const size_t uncomp_sz = in->ReadInt32();
+  unpacked_sz = in->ReadInt32();
   const size_t comp_sz = in->ReadInt32();
   const soff_t end_pos = in->GetPosition() + comp_sz;
 
+  lzw_data.resize(comp_sz);
+  in->Read(lzw_data.data(), comp_sz);
+
+  if (in->GetPosition() != end_pos)
+    in->Seek(end_pos, kSeekBegin);
+}
+
+std::unique_ptr<Bitmap> unpack_lzw(const std::vector<uint8_t> &lzw_data, size_t unpacked_sz, int dst_bpp)
+{
   // First decompress data into the memory buffer
-  std::vector<uint8_t> inbuf(comp_sz);
-  std::vector<uint8_t> membuf(uncomp_sz);
-  in->Read(inbuf.data(), comp_sz);
-  lzwexpand(inbuf.data(), comp_sz, membuf.data(), uncomp_sz);
+  std::vector<uint8_t> membuf(unpacked_sz);
+  lzwexpand(lzw_data.data(), lzw_data.size(), membuf.data(), unpacked_sz);
 
   // Open same buffer for reading and get params and pixels
   Stream mem_in(std::make_unique<VectorStream>(membuf));
@@ -436,10 +453,6 @@ std::unique_ptr<Bitmap> load_lzw(Stream *in, int dst_bpp, RGB (*pal)[256])
   case 4: mem_in.ReadArrayOfInt32(reinterpret_cast<int32_t*>(bmp_data), num_pixels); break;
   default: assert(0); break;
   }
-
-  if (in->GetPosition() != end_pos)
-    in->Seek(end_pos, kSeekBegin);
-
   return bmm;
 }
 
@@ -507,10 +520,10 @@ bool z_inflate(const uint8_t* src, size_t src_sz, uint8_t* dst, size_t dst_sz) {
                 stream.next_out = dst + (dst_sz - stream.avail_out);
                 break;
         }
-    } while (stream.avail_out > 0);
+    } while (ret != Z_STREAM_END && stream.avail_out > 0);
 
     (void)inflateEnd(&stream);
-    return true;
+    return stream.avail_out == 0;
 }
 
 bool deflate_compress(const uint8_t* data, size_t data_sz, int /*image_bpp*/, Stream* out)
@@ -526,6 +539,193 @@ bool inflate_decompress(uint8_t* data, size_t data_sz, int /*image_bpp*/, Stream
     return z_inflate(in_buf.data(), in_sz, data, data_sz);
 }
 
+//-----------------------------------------------------------------------------
+// LZ4
+//-----------------------------------------------------------------------------
+// Implements LZ4 block format: a sequence of (literals, match) pairs, where
+// match is a copy of previously decoded data. The format is designed for
+// the decoding speed: decoder does no more than a memcpy per sequence.
+// References:
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+
+static const size_t LZ4MinMatch = 4;
+static const size_t LZ4LastLiterals = 5; // the last bytes are always literals
+static const size_t LZ4MatchFindLimit = 12; // last match must start before this
+static const size_t LZ4MaxOffset = 65535;
+static const int LZ4HashLog = 16;
+
+static inline uint32_t lz4_read32(const uint8_t *p)
+{
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+static inline void lz4_write_length(std::vector<uint8_t> &out, size_t len)
+{
+    for (; len >= 255; len -= 255)
+        out.push_back(255);
+    out.push_back(static_cast<uint8_t>(len));
+}
+
+static void lz4_write_sequence(std::vector<uint8_t> &out, const uint8_t *literals, size_t lit_len,
+    size_t offset, size_t match_len)
+{
+    const size_t ml_code = match_len > 0 ? match_len - LZ4MinMatch : 0;
+    out.push_back(static_cast<uint8_t>((std::min<size_t>(lit_len, 15) << 4) | std::min<size_t>(ml_code, 15)));
+    if (lit_len >= 15)
+        lz4_write_length(out, lit_len - 15);
+    out.insert(out.end(), literals, literals + lit_len);
+    if (match_len == 0)
+        return; // last sequence
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>((offset >> 8) & 0xFF));
+    if (ml_code >= 15)
+        lz4_write_length(out, ml_code - 15);
+}
+
+static void lz4_pack(const uint8_t *data, size_t data_sz, std::vector<uint8_t> &out)
+{
+    out.reserve(data_sz + data_sz / 255 + 16);
+    size_t anchor = 0; // start of the pending literals
+    if (data_sz > LZ4MatchFindLimit)
+    {
+        // Hash table of the last positions of 4-byte sequences, stored as (pos + 1)
+        std::vector<uint32_t> table(1 << LZ4HashLog, 0u);
+        const size_t match_limit = data_sz - LZ4MatchFindLimit;
+        const size_t match_end = data_sz - LZ4LastLiterals;
+        for (size_t pos = 0; pos < match_limit;)
+        {
+            const uint32_t seq = lz4_read32(data + pos);
+            const uint32_t hash = (seq * 2654435761u) >> (32 - LZ4HashLog);
+            size_t ref = table[hash];
+            table[hash] = static_cast<uint32_t>(pos + 1);
+            if ((ref == 0) || (pos - (ref - 1) > LZ4MaxOffset) || (lz4_read32(data + ref - 1) != seq))
+            {
+                pos++;
+                continue;
+            }
+            ref--;
+            // Extend the match backwards, into the pending literals
+            while ((pos > anchor) && (ref > 0) && (data[pos - 1] == data[ref - 1]))
+            {
+                pos--;
+                ref--;
+            }
+            // Extend the match forwards
+            size_t len = LZ4MinMatch;
+            while ((pos + len < match_end) && (data[pos + len] == data[ref + len]))
+                len++;
+            lz4_write_sequence(out, data + anchor, pos - anchor, pos - ref, len);
+            pos += len;
+            anchor = pos;
+        }
+    }
+    lz4_write_sequence(out, data + anchor, data_sz - anchor, 0, 0);
+}
+
+// Copies data in 16-byte chunks, may write up to 15 bytes past dst_end;
+// source and destination must not overlap within a chunk
+static inline void lz4_wild_copy(uint8_t *dst, const uint8_t *src, const uint8_t *dst_end)
+{
+    do
+    {
+        memcpy(dst, src, 16);
+        dst += 16;
+        src += 16;
+    } while (dst < dst_end);
+}
+
+static inline bool lz4_read_length(const uint8_t *&ip, const uint8_t *iend, size_t &len)
+{
+    uint8_t b;
+    do
+    {
+        if (ip == iend)
+            return false;
+        b = *(ip++);
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+static bool lz4_unpack(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const iend = src + src_sz;
+    uint8_t *op = dst;
+    uint8_t *const oend = dst + dst_sz;
+    while (ip < iend)
+    {
+        const uint8_t token = *(ip++);
+        // Literals
+        size_t lit_len = token >> 4;
+        if ((lit_len == 15) && !lz4_read_length(ip, iend, lit_len))
+            return false;
+        if ((lit_len > static_cast<size_t>(iend - ip)) || (lit_len > static_cast<size_t>(oend - op)))
+            return false;
+        if ((static_cast<size_t>(iend - ip) >= lit_len + 16) && (static_cast<size_t>(oend - op) >= lit_len + 16))
+            lz4_wild_copy(op, ip, op + lit_len);
+        else
+            memcpy(op, ip, lit_len);
+        op += lit_len;
+        ip += lit_len;
+        if (ip == iend)
+            break; // last sequence has no match
+        // Match
+        if (iend - ip < 2)
+            return false;
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if ((offset == 0) || (offset > static_cast<size_t>(op - dst)))
+            return false;
+        size_t match_len = token & 0xF;
+        if ((match_len == 15) && !lz4_read_length(ip, iend, match_len))
+            return false;
+        match_len += LZ4MinMatch;
+        if (match_len > static_cast<size_t>(oend - op))
+            return false;
+        if ((offset >= 16) && (static_cast<size_t>(oend - op) >= match_len + 16))
+        {
+            lz4_wild_copy(op, op - offset, op + match_len);
+        }
+        else if (offset >= match_len)
+        {
+            memcpy(op, op - offset, match_len);
+        }
+        else
+        {
+            // Overlapping copy repeats the pattern of "offset" bytes;
+            // the already copied part lets to double the copy distance each time
+            size_t copied = 0;
+            for (size_t dist = offset; copied < match_len; dist *= 2)
+            {
+                const size_t n = std::min(dist, match_len - copied);
+                memcpy(op + copied, op + copied - dist, n);
+                copied += n;
+            }
+        }
+        op += match_len;
+    }
+    return op == oend;
+}
+
+bool lz4_compress(const uint8_t *data, size_t data_sz, int /*image_bpp*/, Stream *out)
+{
+    std::vector<uint8_t> buf;
+    lz4_pack(data, data_sz, buf);
+    out->Write(buf.data(), buf.size());
+    return true;
+}
+
+bool lz4_decompress(uint8_t *data, size_t data_sz, int /*image_bpp*/, Stream *in, size_t in_sz)
+{
+    std::vector<uint8_t> in_buf(in_sz);
+    if (in->Read(in_buf.data(), in_sz) != in_sz)
+        return false;
+    return lz4_unpack(in_buf.data(), in_sz, data, data_sz);
+}
+
 // References:
 // https://en.wikipedia.org/wiki/Base64
 // https://stackoverflow.com/questions/180947/base64-decode-snippet-in-c
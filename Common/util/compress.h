@@ -41,6 +41,11 @@ bool lzw_decompress(uint8_t *data, size_t data_sz, int image_bpp, Common::Stream
 void save_lzw(Common::Stream *out, const Common::Bitmap *bmpp, const RGB (*pal)[256] = nullptr);
 // Loads bitmap decompressing
 std::unique_ptr<Common::Bitmap> load_lzw(Common::Stream *in, int dst_bpp, RGB (*pal)[256] = nullptr);
+// Reads LZW-compressed bitmap data and an optional palette, without decompressing;
+// this lets to decompress the bitmap later using unpack_lzw, possibly on another thread
+void read_lzw(Common::Stream *in, std::vector<uint8_t> &lzw_data, size_t &unpacked_sz, RGB (*pal)[256] = nullptr);
+// Decompresses bitmap data previously read by read_lzw
+std::unique_ptr<Common::Bitmap> unpack_lzw(const std::vector<uint8_t> &lzw_data, size_t unpacked_sz, int dst_bpp);
 
 // Base64 encoding
 Common::String base64_encode(const void *addr, size_t input_size);
@@ -51,4 +56,8 @@ void base64_decode(const Common::String &input, std::vector<uint8_t> &out);
 bool deflate_compress(const uint8_t* data, size_t data_sz, int image_bpp, Common::Stream* out);
 bool inflate_decompress(uint8_t* data, size_t data_sz, int image_bpp, Common::Stream* in, size_t in_sz);
 
+// LZ4 compression (block format); fast to decompress, at the cost of slightly larger size
+bool lz4_compress(const uint8_t *data, size_t data_sz, int image_bpp, Common::Stream *out);
+bool lz4_decompress(uint8_t *data, size_t data_sz, int image_bpp, Common::Stream *in, size_t in_sz);
+
 #endif // __AC_COMPRESS_H
@@ -197,8 +197,10 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
   if (dst_sz == 0)
     return false; // nowhere to expand to
 
-  lzbuffer = (uint8_t *)malloc(N);
-  if (lzbuffer == nullptr) {
+  // NOTE: expansion uses a local buffer, unlike compression,
+  // so that multiple bitmaps may be expanded on parallel threads
+  uint8_t *lzbuf = (uint8_t *)malloc(N);
+  if (lzbuf == nullptr) {
     return false; // not enough memory
   }
   i = N - F;
@@ -224,13 +226,13 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
           break; // not enough dest buffer
 
         while (len--) {
-          *(dst_ptr++) = (lzbuffer[i] = lzbuffer[j]);
+          *(dst_ptr++) = (lzbuf[i] = lzbuf[j]);
           j = (j + 1) & (N - 1);
           i = (i + 1) & (N - 1);
         }
       } else {
         ch = *(src_ptr++);
-        *(dst_ptr++) = (lzbuffer[i] = static_cast<uint8_t>(ch));
+        *(dst_ptr++) = (lzbuf[i] = static_cast<uint8_t>(ch));
         i = (i + 1) & (N - 1);
       }
 
@@ -241,6 +243,6 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
     } // end for mask
   }
 
-  free(lzbuffer);
+  free(lzbuf);
   return (src_ptr - src) == src_sz;
 }
@@ -140,7 +140,7 @@ int32_t MemoryStream::WriteByte(uint8_t val)
 
 
 VectorStream::VectorStream(const std::vector<uint8_t> &cbuf)
-    : MemoryStream(&cbuf.front(), cbuf.size())
+    : MemoryStream(cbuf.data(), cbuf.size())
     , _vec(nullptr)
 {
     _mode = static_cast<StreamMode>(kStream_Read | kStream_Seek);
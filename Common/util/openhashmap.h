@@ -0,0 +1,325 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Open addressing hash containers: OpenHashMap and OpenHashSet.
+//
+// Items are stored in a single contiguous array of slots, along with their
+// cached hash values, so that there's no allocation per item, and the key
+// comparison is only done when the hashes match. Collisions are resolved by
+// linear probing with "Robin Hood" strategy, which keeps the probe sequences
+// short; removal shifts following items back, so there are no tombstones.
+//
+// The interface follows a subset of std::unordered_map / unordered_set.
+// Any item insertion or removal invalidates iterators; erase(iterator)
+// returns a valid iterator, but see its notes on removing while iterating.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__OPENHASHMAP_H
+#define __AGS_CN_UTIL__OPENHASHMAP_H
+
+#include <stdint.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace AGS
+{
+namespace Common
+{
+
+template <typename TKey, typename TItem, typename TKeyOf, typename THash, typename TEqual>
+class OpenHashTable
+{
+    struct Slot
+    {
+        uint32_t Hash = 0u; // cached hash value, 0 means empty slot
+        TItem Item{};
+    };
+
+public:
+    typedef TKey key_type;
+    typedef TItem value_type;
+
+    class const_iterator
+    {
+    public:
+        const_iterator() = default;
+
+        const TItem &operator*() const { return _table->_slots[_index].Item; }
+        const TItem *operator->() const { return &_table->_slots[_index].Item; }
+        const_iterator &operator++()
+        {
+            _index = _table->NextUsed(_index + 1);
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator it = *this;
+            ++(*this);
+            return it;
+        }
+        bool operator==(const const_iterator &other) const { return _index == other._index; }
+        bool operator!=(const const_iterator &other) const { return _index != other._index; }
+
+    private:
+        friend class OpenHashTable;
+        const_iterator(const OpenHashTable *table, size_t index)
+            : _table(table), _index(index) {}
+
+        const OpenHashTable *_table = nullptr;
+        size_t _index = 0u;
+    };
+    typedef const_iterator iterator;
+
+    OpenHashTable() = default;
+
+    const_iterator begin() const { return const_iterator(this, NextUsed(0)); }
+    const_iterator end() const { return const_iterator(this, _slots.size()); }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+    // Returns number of slots
+    size_t bucket_count() const { return _slots.size(); }
+    // Returns number of items that may be stored without reallocation
+    size_t capacity() const { return MaxItems(_slots.size()); }
+
+    const_iterator find(const TKey &key) const { return const_iterator(this, FindIndex(key)); }
+    size_t count(const TKey &key) const { return FindIndex(key) != _slots.size() ? 1 : 0; }
+
+    // Removes all items, but keeps allocated memory
+    void clear()
+    {
+        for (auto &slot : _slots)
+        {
+            if (slot.Hash != 0u)
+                slot = Slot();
+        }
+        _size = 0u;
+    }
+
+    // Ensures that at least item_count items may be stored without reallocation
+    void reserve(size_t item_count)
+    {
+        size_t slot_count = _slots.size() > 0 ? _slots.size() : MinSlots;
+        while (MaxItems(slot_count) < item_count)
+            slot_count *= 2;
+        if (slot_count > _slots.size())
+            Rehash(slot_count);
+    }
+
+    // Erases the item, returns an iterator to the following one.
+    // NOTE: unlike std::unordered_map, erasing while iterating over the
+    // container may visit some items twice: if the items following the
+    // erased one wrap around the end of the slot array, then the items from
+    // its start are shifted to its end, past the current iterator position.
+    // If that's a problem, then collect the keys to remove first.
+    const_iterator erase(const_iterator it)
+    {
+        size_t index = it._index;
+        const size_t mask = _slots.size() - 1;
+        // Shift following items back, until an empty slot,
+        // or an item which is already at its ideal position
+        for (;;)
+        {
+            const size_t next = (index + 1) & mask;
+            Slot &next_slot = _slots[next];
+            if ((next_slot.Hash == 0u) || (ProbeDistance(next_slot.Hash, next) == 0u))
+                break;
+            _slots[index] = std::move(next_slot);
+            index = next;
+        }
+        _slots[index] = Slot();
+        _size--;
+        // The erased item's place is now occupied either by the next item,
+        // or is empty; in the latter case continue to the next used one.
+        return const_iterator(this, NextUsed(it._index));
+    }
+
+    size_t erase(const TKey &key)
+    {
+        const size_t index = FindIndex(key);
+        if (index == _slots.size())
+            return 0u;
+        erase(const_iterator(this, index));
+        return 1u;
+    }
+
+protected:
+    // Inserts a new item, returns its index and whether it was inserted;
+    // if an item with the same key exists, then returns its index instead
+    std::pair<size_t, bool> InsertItem(TItem &&item)
+    {
+        const TKey &key = TKeyOf()(item);
+        const size_t found = FindIndex(key);
+        if (found != _slots.size())
+            return std::make_pair(found, false);
+        if (_size + 1 > MaxItems(_slots.size()))
+            reserve(_size + 1);
+        return std::make_pair(Place(HashOf(key), std::move(item)), true);
+    }
+
+    TItem &ItemAt(size_t index) { return _slots[index].Item; }
+    const_iterator IteratorAt(size_t index) const { return const_iterator(this, index); }
+
+private:
+    // Min number of slots, must be a power of 2
+    static const size_t MinSlots = 8u;
+
+    // Max items stored in the given number of slots (load factor of 0.75)
+    static size_t MaxItems(size_t slot_count) { return slot_count - slot_count / 4; }
+
+    uint32_t HashOf(const TKey &key) const
+    {
+        const uint32_t hash = static_cast<uint32_t>(THash()(key));
+        return hash != 0u ? hash : 1u; // 0 is reserved for the empty slot
+    }
+
+    size_t ProbeDistance(uint32_t hash, size_t index) const
+    {
+        return (index - hash) & (_slots.size() - 1);
+    }
+
+    size_t NextUsed(size_t index) const
+    {
+        for (; index < _slots.size() && _slots[index].Hash == 0u; ++index);
+        return index;
+    }
+
+    size_t FindIndex(const TKey &key) const
+    {
+        if (_size == 0u)
+            return _slots.size();
+        const uint32_t hash = HashOf(key);
+        const size_t mask = _slots.size() - 1;
+        size_t index = hash & mask;
+        for (size_t dist = 0u; ; ++dist, index = (index + 1) & mask)
+        {
+            const Slot &slot = _slots[index];
+            // An item with this key would have been placed before any item
+            // that is closer to its ideal position than we are to ours
+            if ((slot.Hash == 0u) || (ProbeDistance(slot.Hash, index) < dist))
+                return _slots.size();
+            if ((slot.Hash == hash) && TEqual()(TKeyOf()(slot.Item), key))
+                return index;
+        }
+    }
+
+    // Places a new item, which is known to not exist yet; returns its index
+    size_t Place(uint32_t hash, TItem &&item)
+    {
+        Slot cur;
+        cur.Hash = hash;
+        cur.Item = std::move(item);
+        const size_t mask = _slots.size() - 1;
+        size_t index = hash & mask;
+        size_t result = _slots.size();
+        for (size_t dist = 0u; ; ++dist, index = (index + 1) & mask)
+        {
+            Slot &slot = _slots[index];
+            if (slot.Hash == 0u)
+            {
+                slot = std::move(cur);
+                if (result == _slots.size())
+                    result = index;
+                break;
+            }
+            // Take the place of an item which is closer to its ideal position,
+            // and continue placing that item instead
+            const size_t slot_dist = ProbeDistance(slot.Hash, index);
+            if (slot_dist < dist)
+            {
+                std::swap(slot, cur);
+                if (result == _slots.size())
+                    result = index;
+                dist = slot_dist;
+            }
+        }
+        _size++;
+        return result;
+    }
+
+    void Rehash(size_t slot_count)
+    {
+        std::vector<Slot> old_slots(slot_count);
+        std::swap(_slots, old_slots);
+        _size = 0u;
+        for (auto &slot : old_slots)
+        {
+            if (slot.Hash != 0u)
+                Place(slot.Hash, std::move(slot.Item));
+        }
+    }
+
+    std::vector<Slot> _slots;
+    size_t _size = 0u;
+};
+
+
+namespace OpenHash
+{
+    template <typename TKey, typename TValue>
+    struct PairKeyOf
+    {
+        const TKey &operator()(const std::pair<TKey, TValue> &item) const { return item.first; }
+    };
+
+    template <typename TKey>
+    struct KeyOf
+    {
+        const TKey &operator()(const TKey &item) const { return item; }
+    };
+} // namespace OpenHash
+
+
+template <typename TKey, typename TValue,
+    typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+class OpenHashMap : public OpenHashTable<TKey, std::pair<TKey, TValue>,
+    OpenHash::PairKeyOf<TKey, TValue>, THash, TEqual>
+{
+    typedef OpenHashTable<TKey, std::pair<TKey, TValue>,
+        OpenHash::PairKeyOf<TKey, TValue>, THash, TEqual> BaseType;
+public:
+    typedef TValue mapped_type;
+
+    std::pair<typename BaseType::const_iterator, bool> insert(const std::pair<TKey, TValue> &item)
+    {
+        auto result = BaseType::InsertItem(std::pair<TKey, TValue>(item));
+        return std::make_pair(BaseType::IteratorAt(result.first), result.second);
+    }
+
+    TValue &operator[](const TKey &key)
+    {
+        auto result = BaseType::InsertItem(std::make_pair(key, TValue()));
+        return BaseType::ItemAt(result.first).second;
+    }
+};
+
+
+template <typename TKey,
+    typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+class OpenHashSet : public OpenHashTable<TKey, TKey, OpenHash::KeyOf<TKey>, THash, TEqual>
+{
+    typedef OpenHashTable<TKey, TKey, OpenHash::KeyOf<TKey>, THash, TEqual> BaseType;
+public:
+    std::pair<typename BaseType::const_iterator, bool> insert(const TKey &key)
+    {
+        auto result = BaseType::InsertItem(TKey(key));
+        return std::make_pair(BaseType::IteratorAt(result.first), result.second);
+    }
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__OPENHASHMAP_H
@@ -11,11 +11,16 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <utility>
 #include <iostream>
 
 #include "compiler.h"
 #include "script/cs_compiler.h"
+#include "script2/cs_compiler.h"
 #include "script/cc_common.h"
 #include "script/cc_internal.h"
 #include "util/filestream.h"
@@ -65,7 +70,22 @@ std::vector<const char *> GetScriptAPIs()
 
 void CompilerOptions::PrintToStdout() const {
     printf("\n--- Compiler Settings ---\n");
-    printf("Input: %s\n", InputScriptFile.c_str());
+    if (InputScriptFiles.empty())
+    {
+        printf("Input: %s\n", InputScriptFile.c_str());
+    }
+    else
+    {
+        printf("Inputs:");
+        bool comma = false;
+        for (const auto& input : InputScriptFiles)
+        {
+            if (comma) printf(", ");
+            printf("%s", input.c_str());
+            comma = true;
+        }
+        printf("\nJobs: %d\n", Jobs);
+    }
     printf("Output: %s\n", OutputObjFile.c_str());
     printf("Headers:");
     bool comma = false;
@@ -97,10 +117,138 @@ void CompilerOptions::PrintToStdout() const {
     if (Flags.EnforceNewStrings) printf("EnforceNewStrings; ");
     if (Flags.EnforceNewAudio) printf("EnforceNewAudio; ");
     if (Flags.UseOldCustomDialogOptionsAPI) printf("UseOldCustomDialogOptionsAPI; ");
+    if (Flags.Optimize) printf("Optimize; ");
     if(DebugMode) printf("\nDebugMode\n");
 }
 
 
+static void PrintMessages(const AGS::MessageHandler &mh, bool show_warnings)
+{
+    for (const auto &msg : mh.GetMessages())
+    {
+        if (msg.Severity >= AGS::MessageHandler::kSV_UserError)
+            std::cerr << "Error: compile failed at " << msg.Section << ", line " << msg.Lineno << " : " << msg.Message << std::endl;
+        else if (show_warnings && msg.Severity == AGS::MessageHandler::kSV_Warning)
+            std::cout << "Warning: " << msg.Section << ", line " << msg.Lineno << " : " << msg.Message << std::endl;
+    }
+}
+
+// Compiles all the input scripts with the extended compiler, on several threads.
+// The headers are scanned only once, and all the scripts are compiled against that.
+static int CompileParallel(const CompilerOptions& comp_opts, const AGS::Preprocessor::Preprocessor &pp,
+    const std::vector<std::pair<String, String>> &preprocessed_heads)
+{
+    const uint64_t cc_options =
+        SCOPT_EXPORTALL * comp_opts.Flags.ExportAll |
+        SCOPT_LINENUMBERS * comp_opts.Flags.LineNumbers |
+        SCOPT_NOIMPORTOVERRIDE * comp_opts.Flags.NoImportOverride |
+        SCOPT_OLDSTRINGS * (!comp_opts.Flags.EnforceNewStrings) |
+        SCOPT_OPTIMIZE * comp_opts.Flags.Optimize |
+        SCOPT_RTTI |
+        SCOPT_RTTIOPS |
+        SCOPT_SCRIPT_TOC * comp_opts.DebugMode;
+
+    struct ScriptJob
+    {
+        String Name;
+        std::string Text; // preprocessed script
+        std::string OutputFile;
+        std::unique_ptr<ccScript> Compiled;
+        AGS::MessageHandler Messages;
+    };
+
+    //-----------------------------------------------------------------------//
+    // Read and preprocess scripts
+    //-----------------------------------------------------------------------//
+    std::vector<ScriptJob> jobs(comp_opts.InputScriptFiles.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const std::string &src = comp_opts.InputScriptFiles[i];
+        std::unique_ptr<Stream> in (File::OpenFileRead(src.c_str()));
+        if (!in)
+        {
+            std::cerr << "Error: failed to open script for reading: " << src << std::endl;
+            return -1;
+        }
+        TextStreamReader sr(std::move(in));
+        String script_name = Path::RemoveExtension(Path::GetFilename(src.c_str()));
+
+        // Every script starts with the macros that the headers have left
+        AGS::Preprocessor::Preprocessor script_pp = pp;
+        String script_text = script_pp.Preprocess(sr.ReadAll(), script_name);
+        if (cc_has_error())
+        {
+            const auto &error = cc_get_error();
+            std::cerr << "Error: preprocessor failed at " << script_name.GetCStr() <<
+                ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
+            return -1;
+        }
+
+        jobs[i].Name = script_name;
+        jobs[i].Text = script_text.GetCStr();
+        jobs[i].OutputFile = (jobs.size() == 1) ? comp_opts.OutputObjFile :
+            std::string(Path::RemoveExtension(src.c_str()).GetCStr()) + ".o";
+    }
+
+    //-----------------------------------------------------------------------//
+    // Scan headers once
+    //-----------------------------------------------------------------------//
+    std::string all_headers;
+    for (const auto &head : preprocessed_heads)
+    {
+        all_headers += head.first.GetCStr();
+        all_headers += '\n';
+    }
+    AGS::MessageHandler header_mh;
+    std::shared_ptr<const AGS::HeaderSnapshot> headers = ccScanHeaders2(all_headers, header_mh);
+    PrintMessages(header_mh, comp_opts.Flags.ShowWarnings);
+    if (!headers)
+        return -1;
+
+    //-----------------------------------------------------------------------//
+    // Compile scripts
+    //-----------------------------------------------------------------------//
+    std::atomic<size_t> next_job(0u);
+    auto worker = [&]()
+    {
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+        {
+            jobs[i].Compiled.reset(ccCompileText2(*headers, jobs[i].Text, jobs[i].Name.GetCStr(),
+                cc_options, jobs[i].Messages));
+        }
+    };
+    std::vector<std::thread> threads;
+    const size_t thread_count = std::min<size_t>(comp_opts.Jobs, jobs.size());
+    for (size_t t = 1; t < thread_count; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+
+    //-----------------------------------------------------------------------//
+    // Write script objects
+    //-----------------------------------------------------------------------//
+    int result = 0;
+    for (auto &job : jobs)
+    {
+        PrintMessages(job.Messages, comp_opts.Flags.ShowWarnings);
+        if (!job.Compiled)
+        {
+            result = -1;
+            continue;
+        }
+
+        std::unique_ptr<Stream> out (File::CreateFile(job.OutputFile.c_str()));
+        if (!out || !(out->CanWrite())) {
+            std::cerr << "Error: failed to open for writing: " << job.OutputFile << std::endl;
+            return -1;
+        }
+        job.Compiled->Write(out.get());
+    }
+    return result;
+}
+
+
 int Compile(const CompilerOptions& comp_opts)
 {
     comp_opts.PrintToStdout();
@@ -237,6 +385,9 @@ int Compile(const CompilerOptions& comp_opts)
     }
     heads.clear();
 
+    if (comp_opts.Jobs > 0)
+        return CompileParallel(comp_opts, pp, preprocessed_heads);
+
     //-----------------------------------------------------------------------//
     // Preprocess script
     //-----------------------------------------------------------------------//
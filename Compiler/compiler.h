@@ -37,6 +37,7 @@ class CompilerOptions{
         bool EnforceNewStrings = true;        // do not allow old-style strings
         bool EnforceNewAudio = true;
         bool UseOldCustomDialogOptionsAPI = false;
+        bool Optimize = false;                // run the bytecode through the peephole optimizer
     };
 
     struct ScriptAPI {
@@ -49,9 +50,11 @@ public:
     Flags Flags;
     bool PreprocessOnly = false;
     bool DebugMode = false; // build for debug
+    int Jobs = 0; // compile with the extended compiler on this many threads; 0 - use the old compiler
     std::vector<std::pair<std::string, std::string>> Macros{};
     std::vector<std::string> HeaderFiles{};
     std::string InputScriptFile{};
+    std::vector<std::string> InputScriptFiles{}; // all the scripts, when compiling in parallel
     std::string OutputObjFile{};
     std::string Version{};
     CompilerOptions() = default;
@@ -18,13 +18,14 @@
 #include <map>
 #include "util/path.h"
 #include "util/cmdlineopts.h"
+#include "util/string_utils.h"
 #include "compiler.h"
 #include "core/def_version.h"
 
 using namespace AGS::Common;
 using namespace AGS::Common::CmdLineOpts;
 
-const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc>
+const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc> [<INPUT2.asc>...]
 -A <version>                 Script API Version               (default:Highest)
 -C <version>                 Script API Compatibility version (default:Highest)
 -H, --Headers <H1>[:<H2>...] Header Files in order  (; as separator in cmd.exe)
@@ -40,7 +41,10 @@ const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc>
 -fforcenewstrings[=0]        Enforce new strings                    (default:1)
 -fforcenewaudio[=0]          Enforce new audio system               (default:1)
 -foldcustomdialogopt[=0]     Use old custom dialog API
+-foptimize[=0]               Optimize the bytecode (extended compiler, see -j)
 -g                           Generate debug information
+-j <jobs>                    Compile all the inputs with the extended compiler,
+                             in parallel, parsing the headers only once
 --tell-api-versions          Returns supported Script API Versions
 -o <OUT.o>, --output <OUT.o> Place output in specified file.  (default:INPUT.o)
 --override-version <VERSION> Overrides editor version
@@ -172,6 +176,16 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
             continue;
         }
 
+        if(opt_with_value.first == "-j")
+        {
+            compilerOptions.Jobs = StrUtil::StringToInt(opt_with_value.second);
+            if(compilerOptions.Jobs < 1) {
+                std::cerr << "Error: invalid number of jobs " << opt_with_value.second.GetCStr() << std::endl;
+                return ParsedOptions(-1);
+            }
+            continue;
+        }
+
         if(opt_with_value.first == "--override-version")
         {
             compilerOptions.Version = opt_with_value.second.GetCStr();
@@ -219,6 +233,10 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
                 compilerOptions.Flags.EnforceObjectBasedScript = flag_value;
                 continue;
             }
+            if(flag_name == "optimize") {
+                compilerOptions.Flags.Optimize = flag_value;
+                continue;
+            }
             if(flag_name == "lefttoright") {
                 printf("Warning: lefttoright flag is deprecated\n");
                 continue;
@@ -240,6 +258,27 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
 
     compilerOptions.InputScriptFile = parseResult.PosArgs[0].GetCStr();
 
+    if(compilerOptions.Jobs > 0) {
+        for(const auto& pos_arg : parseResult.PosArgs)
+            compilerOptions.InputScriptFiles.push_back(pos_arg.GetCStr());
+        if(compilerOptions.PreprocessOnly) {
+            std::cerr << "Error: -E can't be used together with -j" << std::endl;
+            return ParsedOptions(-1);
+        }
+        if(compilerOptions.InputScriptFiles.size() > 1 && !compilerOptions.OutputObjFile.empty()) {
+            std::cerr << "Error: -o can't be used with several input scripts" << std::endl;
+            return ParsedOptions(-1);
+        }
+    }
+    else if(parseResult.PosArgs.size() > 1) {
+        std::cerr << "Error: several input scripts may only be compiled with -j" << std::endl;
+        return ParsedOptions(-1);
+    }
+    else if(compilerOptions.Flags.Optimize) {
+        std::cerr << "Error: -foptimize may only be used with -j" << std::endl;
+        return ParsedOptions(-1);
+    }
+
     if(compilerOptions.OutputObjFile.empty()) {
         // no output file explicitly set, let's use input.o instead
         std::string filename = Path::RemoveExtension(compilerOptions.InputScriptFile.c_str()).GetCStr();
@@ -264,7 +303,7 @@ Copyright (c) 2021 AGS Team and contributors
 )EOS"
     );
 
-    ParseResult parseResult = Parse(argc,argv,{"-D", "-H", "--Headers", "-A", "-C", "-f"});
+    ParseResult parseResult = Parse(argc,argv,{"-D", "-H", "--Headers", "-A", "-C", "-f", "-j"});
     ParsedOptions parsedOptions = parser_to_compiler_opts(parseResult);
 
     if(parsedOptions.Exit) return parsedOptions.ErrorCode;
@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <stdexcept>
 #include "cc_compiledscript.h"
@@ -142,11 +143,10 @@ int AGS::ccCompiledScript::AddExport(std::string const &name, CodeLoc const loca
     std::string const export_name =
         is_function ? name + "$" + std::to_string(arguments_count) : name;
 
+    // Export offset too high; script data size too large?
+    // Note: the caller must report this, no global error state is used here
     if (location >= 0x00ffffff)
-    {
-        cc_error("export offset too high; script data size too large?");
         return -1;
-    }
 
     if (0u < ExportIdx.count(export_name))
         return ExportIdx[export_name];
@@ -78,7 +78,7 @@ public:
 
     // Add an exported entity to the export repository;
     // it has type vartype, resides at location; if it is a function
-    // Note: This function returns -1 on error
+    // Note: This function returns -1 when location is too high to be exported
     int AddExport(std::string const &name, CodeLoc location, size_t arguments_count = INT_MAX);
 
     // Start a new section of the code.
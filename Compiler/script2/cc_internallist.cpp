@@ -16,7 +16,7 @@
 #include <stdlib.h>
 #include "cc_internallist.h"
 
-static int currentline;  
+AGS::Symbol const AGS::SrcList::kEOF;
 
 AGS::LineHandler::LineHandler()
     : _sections()
@@ -18,6 +18,14 @@
 #include "cc_symboltable.h"
 #include "script/cc_internal.h"
 
+// Definitions of the constants, for the cases when they are bound to references
+size_t const AGS::SymbolTableConstant::kParameterScope;
+size_t const AGS::SymbolTableConstant::kFunctionScope;
+size_t const AGS::SymbolTableConstant::kNoSrcLocation;
+int const AGS::SymbolTableConstant::kNoPrio;
+int const AGS::SymbolTableConstant::kNoOpcode;
+int const AGS::SymbolTableConstant::kSpecialLogic;
+
 AGS::SymbolTableEntry::~SymbolTableEntry()
 {
     // (note that null pointers may be safely 'delete'd, in contrast to 'free'd)
@@ -43,6 +51,10 @@ AGS::SymbolTableEntry::~SymbolTableEntry()
 
 AGS::SymbolTableEntry &AGS::SymbolTableEntry::operator=(const SymbolTableEntry &orig)
 {
+    if (this == &orig)
+        return *this;
+
+    Clear();
     this->Name = orig.Name;
     this->Declared = orig.Declared;
     this->Scope = orig.Scope;
@@ -378,6 +390,33 @@ AGS::SymbolTable::SymbolTable()
     _lastAllocated = VartypeWithConst(kKW_String);
 }
 
+AGS::SymbolTable::SymbolTable(SymbolTable const &orig)
+    : SymbolTable()
+{
+    // Only the operators that are set up in the constructor have got compile time functions.
+    // Keep the ones that have just been made for this table; those of 'orig' refer to 'orig'.
+    std::vector<std::pair<CompileTimeFunc *, CompileTimeFunc *>> ct_funcs(kKW_LastPredefined + 1);
+    for (size_t s = 0u; s < ct_funcs.size(); s++)
+        if (entries[s].OperatorD)
+            ct_funcs[s] = std::make_pair(entries[s].OperatorD->IntCTFunc, entries[s].OperatorD->FloatCTFunc);
+
+    entries = orig.entries;
+    localEntries = orig.localEntries;
+    _stringStructSym = orig._stringStructSym;
+    _stringStructPtrSym = orig._stringStructPtrSym;
+    _lastAllocated = orig._lastAllocated;
+    _findCache = orig._findCache;
+    _vartypesCache = orig._vartypesCache;
+
+    for (size_t s = 0u; s < ct_funcs.size(); s++)
+    {
+        if (!entries[s].OperatorD)
+            continue;
+        entries[s].OperatorD->IntCTFunc = ct_funcs[s].first;
+        entries[s].OperatorD->FloatCTFunc = ct_funcs[s].second;
+    }
+}
+
 bool AGS::SymbolTable::IsVTT(Symbol s, VartypeType vtt) const
 {
     if (IsVariable(s))
@@ -882,6 +921,10 @@ AGS::Symbol AGS::SymbolTable::AddOperator(Predefined kw, std::string const &name
 
 void AGS::SymbolTable::OperatorCtFunctions(Predefined kw, CompileTimeFunc * int_ct_func, CompileTimeFunc * float_ct_func)
 {
+    if (int_ct_func)
+        _ctFuncs.emplace_back(int_ct_func);
+    if (float_ct_func)
+        _ctFuncs.emplace_back(float_ct_func);
     SymbolTableEntry &entry = entries.at(kw);
     entry.OperatorD->IntCTFunc = int_ct_func;
     entry.OperatorD->FloatCTFunc = float_ct_func;
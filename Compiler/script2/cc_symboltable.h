@@ -17,8 +17,10 @@
 #include "cs_parser_common.h"   
 #include "cs_compile_time.h"
 
+#include <climits>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include <bitset>
 #include <string>
 #include <vector>
@@ -107,8 +109,8 @@ public:
 
     // For iterating over type qualifiers; use it->first to get the qualifier
     // for (auto it = tqs.begin(); it != tqs.end(); it++)
-    inline auto begin() const { return TQToSymbolMap().begin(); }
-    inline auto end() const { return TQToSymbolMap().end(); }
+    inline std::map<TypeQualifier, Symbol>::const_iterator begin() const { return TQToSymbolMap().begin(); }
+    inline std::map<TypeQualifier, Symbol>::const_iterator end() const { return TQToSymbolMap().end(); }
 
     inline bool empty() { return _flags == std::bitset<16u>{}; }
 
@@ -343,7 +345,7 @@ struct SymbolTableEntry : public SymbolTableConstant
     SymbolTableEntry(SymbolTableEntry const &orig);
     ~SymbolTableEntry();
     // Deep copy semantics for the pointers
-    SymbolTableEntry &SymbolTableEntry::operator=(const SymbolTableEntry &);
+    SymbolTableEntry &operator=(const SymbolTableEntry &);
     // Note, does not clear the Name field
     void Clear();
 };
@@ -366,6 +368,9 @@ private:
     mutable std::unordered_map<std::string, int> _findCache;
     mutable std::unordered_map<std::pair<Vartype, VartypeType>, Vartype, VVTTHash> _vartypesCache;
 
+    // The compile time functions of the operators; these refer to this table
+    std::vector<std::unique_ptr<CompileTimeFunc>> _ctFuncs;
+
     // add the "No Symbol" symbol to the symbol table at [kw].
     Symbol AddNoSymbol(Predefined kw, std::string const &name);
 
@@ -405,6 +410,10 @@ public:
     std::vector<SymbolTableEntry> localEntries;
 
     SymbolTable();
+    // Deep copy, e.g., of a table that has been set up by scanning the headers.
+    // The copy gets its own compile time functions that refer to the copy.
+    SymbolTable(SymbolTable const &orig);
+    SymbolTable &operator=(SymbolTable const &) = delete;
 
     // Don't reset _findCache: It isn't rebuilt automatically; Find() and FindOrAdd() will no longer work.
     inline void ResetCaches() const { _vartypesCache.clear(); };
@@ -443,7 +452,7 @@ public:
     inline bool IsPredefined(Symbol s) const { return s <= kKW_LastPredefined; }
     
     // The name to the symbol. Will also print vartype designations, e.g. ArrayFoo[5]
-    std::string const SymbolTable::GetName(Symbol symbl) const;
+    std::string const GetName(Symbol symbl) const;
 
     // Whether the symbol can be part of an expression.
     // Note: Whatever is within delimeters will be skipped completely
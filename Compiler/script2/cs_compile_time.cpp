@@ -12,6 +12,8 @@
 //
 //=============================================================================
 #include <cassert>
+#include <climits>
+#include <cmath>
 #include <cstdarg>
 #include <limits>
 
@@ -56,6 +56,7 @@ public:
     CompileTimeFunc(SymbolTable &sym)
         : _sym(sym)
     {}
+    virtual ~CompileTimeFunc() = default;
 
     virtual void Evaluate(Symbol arg1, Symbol arg2, Symbol &result)
         = 0;
@@ -202,6 +202,23 @@ static std::unique_ptr<ScriptTOC> ccCompileDataTOC(const SymbolTable &symt, cons
 }
 
 
+// Generates the additional data of the successfully compiled script
+static void ccFinalizeScript(ccCompiledScript &compiled_script, const SymbolTable &symt, const SectionList &seclist, uint64_t const options)
+{
+    // Construct RTTI
+    if (FlagIsSet(options, SCOPT_RTTI))
+    {
+        compiled_script.rtti = ccCompileRTTI(symt, seclist);
+    }
+
+    if (FlagIsSet(options, SCOPT_SCRIPT_TOC))
+    {
+        compiled_script.sctoc = ccCompileDataTOC(symt, seclist, compiled_script.rtti.get());
+    }
+
+    compiled_script.FreeExtra();
+}
+
 ccScript *ccCompileText2(std::string const &script, std::string const &scriptName, uint64_t const options, MessageHandler &mh)
 {
     ccCompiledScript *compiled_script =
@@ -209,7 +226,7 @@ ccScript *ccCompileText2(std::string const &script, std::string const &scriptNam
     SymbolTable symt; // for gathering rtti
     SectionList seclist;
 
-    compiled_script->StartNewSection(scriptName.empty() ? scriptName : "Unnamed script");
+    compiled_script->StartNewSection(scriptName.empty() ? "Unnamed script" : scriptName);
     cc_compile(script, options, *compiled_script, symt, seclist, mh);
     if (mh.HasError())
     {
@@ -217,19 +234,10 @@ ccScript *ccCompileText2(std::string const &script, std::string const &scriptNam
 
         constexpr size_t buffer_size = 256;
         static char message_buffer[buffer_size];
-        message_buffer[0] = '!';
-        strncpy_s(
-            message_buffer + 1,
-            buffer_size - 1,
-            err.Message.c_str(),
-            err.Message.length() + 1);
+        snprintf(message_buffer, buffer_size, "!%s", err.Message.c_str());
 
         static char section_buffer[buffer_size];
-        strncpy_s(
-            section_buffer,
-            buffer_size,
-            err.Section.c_str(),
-            err.Section.length() + 1);
+        snprintf(section_buffer, buffer_size, "%s", err.Section.c_str());
 
         ccCurScriptName = section_buffer;
         currentline = err.Lineno;
@@ -242,19 +250,34 @@ ccScript *ccCompileText2(std::string const &script, std::string const &scriptNam
         return NULL;
     }
 
-    // Construct RTTI
-    if (FlagIsSet(options, SCOPT_RTTI))
-    {
-        compiled_script->rtti = ccCompileRTTI(symt, seclist);
-    }
-
-    if (FlagIsSet(options, SCOPT_SCRIPT_TOC))
-    {
-        compiled_script->sctoc = ccCompileDataTOC(symt, seclist, compiled_script->rtti.get());
-    }
-
+    ccFinalizeScript(*compiled_script, symt, seclist, options);
     ccCurScriptName = nullptr;
     cc_clear_error();
-    compiled_script->FreeExtra();
     return compiled_script;
 }
+
+std::shared_ptr<const HeaderSnapshot> ccScanHeaders2(std::string const &headers, MessageHandler &mh)
+{
+    std::shared_ptr<HeaderSnapshot> snapshot(new HeaderSnapshot());
+    cc_scan_headers(headers, *snapshot, mh);
+    if (mh.HasError())
+        return nullptr;
+    return snapshot;
+}
+
+ccScript *ccCompileText2(HeaderSnapshot const &headers, std::string const &script, std::string const &scriptName, uint64_t const options, MessageHandler &mh)
+{
+    std::unique_ptr<ccCompiledScript> compiled_script(
+        new ccCompiledScript(FlagIsSet(options, SCOPT_LINENUMBERS)));
+    SymbolTable symt(headers.Sym); // continues with the symbols of the headers
+    SectionList seclist;
+
+    compiled_script->StartNewSection(scriptName.empty() ? "Unnamed script" : scriptName);
+    compiled_script->strings = headers.Strings;
+    cc_compile(headers, script, options, *compiled_script, symt, seclist, mh);
+    if (mh.HasError())
+        return nullptr;
+
+    ccFinalizeScript(*compiled_script, symt, seclist, options);
+    return compiled_script.release();
+}
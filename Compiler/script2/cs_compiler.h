@@ -14,15 +14,25 @@
 #ifndef __CS_COMPILER2_H
 #define __CS_COMPILER2_H
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "script/cc_script.h"
 #include "cs_message_handler.h"
 
+namespace AGS { struct HeaderSnapshot; }
+
 // Get a list of compiler extensions.
 extern void ccGetExtensions2(std::vector<std::string> &exts);
 // compile the script supplied, returns nullptr on failure
 // cc_error() gets called.
 extern ccScript *ccCompileText2(std::string const &script, std::string const &scriptName, uint64_t options, MessageHandler &mh);
+// scan the headers that several scripts are going to be compiled against, returns nullptr on failure
+// cc_error() does not get called, the error is in mh.
+extern std::shared_ptr<const AGS::HeaderSnapshot> ccScanHeaders2(std::string const &headers, AGS::MessageHandler &mh);
+// compile the script supplied as if it followed the text of the headers, returns nullptr on failure
+// cc_error() does not get called, and no global state is used, so that several scripts
+// may be compiled against the same headers at the same time.
+extern ccScript *ccCompileText2(AGS::HeaderSnapshot const &headers, std::string const &script, std::string const &scriptName, uint64_t options, AGS::MessageHandler &mh);
 
 #endif // __CS_COMPILER2_H
@@ -0,0 +1,559 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+
+#include "cs_optimizer.h"
+
+// Number of arguments of each opcode, in the order of the SCMD_ values
+static size_t const kArgsCount[CC_NUM_SCCMDS] =
+{
+    0, 2, 2, 2, 2, 0, 2, 1,     //  0: NULL .. MEMREAD
+    1, 2, 2, 2, 2, 2, 2, 2,     //  8: MEMWRITE .. ISEQUAL
+    2, 2, 2, 2, 2, 2, 2, 1,     // 16: NOTEQUAL .. CALL
+    1, 1, 1, 1, 1, 1, 1, 1,     // 24: MEMREADB .. JMP
+    2, 1, 1, 1, 1, 1, 1, 1,     // 32: MUL .. NUMFUNCARGS
+    2, 2, 1, 2, 2, 1, 2, 1,     // 40: MODREG .. MEMWRITEPTR
+    1, 0, 1, 1, 0, 2, 2, 2,     // 48: MEMREADPTR .. FMULREG
+    2, 2, 2, 2, 2, 2, 2, 1,     // 56: FDIVREG .. ZEROMEMORY
+    1, 2, 2, 1, 0, 0, 1, 1,     // 64: CREATESTRING .. DYNAMICBOUNDS
+    3, 2, 3, 3,                 // 72: NEWARRAY .. NEWARRAY2
+};
+
+// How many jumps in a row are followed when threading a jump
+static size_t const kMaxJumpHops = 16u;
+
+static inline unsigned RegisterBit(AGS::CodeCell reg) { return 1u << reg; }
+
+static inline bool IsRegister(AGS::CodeCell reg) { return reg > 0 && reg < CC_NUM_REGISTERS; }
+
+AGS::Optimizer::Optimizer(ccCompiledScript &scrip)
+    : _scrip(scrip)
+{ }
+
+size_t AGS::Optimizer::ArgsCount(CodeCell const op)
+{
+    return kArgsCount[op];
+}
+
+bool AGS::Optimizer::IsJump(CodeCell const op)
+{
+    return SCMD_JMP == op || SCMD_JZ == op || SCMD_JNZ == op;
+}
+
+bool AGS::Optimizer::GetRegisterUse(Instruction const &instr, unsigned &regs)
+{
+    switch (instr.Op)
+    {
+    default:
+        return false;
+
+    case SCMD_CHECKNULL:
+    case SCMD_LOADSPOFFS: // Note: The SP is read, too; the caller must handle this
+        regs = RegisterBit(SREG_MAR);
+        return true;
+
+    case SCMD_ADD:
+    case SCMD_CHECKBOUNDS:
+    case SCMD_CHECKNULLREG:
+    case SCMD_FADD:
+    case SCMD_FSUB:
+    case SCMD_LITTOREG:
+    case SCMD_MUL:
+    case SCMD_NOTREG:
+    case SCMD_SUB:
+        if (!IsRegister(instr.Args[0]))
+            return false;
+        regs = RegisterBit(instr.Args[0]);
+        return true;
+
+    case SCMD_DYNAMICBOUNDS:
+    case SCMD_MEMREAD:
+    case SCMD_MEMREADB:
+    case SCMD_MEMREADPTR:
+    case SCMD_MEMREADW:
+    case SCMD_MEMWRITE:
+    case SCMD_MEMWRITEB:
+    case SCMD_MEMWRITEW:
+        if (!IsRegister(instr.Args[0]))
+            return false;
+        regs = RegisterBit(instr.Args[0]) | RegisterBit(SREG_MAR);
+        return true;
+
+    case SCMD_ADDREG:
+    case SCMD_AND:
+    case SCMD_BITAND:
+    case SCMD_BITOR:
+    case SCMD_DIVREG:
+    case SCMD_FADDREG:
+    case SCMD_FDIVREG:
+    case SCMD_FGREATER:
+    case SCMD_FGTE:
+    case SCMD_FLESSTHAN:
+    case SCMD_FLTE:
+    case SCMD_FMULREG:
+    case SCMD_FSUBREG:
+    case SCMD_GREATER:
+    case SCMD_GTE:
+    case SCMD_ISEQUAL:
+    case SCMD_LESSTHAN:
+    case SCMD_LTE:
+    case SCMD_MODREG:
+    case SCMD_MULREG:
+    case SCMD_NOTEQUAL:
+    case SCMD_OR:
+    case SCMD_REGTOREG:
+    case SCMD_SHIFTLEFT:
+    case SCMD_SHIFTRIGHT:
+    case SCMD_SUBREG:
+    case SCMD_XORREG:
+        if (!IsRegister(instr.Args[0]) || !IsRegister(instr.Args[1]))
+            return false;
+        regs = RegisterBit(instr.Args[0]) | RegisterBit(instr.Args[1]);
+        return true;
+    }
+}
+
+size_t AGS::Optimizer::Next(size_t idx) const
+{
+    while (idx < _instrs.size() && _instrs[idx].Removed)
+        idx++;
+    return idx;
+}
+
+size_t AGS::Optimizer::InstructionAt(CodeLoc const loc) const
+{
+    // Find the last instruction that starts at or before 'loc'
+    auto const it = std::upper_bound(
+        _instrs.cbegin(), _instrs.cend(), loc,
+        [](CodeLoc const loc, Instruction const &instr) { return loc < instr.Loc; });
+    return static_cast<size_t>(it - _instrs.cbegin()) - 1u;
+}
+
+bool AGS::Optimizer::AreIdentical(size_t const idx1, size_t const idx2) const
+{
+    Instruction const &instr1 = _instrs[idx1];
+    Instruction const &instr2 = _instrs[idx2];
+    if (instr1.Op != instr2.Op)
+        return false;
+    for (size_t arg_idx = 0u; arg_idx < ArgsCount(instr1.Op); arg_idx++)
+        if (instr1.Args[arg_idx] != instr2.Args[arg_idx] ||
+            instr1.Fixups[arg_idx] != instr2.Fixups[arg_idx])
+            return false;
+    return true;
+}
+
+void AGS::Optimizer::Remove(size_t const idx)
+{
+    _instrs[idx].Removed = true;
+    _removedCount++;
+    // Whatever jumped to the removed instruction now lands on the next one
+    if (_isDest[idx])
+        _isDest[Next(idx + 1u)] = true;
+}
+
+AGS::CodeLoc AGS::Optimizer::Relocate(CodeLoc const loc) const
+{
+    if (loc < 0 || _newLocs.empty())
+        return loc;
+
+    auto const it = std::lower_bound(
+        _instrs.cbegin(), _instrs.cend(), loc,
+        [](Instruction const &instr, CodeLoc const loc) { return instr.Loc < loc; });
+    return _newLocs[it - _instrs.cbegin()];
+}
+
+bool AGS::Optimizer::Decode()
+{
+    std::vector<CodeCell> const &code = _scrip.code;
+    CodeLoc const codesize = _scrip.Codesize_i32();
+
+    // Find the fixup type of each code cell
+    std::vector<FixupType> cell_fixups(code.size(), FIXUP_NOFIXUP);
+    for (size_t fixup_idx = 0u; fixup_idx < _scrip.fixups.size(); fixup_idx++)
+    {
+        if (FIXUP_DATADATA == _scrip.fixuptypes[fixup_idx])
+            continue; // This fixup is in the global data, not in the code
+        CodeLoc const loc = _scrip.fixups[fixup_idx];
+        if (loc < 0 || loc >= codesize)
+            return false;
+        cell_fixups[loc] = _scrip.fixuptypes[fixup_idx];
+    }
+
+    _instrs.clear();
+    for (CodeLoc loc = 0; loc < codesize;)
+    {
+        Instruction instr;
+        instr.Loc = loc;
+        instr.Op = code[loc];
+        if (instr.Op <= 0 || instr.Op >= CC_NUM_SCCMDS || FIXUP_NOFIXUP != cell_fixups[loc])
+            return false;
+        CodeLoc const args_count = static_cast<CodeLoc>(ArgsCount(instr.Op));
+        if (loc + args_count >= codesize)
+            return false;
+        for (CodeLoc arg_idx = 0; arg_idx < args_count; arg_idx++)
+        {
+            instr.Args[arg_idx] = code[loc + 1 + arg_idx];
+            instr.Fixups[arg_idx] = cell_fixups[loc + 1 + arg_idx];
+        }
+        _instrs.push_back(instr);
+        loc += 1 + args_count;
+    }
+
+    // Convert the jump offsets into the indexes of the destinations
+    for (auto &instr : _instrs)
+    {
+        if (!IsJump(instr.Op))
+            continue;
+        CodeLoc const dest = instr.Loc + 2 + instr.Args[0];
+        if (dest < 0 || dest > codesize)
+            return false;
+        if (dest == codesize)
+        {
+            instr.Dest = _instrs.size();
+            continue;
+        }
+        instr.Dest = InstructionAt(dest);
+        if (_instrs[instr.Dest].Loc != dest)
+            return false; // Jumps into the middle of an instruction
+    }
+    return true;
+}
+
+void AGS::Optimizer::FindDestinations()
+{
+    // One extra element for a jump to the end of the code
+    _isDest.assign(_instrs.size() + 1u, false);
+
+    CodeLoc const codesize = _scrip.Codesize_i32();
+    auto const mark_loc = [&](CodeLoc const loc)
+    {
+        if (loc >= 0 && loc < codesize)
+            _isDest[Next(InstructionAt(loc))] = true;
+    };
+
+    for (auto const &instr : _instrs)
+    {
+        if (instr.Removed)
+            continue;
+        if (IsJump(instr.Op))
+            _isDest[Next(instr.Dest)] = true;
+        for (size_t arg_idx = 0u; arg_idx < ArgsCount(instr.Op); arg_idx++)
+            if (FIXUP_FUNCTION == instr.Fixups[arg_idx])
+                mark_loc(instr.Args[arg_idx]);
+    }
+    for (auto const &func : _scrip.Functions)
+        mark_loc(func.CodeOffs);
+    for (auto const addr : _scrip.export_addr)
+        if (EXPORT_FUNCTION == (addr >> 24))
+            mark_loc(addr & 0x00ffffff);
+}
+
+bool AGS::Optimizer::ThreadJumps()
+{
+    bool changed = false;
+    for (size_t idx = 0u; idx < _instrs.size(); idx++)
+    {
+        Instruction &jump = _instrs[idx];
+        if (jump.Removed || !IsJump(jump.Op))
+            continue;
+
+        // The engine only counts backward 'jmp' when checking for endless loops.
+        // So when the original path contains a backward 'jmp', the threaded jump
+        // must be a backward 'jmp', too.
+        size_t dest = Next(jump.Dest);
+        bool backward_jmp_on_path = (SCMD_JMP == jump.Op && dest <= idx);
+        for (size_t hops = 0u; hops < kMaxJumpHops && dest < _instrs.size(); hops++)
+        {
+            Instruction const &hop = _instrs[dest];
+            // A 'jmp' will always jump, and so will the same conditional jump
+            // because AX hasn't changed in between
+            if (SCMD_JMP != hop.Op && jump.Op != hop.Op)
+                break;
+            size_t const hop_dest = Next(hop.Dest);
+            if (hop_dest == dest)
+                break; // Endless loop
+            if (SCMD_JMP == hop.Op && hop_dest <= dest)
+                backward_jmp_on_path = true;
+            if (backward_jmp_on_path && !(SCMD_JMP == jump.Op && hop_dest <= idx))
+                break;
+            dest = jump.Dest = hop_dest;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool AGS::Optimizer::RemoveNoOps()
+{
+    bool changed = false;
+    for (size_t idx = 0u; idx < _instrs.size(); idx++)
+    {
+        Instruction const &instr = _instrs[idx];
+        if (instr.Removed)
+            continue;
+
+        if (SCMD_REGTOREG == instr.Op && instr.Args[0] == instr.Args[1])
+        {
+            Remove(idx);
+            changed = true;
+            continue;
+        }
+
+        size_t const next = Next(idx + 1u);
+        if (IsJump(instr.Op) && Next(instr.Dest) == next)
+        {
+            Remove(idx);
+            changed = true;
+            continue;
+        }
+
+        // 'mov' back to the register that has just been copied
+        if (SCMD_REGTOREG == instr.Op && next < _instrs.size() && !_isDest[next] &&
+            SCMD_REGTOREG == _instrs[next].Op &&
+            instr.Args[0] == _instrs[next].Args[1] && instr.Args[1] == _instrs[next].Args[0])
+        {
+            Remove(next);
+            changed = true;
+            continue;
+        }
+
+        if (SCMD_PUSHREG == instr.Op && next < _instrs.size() && !_isDest[next] &&
+            SCMD_POPREG == _instrs[next].Op && instr.Args[0] == _instrs[next].Args[0])
+        {
+            Remove(next);
+            Remove(idx);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool AGS::Optimizer::ReplacePushPop()
+{
+    bool changed = false;
+    std::vector<size_t> sp_relative;
+    for (size_t idx = 0u; idx < _instrs.size(); idx++)
+    {
+        Instruction const &push = _instrs[idx];
+        if (push.Removed || SCMD_PUSHREG != push.Op || !IsRegister(push.Args[0]) || SREG_SP == push.Args[0])
+            continue;
+
+        // Find the 'pop' that belongs to the 'push'. Everything in between
+        // must be straight code that doesn't use the stack.
+        unsigned used_regs = 0u;
+        sp_relative.clear();
+        size_t pop_idx = Next(idx + 1u);
+        for (size_t window = 0u; window < kPushPopWindow; window++, pop_idx = Next(pop_idx + 1u))
+        {
+            if (pop_idx >= _instrs.size() || _isDest[pop_idx])
+                break;
+            Instruction const &instr = _instrs[pop_idx];
+            if (SCMD_POPREG == instr.Op)
+                break;
+            unsigned regs;
+            if (!GetRegisterUse(instr, regs) || 0u != (regs & RegisterBit(SREG_SP)))
+            {
+                pop_idx = _instrs.size();
+                break;
+            }
+            if (SCMD_LOADSPOFFS == instr.Op)
+            {
+                // Without the 'push', the SP will be lower by one stack cell
+                if (instr.Args[0] <= static_cast<CodeCell>(SIZE_OF_STACK_CELL))
+                {
+                    pop_idx = _instrs.size(); // accesses the pushed value itself
+                    break;
+                }
+                sp_relative.push_back(pop_idx);
+            }
+            used_regs |= regs;
+        }
+        if (pop_idx >= _instrs.size() || _isDest[pop_idx] || SCMD_POPREG != _instrs[pop_idx].Op)
+            continue;
+
+        // The 'pop' target must not be touched in between because it is going to be set early
+        CodeCell const popped = _instrs[pop_idx].Args[0];
+        if (!IsRegister(popped) || SREG_SP == popped || 0u != (used_regs & RegisterBit(popped)))
+            continue;
+
+        for (auto const sp_idx : sp_relative)
+            _instrs[sp_idx].Args[0] -= SIZE_OF_STACK_CELL;
+        Remove(pop_idx);
+        Instruction &move = _instrs[idx];
+        move.Op = SCMD_REGTOREG;
+        move.Args[1] = popped;
+        changed = true;
+    }
+    return changed;
+}
+
+bool AGS::Optimizer::RemoveRedundantMemoryAccess()
+{
+    auto const is_mar_setting = [](Instruction const &instr)
+    {
+        return SCMD_LOADSPOFFS == instr.Op || (SCMD_LITTOREG == instr.Op && SREG_MAR == instr.Args[0]);
+    };
+    auto const is_memory_access = [](Instruction const &instr)
+    {
+        switch (instr.Op)
+        {
+        default:
+            return false;
+        case SCMD_MEMREAD:
+        case SCMD_MEMREADB:
+        case SCMD_MEMREADPTR:
+        case SCMD_MEMREADW:
+        case SCMD_MEMWRITE:
+        case SCMD_MEMWRITEB:
+        case SCMD_MEMWRITEW:
+            return SREG_MAR != instr.Args[0] && SREG_SP != instr.Args[0];
+        }
+    };
+    // The 'memwrite' that writes the same bytes that the 'memread' reads
+    auto const write_op_of = [](CodeCell const read_op)
+    {
+        switch (read_op)
+        {
+        default: return 0;
+        case SCMD_MEMREAD: return SCMD_MEMWRITE;
+        case SCMD_MEMREADB: return SCMD_MEMWRITEB;
+        case SCMD_MEMREADW: return SCMD_MEMWRITEW;
+        }
+    };
+
+    bool changed = false;
+    for (size_t idx = 0u; idx < _instrs.size(); idx++)
+    {
+        Instruction const &instr = _instrs[idx];
+        size_t const next = Next(idx + 1u);
+        if (instr.Removed || next >= _instrs.size() || _isDest[next])
+            continue;
+        Instruction const &next_instr = _instrs[next];
+
+        if (is_mar_setting(instr))
+        {
+            // Accessing memory doesn't change MAR nor SP, so setting MAR to the same value again is useless
+            if (!is_memory_access(next_instr))
+                continue;
+            size_t const after = Next(next + 1u);
+            if (after < _instrs.size() && !_isDest[after] && AreIdentical(idx, after))
+            {
+                Remove(after);
+                changed = true;
+            }
+            continue;
+        }
+
+        if (!is_memory_access(instr) || instr.Args[0] != next_instr.Args[0])
+            continue;
+
+        // Writing back the value that has just been read
+        if (0 != write_op_of(instr.Op) && write_op_of(instr.Op) == next_instr.Op)
+        {
+            Remove(next);
+            changed = true;
+            continue;
+        }
+
+        // Reading back the value that has just been written; the register still has it
+        if (SCMD_MEMWRITE == instr.Op && SCMD_MEMREAD == next_instr.Op)
+        {
+            Remove(next);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void AGS::Optimizer::Encode()
+{
+    _newLocs.assign(_instrs.size() + 1u, 0);
+    CodeLoc loc = 0;
+    for (size_t idx = 0u; idx < _instrs.size(); idx++)
+    {
+        _newLocs[idx] = loc;
+        if (!_instrs[idx].Removed)
+            loc += 1 + static_cast<CodeLoc>(ArgsCount(_instrs[idx].Op));
+    }
+    _newLocs.back() = loc;
+
+    std::vector<CodeCell> code;
+    code.reserve(loc);
+    for (size_t idx = 0u; idx < _instrs.size(); idx++)
+    {
+        Instruction const &instr = _instrs[idx];
+        if (instr.Removed)
+            continue;
+        code.push_back(instr.Op);
+        for (size_t arg_idx = 0u; arg_idx < ArgsCount(instr.Op); arg_idx++)
+        {
+            CodeCell arg = instr.Args[arg_idx];
+            if (IsJump(instr.Op))
+                arg = ccCompiledScript::RelativeJumpDist(_newLocs[idx] + 1, _newLocs[Next(instr.Dest)]);
+            else if (SCMD_THISBASE == instr.Op || FIXUP_FUNCTION == instr.Fixups[arg_idx])
+                arg = Relocate(arg); // Code location
+            code.push_back(arg);
+        }
+    }
+
+    // Fixups within removed instructions are dropped
+    std::vector<CodeLoc> fixups;
+    std::vector<char> fixuptypes;
+    for (size_t fixup_idx = 0u; fixup_idx < _scrip.fixups.size(); fixup_idx++)
+    {
+        CodeLoc fixup_loc = _scrip.fixups[fixup_idx];
+        if (FIXUP_DATADATA != _scrip.fixuptypes[fixup_idx])
+        {
+            size_t const instr_idx = InstructionAt(fixup_loc);
+            if (_instrs[instr_idx].Removed)
+                continue;
+            fixup_loc = _newLocs[instr_idx] + (fixup_loc - _instrs[instr_idx].Loc);
+        }
+        fixups.push_back(fixup_loc);
+        fixuptypes.push_back(_scrip.fixuptypes[fixup_idx]);
+    }
+
+    for (auto &func : _scrip.Functions)
+        func.CodeOffs = Relocate(func.CodeOffs);
+    for (auto &addr : _scrip.export_addr)
+        if (EXPORT_FUNCTION == (addr >> 24))
+            addr = Relocate(addr & 0x00ffffff) | static_cast<CodeLoc>(addr & 0xff000000);
+    for (auto &offset : _scrip.sectionOffsets)
+        offset = Relocate(offset);
+
+    _scrip.code = std::move(code);
+    _scrip.fixups = std::move(fixups);
+    _scrip.fixuptypes = std::move(fixuptypes);
+}
+
+bool AGS::Optimizer::Optimize()
+{
+    if (!_scrip.Labels.empty() || !Decode())
+        return false;
+
+    for (bool changed = true; changed;)
+    {
+        FindDestinations();
+        changed = ThreadJumps();
+        FindDestinations();
+        changed |= RemoveNoOps();
+        FindDestinations();
+        changed |= ReplacePushPop();
+        FindDestinations();
+        changed |= RemoveRedundantMemoryAccess();
+    }
+
+    Encode();
+    return true;
+}
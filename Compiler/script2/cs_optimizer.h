@@ -0,0 +1,113 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Peephole optimizer for the Bytecode that the parser has emitted.
+//
+// The code of the whole script is decoded into a list of instructions.
+// Short sequences of instructions are rewritten or removed until nothing
+// changes any more, then the code is written anew. Jump offsets, fixups,
+// function starts, exports and section offsets are moved along with the
+// code; 'linenum' directives stay where they are in relation to the
+// instructions around them.
+//
+//=============================================================================
+#ifndef __CS_OPTIMIZER_H
+#define __CS_OPTIMIZER_H
+
+#include <vector>
+
+#include "cc_compiledscript.h"
+#include "script/cc_internal.h"
+
+namespace AGS
+{
+
+class Optimizer
+{
+public:
+    Optimizer(ccCompiledScript &scrip);
+
+    // Optimize the code of the script.
+    // Returns false if the code contains something that the optimizer doesn't
+    // understand; the script is left unchanged in this case.
+    bool Optimize();
+
+    // Convert a location in the code before the optimization to the
+    // location in the optimized code. A location of a removed instruction
+    // is converted to the location of the instruction that follows it.
+    CodeLoc Relocate(CodeLoc loc) const;
+
+    // Number of instructions that have been removed
+    inline size_t RemovedCount() const { return _removedCount; }
+
+private:
+    struct Instruction
+    {
+        CodeLoc Loc = 0;                        // location in the original code
+        CodeCell Op = 0;
+        CodeCell Args[MAX_SCMD_ARGS] = {};
+        FixupType Fixups[MAX_SCMD_ARGS] = {};   // fixup type of each argument
+        size_t Dest = 0u;                       // jumps: index of the destination
+        bool Removed = false;
+    };
+
+    // Maximal number of instructions between a 'push' and a 'pop'
+    // that are checked when replacing the pair by a register move
+    static size_t const kPushPopWindow = 24u;
+
+    ccCompiledScript &_scrip;
+    std::vector<Instruction> _instrs;
+    // Instructions that can be reached other than from the instruction before
+    std::vector<bool> _isDest;
+    // Location of each instruction in the optimized code; the last element
+    // is the size of the optimized code
+    std::vector<CodeLoc> _newLocs;
+    size_t _removedCount = 0u;
+
+    static size_t ArgsCount(CodeCell op);
+    static bool IsJump(CodeCell op);
+    // Get the registers that 'instr' reads or writes, as a bit set.
+    // Returns false for instructions that 'push' and 'pop' may not be moved over.
+    static bool GetRegisterUse(Instruction const &instr, unsigned &regs);
+
+    // Index of the first instruction at or after 'idx' that hasn't been removed
+    size_t Next(size_t idx) const;
+    // Index of the instruction that contains the code location 'loc'
+    size_t InstructionAt(CodeLoc loc) const;
+    // Whether two instructions are identical, including their fixups
+    bool AreIdentical(size_t idx1, size_t idx2) const;
+    void Remove(size_t idx);
+
+    // Split the code into instructions
+    bool Decode();
+    // Find all the instructions that can be reached other than from the instruction before
+    void FindDestinations();
+
+    // Make jumps that land on jumps go to the final destination instead
+    bool ThreadJumps();
+    // Remove 'mov' to the same register or back to the source register, jumps to the
+    // next instruction, and 'push' directly followed by 'pop' of the same register
+    bool RemoveNoOps();
+    // Replace 'push' and a later 'pop' by a register move where this is safe
+    bool ReplacePushPop();
+    // Remove setting MAR to the value it already has, reading a value that has just been written,
+    // and writing a value that has just been read
+    bool RemoveRedundantMemoryAccess();
+
+    // Write the code and the code locations of the script anew
+    void Encode();
+};
+
+} // namespace AGS
+#endif // __CS_OPTIMIZER_H
@@ -54,6 +54,10 @@ The second phase has the following main components:
         location of the respective struct is calculated at compile time, whereas array
         offsets are calculated at run time.
 
+    Optimization
+        When SCOPT_OPTIMIZE is set, the emitted code is run through a peephole
+        optimizer at the end of the second phase, in Parse_Optimize().
+
 Notes on how nested statements are handled:
     When handling nested constructs, the parser sometimes generates and emits some code,
     then rips it out of the codebase and stores it internally, then later on, retrieves
@@ -200,6 +204,7 @@ Pointers are exclusively used for managed memory. If managed structs are manipul
 #include <fstream>
 #include <cmath>
 #include <climits>
+#include <limits>
 #include <memory>
 
 #include "util/string.h"
@@ -210,13 +215,10 @@ Pointers are exclusively used for managed memory. If managed structs are manipul
 #include "cc_symboltable.h"
 
 #include "cs_parser_common.h"
+#include "cs_optimizer.h"
 #include "cs_scanner.h"
 #include "cs_parser.h"
 
-// Declared in Common/script/cc_common.h 
-// Defined in Common/script/cc_common.cpp
-extern int currentline;
-
 char ccCopyright2[] = "ScriptCompiler32 v" SCOM_VERSIONSTR " (c) 2000-2007 Chris Jones and 2011-2024 others";
 
 // Used when generating Bytecode jump statements where the destination of
@@ -5162,7 +5164,6 @@ void AGS::Parser::ParseStruct(TypeQualifierSet tqs, Symbol &struct_of_current_fu
     // Declaration of the components
     while (kKW_CloseBrace != _src.PeekNext())
     {
-        currentline = _src.GetLinenoAt(_src.GetCursor());
         TypeQualifierSet tqs = {};
         ParseQualifiers(tqs);
         bool const in_func_body = false;
@@ -5491,7 +5492,9 @@ void AGS::Parser::ParseExport_Function(Symbol func)
         _sym[func].FunctionD->Offset,
         _sym.FuncParamsCount(func) + 100u * _sym[func].FunctionD->IsVariadic);
     if (retval < 0)
-        InternalError("Could not export function");
+        UserError(
+            "Cannot export function '%s': export offset too high; script code size too large?",
+            _sym.GetName(func).c_str());
 }
 
 void AGS::Parser::ParseExport_Variable(Symbol var)
@@ -5513,7 +5516,9 @@ void AGS::Parser::ParseExport_Variable(Symbol var)
         _sym.GetName(var).c_str(),
         _sym[var].VariableD->Offset);
     if (retval < 0)
-        InternalError("Could not export variable");
+        UserError(
+            "Cannot export variable '%s': export offset too high; script data size too large?",
+            _sym.GetName(var).c_str());
 }
 
 void AGS::Parser::ParseExport()
@@ -6541,7 +6546,6 @@ void AGS::Parser::ParseInput()
     {
         size_t const next_pos = _src.GetCursor();
         HandleSrcSectionChangeAt(next_pos);
-        currentline = _src.GetLinenoAt(next_pos);
 
         ParseQualifiers(tqs);
         
@@ -6765,6 +6769,21 @@ void AGS::Parser::Parse_CheckFixupSanity()
     }
 }
 
+void AGS::Parser::Parse_Optimize()
+{
+    Optimizer optimizer(_scrip);
+    if (!optimizer.Optimize())
+        return; // Code is left as it is
+
+    // The life scopes of functions and variables are code locations
+    for (auto entries : { &_sym.entries, &_sym.localEntries })
+        for (auto &entry : *entries)
+        {
+            entry.LifeScope.first = optimizer.Relocate(entry.LifeScope.first);
+            entry.LifeScope.second = optimizer.Relocate(entry.LifeScope.second);
+        }
+}
+
 void AGS::Parser::Parse_ExportAllFunctions()
 {
     for (size_t func_idx = 0; func_idx < _scrip.Functions.size(); func_idx++)
@@ -6773,7 +6792,9 @@ void AGS::Parser::Parse_ExportAllFunctions()
             _scrip.Functions[func_idx].Name,
             _scrip.Functions[func_idx].CodeOffs,
             _scrip.Functions[func_idx].ParamsCount))
-            InternalError("Function export failed. Out of memory?");
+            UserError(
+                "Cannot export function '%s': export offset too high; script code size too large?",
+                _scrip.Functions[func_idx].Name.c_str());
     }
 }
 
@@ -6813,6 +6834,8 @@ void AGS::Parser::Parse()
         if (FlagIsSet(_options, SCOPT_EXPORTALL))
 			Parse_ExportAllFunctions();
         Parse_BlankOutUnusedImports();
+        if (FlagIsSet(_options, SCOPT_OPTIMIZE))
+            Parse_Optimize();
         return Parse_CheckFixupSanity();
     }
     catch (CompilingError &)
@@ -6822,7 +6845,7 @@ void AGS::Parser::Parse()
     catch (std::exception const &e)
     {
         std::string msg = "Exception encountered at currentline = <line>: ";
-        msg.replace(msg.find("<line>"), 6u, std::to_string(currentline));
+        msg.replace(msg.find("<line>"), 6u, std::to_string(_src.GetLineno()));
         msg.append(e.what());
 
         _msgHandler.AddMessage(
@@ -6871,3 +6894,34 @@ int cc_compile(std::string const &inpl, AGS::FlagSet options, AGS::ccCompiledScr
     sections = lh.CreateSectionList();
     return error_code;
 }
+
+int cc_scan_headers(std::string const &inpl, AGS::HeaderSnapshot &headers, AGS::MessageHandler &mh)
+{
+    size_t cursor = 0u;
+    AGS::SrcList src = AGS::SrcList(headers.Tokens, headers.Lines, cursor);
+    src.NewSection("UnnamedSection");
+    src.NewLine(1u);
+
+    AGS::ccCompiledScript string_collector;
+    int const error_code = cc_scan(inpl, src, string_collector, headers.Sym, mh);
+    headers.Strings = std::move(string_collector.strings);
+    return error_code;
+}
+
+int cc_compile(AGS::HeaderSnapshot const &headers, std::string const &inpl, AGS::FlagSet options,
+    AGS::ccCompiledScript &scrip, AGS::SymbolTable &symt, AGS::SectionList &sections, AGS::MessageHandler &mh)
+{
+    // Scanning continues after the tokens of the headers; when the input starts
+    // a new section (as preprocessed scripts do), this yields the same as
+    // scanning the headers and the input in one go
+    std::vector<AGS::Symbol> symbols = headers.Tokens;
+    AGS::LineHandler lh = headers.Lines;
+    size_t cursor = 0u;
+    AGS::SrcList src = AGS::SrcList(symbols, lh, cursor);
+
+    int error_code = cc_scan(inpl, src, scrip, symt, mh);
+    if (error_code >= 0)
+        error_code = cc_parse(src, options, scrip, symt, mh);
+    sections = lh.CreateSectionList();
+    return error_code;
+}
@@ -153,8 +153,6 @@ private:
         static int const kNoJumpOut = INT_MAX;
 
     private:
-        static int _chunkIdCtr; // for assigning unique IDs to chunks
-
         // All data that is associated with a level of the nested compound statements
         struct NestingInfo
         {
@@ -283,8 +281,8 @@ private:
             kLOC_SymbolTable, // in the entry _sym[this->Symbol]
         } Location = kLOC_None;
 
-        Symbol Symbol = kKW_NoSymbol; 
-        Vartype Vartype = kKW_NoSymbol;
+        AGS::Symbol Symbol = kKW_NoSymbol; 
+        AGS::Vartype Vartype = kKW_NoSymbol;
         bool LocalNonParameter = true;
         bool SideEffects = false;
         bool Modifiable = false;
@@ -341,7 +339,7 @@ private:
 
     public:
         MarMgr(Parser &parser);
-        MarMgr& MarMgr::operator=(const MarMgr &other);
+        MarMgr& operator=(const MarMgr &other);
 
         // Set the type and the start offset of the MAR register
         void SetStart(ScopeType type, size_t offset);
@@ -393,9 +391,6 @@ private:
     size_t _lastEmittedSectionId;
     size_t _lastEmittedLineno;
 
-    // Buffer for ccCurScriptName
-    std::string _scriptNameBuffer;
-
     // Augment the message with a "See ..." indication
     // 'declared' is the point in _src where the thing is declared
     std::string const ReferenceMsgLoc(std::string const &msg, size_t declared);
@@ -697,7 +692,7 @@ private:
     
     void AccessData_Variable(VariableAccess access_type, SrcList &expression, EvaluationResult &eres);
 
-    void AGS::Parser::AccessData_This(EvaluationResult &eres);
+    void AccessData_This(EvaluationResult &eres);
 
     // We're getting a variable, literal, constant, func call or the first element
     // of a STRUCT.STRUCT.STRUCT... cascade.
@@ -977,7 +972,6 @@ private:
         { return RegisterGuard(RegisterList{ guarded_register }, block); }
 
     // If a new section has begun at cursor position pos, tell _scrip to deal with that.
-    // Refresh ccCurScriptName
     void HandleSrcSectionChangeAt(size_t pos);
 
     // Emit an opcode without parameters
@@ -1024,6 +1018,9 @@ private:
     // Sanity check for the fixups
     void Parse_CheckFixupSanity();
 
+    // Run the code through the peephole optimizer
+    void Parse_Optimize();
+
     void Parse_ExportAllFunctions();
 
     // Blank out all imports that haven't been referenced
@@ -1047,8 +1044,25 @@ public:
     void Parse();
 
 }; // class Parser
+
+// The result of scanning the headers that several scripts are compiled against.
+// It isn't changed by compiling, so it may be shared by any number of compilations,
+// also concurrent ones: each of them scans its script on top of a copy of it.
+struct HeaderSnapshot
+{
+    std::vector<Symbol> Tokens;
+    LineHandler Lines;
+    SymbolTable Sym;
+    std::vector<char> Strings; // string literals found in the headers
+};
 } // namespace AGS
 
+// Scan the headers into 'headers', return any messages in mh
+extern int cc_scan_headers(
+    std::string const &source,       // preprocessed headers
+    AGS::HeaderSnapshot &headers,    // store for the scanned headers
+    AGS::MessageHandler &mh);        // warnings and the error
+
 // Compile the input, return any messages in mh, cc_error() does not get called
 extern int cc_compile(
     std::string const &source,  // preprocessed text to be compiled
@@ -1063,5 +1077,15 @@ extern int cc_compile(
     AGS::SymbolTable &symt,          // store for the parsed symbols
     AGS::SectionList &sections,      // store for the list of sections
     AGS::MessageHandler &mh);        // warnings and the error   
+// Compile the input as if it followed the text of the headers;
+// 'scrip' must start with the strings of the headers
+extern int cc_compile(
+    AGS::HeaderSnapshot const &headers, // headers that have been scanned before
+    std::string const &source,  // preprocessed text to be compiled
+    AGS::FlagSet options,            // as defined in cc_options 
+    AGS::ccCompiledScript &scrip,    // store for the compiled text
+    AGS::SymbolTable &symt,          // copy of the headers' symbol table, store for the parsed symbols
+    AGS::SectionList &sections,      // store for the list of sections
+    AGS::MessageHandler &mh);        // warnings and the error   
 
 #endif // __CS_PARSER_H
@@ -713,7 +713,6 @@ void AGS::Scanner::ReadInGTCombi(std::string &symstring)
 
 void AGS::Scanner::SymstringToSym(std::string const &symstring, ScanType scan_type, CodeCell value, Symbol &symb)
 {
-    static Symbol const const_string_vartype = _sym.VartypeWithConst(kKW_String);
     static const char *const one_past_long_max_string = "2147483648";
 
     symb = _sym.FindOrAdd(symstring);
@@ -727,7 +726,7 @@ void AGS::Scanner::SymstringToSym(std::string const &symstring, ScanType scan_ty
 
     case Scanner::kSct_StringLiteral:
         _sym[symb].LiteralD = new SymbolTableEntry::LiteralDesc;
-        _sym[symb].LiteralD->Vartype = const_string_vartype;
+        _sym[symb].LiteralD->Vartype = _sym.VartypeWithConst(kKW_String);
         _sym[symb].LiteralD->Value = value;
         return;
 
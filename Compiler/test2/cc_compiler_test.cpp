@@ -0,0 +1,189 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "script/cc_common.h"
+
+#include "script2/cs_compiler.h"
+#include "script2/cs_parser.h"
+
+#include "cc_parser_test_lib.h"
+
+
+// Compiling against a header snapshot must yield the same as compiling
+// the headers and the script in one go
+
+static char const *const kSnapshotHeaders = "\
+\"__NEWSCRIPTSTART_Defs\"                               \n\
+    managed struct Thing                                \n\
+    {                                                   \n\
+        int Payload;                                    \n\
+        import void Poke(int amount);                   \n\
+    };                                                  \n\
+    import int Counter;                                 \n\
+    import int Twice(int value);                        \n\
+    import Thing *MakeThing();                          \n\
+    readonly int SomeConst = 17;                        \n\
+";
+
+static char const *const kSnapshotModules[] = {
+"\
+\"__NEWSCRIPTSTART_ModuleA\"                            \n\
+    int Counter;                                        \n\
+    export Counter;                                     \n\
+    int Twice(int value)                                \n\
+    {                                                   \n\
+        Counter++;                                      \n\
+        return 2 * value + SomeConst;                   \n\
+    }                                                   \n\
+",
+"\
+\"__NEWSCRIPTSTART_ModuleB\"                            \n\
+    int Use()                                           \n\
+    {                                                   \n\
+        String label = \"module b\";                    \n\
+        Thing *t = MakeThing();                         \n\
+        t.Poke(Twice(Counter));                         \n\
+        return (t.Payload > 5) == true;                 \n\
+    }                                                   \n\
+",
+"\
+\"__NEWSCRIPTSTART_ModuleC\"                            \n\
+    Thing *MakeThing()                                  \n\
+    {                                                   \n\
+        return new Thing;                               \n\
+    }                                                   \n\
+    void Thing::Poke(int amount)                        \n\
+    {                                                   \n\
+        this.Payload += amount;                         \n\
+    }                                                   \n\
+",
+};
+
+static uint64_t const kSnapshotOptions = SCOPT_EXPORTALL | SCOPT_LINENUMBERS;
+
+static std::string SnapshotHeaders()
+{
+    return std::string(g_Input_Bool) + g_Input_String + kSnapshotHeaders;
+}
+
+static void CompareScripts(ccScript const &expected, ccScript const &actual)
+{
+    EXPECT_EQ(expected.code, actual.code);
+    EXPECT_EQ(expected.fixups, actual.fixups);
+    EXPECT_EQ(expected.fixuptypes, actual.fixuptypes);
+    EXPECT_EQ(expected.globaldata, actual.globaldata);
+    EXPECT_EQ(expected.strings, actual.strings);
+    EXPECT_EQ(expected.imports, actual.imports);
+    EXPECT_EQ(expected.exports, actual.exports);
+    EXPECT_EQ(expected.export_addr, actual.export_addr);
+    EXPECT_EQ(expected.sectionNames, actual.sectionNames);
+    EXPECT_EQ(expected.sectionOffsets, actual.sectionOffsets);
+}
+
+static std::unique_ptr<ccScript> CompileDirectly(std::string const &script)
+{
+    AGS::MessageHandler mh;
+    std::unique_ptr<ccScript> compiled(
+        ccCompileText2(SnapshotHeaders() + script, "Module", kSnapshotOptions, mh));
+    EXPECT_FALSE(mh.HasError()) << mh.GetError().Message;
+    return compiled;
+}
+
+TEST(Compiler2, HeaderSnapshot) {
+
+    AGS::MessageHandler mh;
+    auto const headers = ccScanHeaders2(SnapshotHeaders(), mh);
+    ASSERT_TRUE(headers) << mh.GetError().Message;
+
+    for (auto const module : kSnapshotModules)
+    {
+        auto const expected = CompileDirectly(module);
+        ASSERT_TRUE(expected);
+
+        // Compile twice to check that the snapshot isn't changed by compiling
+        for (int i = 0; i < 2; i++)
+        {
+            AGS::MessageHandler module_mh;
+            std::unique_ptr<ccScript> compiled(
+                ccCompileText2(*headers, module, "Module", kSnapshotOptions, module_mh));
+            ASSERT_TRUE(compiled) << module_mh.GetError().Message;
+            CompareScripts(*expected, *compiled);
+        }
+    }
+}
+
+TEST(Compiler2, HeaderSnapshotParallel) {
+
+    AGS::MessageHandler mh;
+    auto const headers = ccScanHeaders2(SnapshotHeaders(), mh);
+    ASSERT_TRUE(headers) << mh.GetError().Message;
+
+    size_t const module_count = sizeof(kSnapshotModules) / sizeof(kSnapshotModules[0]);
+    std::vector<std::unique_ptr<ccScript>> compiled(module_count);
+    std::vector<AGS::MessageHandler> module_mh(module_count);
+    std::vector<std::thread> threads;
+    for (size_t m = 0; m < module_count; m++)
+        threads.emplace_back([&, m]()
+        {
+            compiled[m].reset(
+                ccCompileText2(*headers, kSnapshotModules[m], "Module", kSnapshotOptions, module_mh[m]));
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    for (size_t m = 0; m < module_count; m++)
+    {
+        ASSERT_TRUE(compiled[m]) << module_mh[m].GetError().Message;
+        auto const expected = CompileDirectly(kSnapshotModules[m]);
+        ASSERT_TRUE(expected);
+        CompareScripts(*expected, *compiled[m]);
+    }
+}
+
+TEST(Compiler2, HeaderSnapshotError) {
+
+    AGS::MessageHandler mh;
+    auto const headers = ccScanHeaders2(SnapshotHeaders(), mh);
+    ASSERT_TRUE(headers) << mh.GetError().Message;
+
+    char const *const inpl = "\
+\"__NEWSCRIPTSTART_Broken\"                             \n\
+    int Twice(int value)                                \n\
+    {                                                   \n\
+        return Unknown;                                 \n\
+    }                                                   \n\
+";
+    AGS::MessageHandler module_mh;
+    std::unique_ptr<ccScript> compiled(
+        ccCompileText2(*headers, inpl, "Broken", kSnapshotOptions, module_mh));
+    ASSERT_FALSE(compiled);
+    ASSERT_TRUE(module_mh.HasError());
+    EXPECT_EQ("Broken", module_mh.GetError().Section);
+    EXPECT_EQ(3u, module_mh.GetError().Lineno);
+    EXPECT_NE(std::string::npos, module_mh.GetError().Message.find("Unknown"));
+}
+
+TEST(Compiler2, HeaderSnapshotScanError) {
+
+    AGS::MessageHandler mh;
+    auto const headers = ccScanHeaders2(std::string(kSnapshotHeaders) + "struct Open {\n", mh);
+    EXPECT_FALSE(headers);
+    EXPECT_TRUE(mh.HasError());
+}
@@ -0,0 +1,671 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "script/cc_common.h"
+#include "script/cc_internal.h"
+
+#include "script2/cs_parser.h"
+
+
+// Number of arguments of each opcode
+static size_t ArgsCount(int32_t const op)
+{
+    static size_t const args_count[CC_NUM_SCCMDS] =
+    {
+        0, 2, 2, 2, 2, 0, 2, 1,  1, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 1,  1, 1, 1, 1, 1, 1, 1, 1,
+        2, 1, 1, 1, 1, 1, 1, 1,  2, 2, 1, 2, 2, 1, 2, 1,
+        1, 0, 1, 1, 0, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 1,
+        1, 2, 2, 1, 0, 0, 1, 1,  3, 2, 3, 3,
+    };
+    return args_count[op];
+}
+
+// Runs the Bytecode of simple scripts that don't use imports, managed memory or floats.
+// This is just enough for comparing the unoptimized and the optimized code.
+class TestVM
+{
+public:
+    size_t Executed = 0u;   // Number of instructions that have been executed
+
+    TestVM(AGS::ccCompiledScript const &scrip)
+        : _scrip(scrip)
+        , _code(scrip.code)
+        , _mem(kStackBase + kStackSize, 0)
+    {
+        memcpy(&_mem[kGlobalBase], scrip.globaldata.data(), scrip.globaldata.size());
+        memcpy(&_mem[kStringsBase], scrip.strings.data(), scrip.strings.size());
+        for (size_t fixup_idx = 0u; fixup_idx < scrip.fixups.size(); fixup_idx++)
+        {
+            int32_t const loc = scrip.fixups[fixup_idx];
+            switch (scrip.fixuptypes[fixup_idx])
+            {
+            default:
+                _error = "unsupported fixup";
+                break;
+            case FIXUP_FUNCTION:
+                break; // code locations are used as they are
+            case FIXUP_GLOBALDATA:
+                _code[loc] += kGlobalBase;
+                break;
+            case FIXUP_STRING:
+                _code[loc] += kStringsBase;
+                break;
+            case FIXUP_DATADATA:
+                Write(kGlobalBase + loc, 4, Read(kGlobalBase + loc, 4) + kGlobalBase);
+                break;
+            }
+        }
+    }
+
+    // Call the function 'name'; returns the value of AX, or an error message in 'error'
+    int32_t Call(std::string const &name, std::vector<int32_t> const &args, std::string &error)
+    {
+        int32_t start = -1;
+        std::string const export_name = name + "$" + std::to_string(args.size());
+        for (size_t idx = 0u; idx < _scrip.exports.size(); idx++)
+            if (_scrip.exports[idx] == export_name)
+                start = _scrip.export_addr[idx] & 0x00ffffff;
+        if (start < 0)
+            error = "function not found";
+        if (!error.empty() || !(error = _error).empty())
+            return 0;
+
+        int32_t const sp_start = _reg[SREG_SP] = kStackBase;
+        for (auto arg = args.crbegin(); arg != args.crend(); arg++)
+            Push(*arg);
+        Push(kReturnToCaller);
+        Run(start);
+        _reg[SREG_SP] -= static_cast<int32_t>(4u * args.size());
+        if (_error.empty() && sp_start != _reg[SREG_SP])
+            _error = "stack isn't balanced";
+        error = _error;
+        return _reg[SREG_AX];
+    }
+
+    std::vector<char> Globals() const
+    {
+        return std::vector<char>(
+            _mem.begin() + kGlobalBase,
+            _mem.begin() + kGlobalBase + _scrip.globaldata.size());
+    }
+
+private:
+    static int32_t const kGlobalBase = 0x1000;
+    static int32_t const kStringsBase = 0x20000;
+    static int32_t const kStackBase = 0x30000;
+    static int32_t const kStackSize = 0x10000;
+    static int32_t const kReturnToCaller = -1;
+    static size_t const kMaxSteps = 1000000u;
+
+    AGS::ccCompiledScript const &_scrip;
+    std::vector<int32_t> _code;
+    std::vector<unsigned char> _mem;
+    int32_t _reg[CC_NUM_REGISTERS] = {};
+    std::string _error;
+
+    int32_t Read(int32_t addr, size_t size)
+    {
+        if (addr < kGlobalBase || addr + static_cast<int32_t>(size) > kStackBase + kStackSize)
+        {
+            _error = "read out of bounds";
+            return 0;
+        }
+        switch (size)
+        {
+        default: return static_cast<int32_t>(
+            _mem[addr] | _mem[addr + 1] << 8 | _mem[addr + 2] << 16 | _mem[addr + 3] << 24);
+        case 2: return static_cast<int16_t>(_mem[addr] | _mem[addr + 1] << 8);
+        case 1: return _mem[addr];
+        }
+    }
+
+    void Write(int32_t addr, size_t size, int32_t value)
+    {
+        if (addr < kGlobalBase || addr + static_cast<int32_t>(size) > kStackBase + kStackSize)
+        {
+            _error = "write out of bounds";
+            return;
+        }
+        for (size_t idx = 0u; idx < size; idx++)
+            _mem[addr + idx] = static_cast<unsigned char>(value >> (8 * idx));
+    }
+
+    void Push(int32_t value)
+    {
+        Write(_reg[SREG_SP], 4u, value);
+        _reg[SREG_SP] += 4;
+    }
+
+    int32_t Pop()
+    {
+        _reg[SREG_SP] -= 4;
+        return Read(_reg[SREG_SP], 4u);
+    }
+
+    void Run(int32_t pc)
+    {
+        for (size_t steps = 0u; _error.empty(); steps++)
+        {
+            if (steps >= kMaxSteps || pc < 0 || pc >= static_cast<int32_t>(_code.size()))
+            {
+                _error = "runaway code";
+                return;
+            }
+            int32_t const op = _code[pc];
+            if (op <= 0 || op >= CC_NUM_SCCMDS)
+            {
+                _error = "illegal opcode";
+                return;
+            }
+            int32_t const arg1 = ArgsCount(op) > 0u ? _code[pc + 1] : 0;
+            int32_t const arg2 = ArgsCount(op) > 1u ? _code[pc + 2] : 0;
+            int32_t &reg1 = _reg[(arg1 >= 0 && arg1 < CC_NUM_REGISTERS) ? arg1 : 0];
+            int32_t &reg2 = _reg[(arg2 >= 0 && arg2 < CC_NUM_REGISTERS) ? arg2 : 0];
+            int32_t &mar = _reg[SREG_MAR];
+            pc += 1 + static_cast<int32_t>(ArgsCount(op));
+            Executed++;
+
+            switch (op)
+            {
+            default:
+                _error = "unsupported opcode " + std::to_string(op);
+                return;
+            case SCMD_LINENUM:
+            case SCMD_LOOPCHECKOFF:
+            case SCMD_THISBASE:
+                break;
+            case SCMD_ADD: reg1 += arg2; break;
+            case SCMD_SUB: reg1 -= arg2; break;
+            case SCMD_MUL: reg1 *= arg2; break;
+            case SCMD_REGTOREG: reg2 = reg1; break;
+            case SCMD_LITTOREG: reg1 = arg2; break;
+            case SCMD_WRITELIT: Write(mar, arg1, arg2); break;
+            case SCMD_MEMREAD: reg1 = Read(mar, 4u); break;
+            case SCMD_MEMREADW: reg1 = Read(mar, 2u); break;
+            case SCMD_MEMREADB: reg1 = Read(mar, 1u); break;
+            case SCMD_MEMWRITE: Write(mar, 4u, reg1); break;
+            case SCMD_MEMWRITEW: Write(mar, 2u, reg1); break;
+            case SCMD_MEMWRITEB: Write(mar, 1u, reg1); break;
+            case SCMD_ZEROMEMORY: for (int32_t idx = 0; idx < arg1; idx++) Write(mar + idx, 1u, 0); break;
+            case SCMD_LOADSPOFFS: mar = _reg[SREG_SP] - arg1; break;
+            case SCMD_MULREG: reg1 *= reg2; break;
+            case SCMD_ADDREG: reg1 += reg2; break;
+            case SCMD_SUBREG: reg1 -= reg2; break;
+            case SCMD_BITAND: reg1 &= reg2; break;
+            case SCMD_BITOR: reg1 |= reg2; break;
+            case SCMD_XORREG: reg1 ^= reg2; break;
+            case SCMD_SHIFTLEFT: reg1 <<= reg2; break;
+            case SCMD_SHIFTRIGHT: reg1 >>= reg2; break;
+            case SCMD_ISEQUAL: reg1 = (reg1 == reg2); break;
+            case SCMD_NOTEQUAL: reg1 = (reg1 != reg2); break;
+            case SCMD_GREATER: reg1 = (reg1 > reg2); break;
+            case SCMD_LESSTHAN: reg1 = (reg1 < reg2); break;
+            case SCMD_GTE: reg1 = (reg1 >= reg2); break;
+            case SCMD_LTE: reg1 = (reg1 <= reg2); break;
+            case SCMD_AND: reg1 = (reg1 && reg2); break;
+            case SCMD_OR: reg1 = (reg1 || reg2); break;
+            case SCMD_NOTREG: reg1 = !reg1; break;
+            case SCMD_DIVREG:
+            case SCMD_MODREG:
+                if (0 == reg2)
+                    _error = "division by zero";
+                else
+                    reg1 = (SCMD_DIVREG == op) ? reg1 / reg2 : reg1 % reg2;
+                break;
+            case SCMD_CHECKBOUNDS:
+                if (reg1 < 0 || reg1 >= arg2)
+                    _error = "array index out of bounds";
+                break;
+            case SCMD_JMP: pc += arg1; break;
+            case SCMD_JZ: if (0 == _reg[SREG_AX]) pc += arg1; break;
+            case SCMD_JNZ: if (0 != _reg[SREG_AX]) pc += arg1; break;
+            case SCMD_PUSHREG: Push(reg1); break;
+            case SCMD_POPREG: reg1 = Pop(); break;
+            case SCMD_CALL:
+                Push(pc);
+                pc = reg1;
+                break;
+            case SCMD_RET:
+                pc = Pop();
+                if (kReturnToCaller == pc)
+                    return;
+                break;
+            }
+        }
+    }
+};
+
+struct OptimizerCall
+{
+    char const *Function;
+    std::vector<int32_t> Args;
+};
+
+static void CompileForOptimizer(char const *inpl, AGS::FlagSet const options, AGS::ccCompiledScript &scrip)
+{
+    AGS::MessageHandler mh;
+    int const compile_result = cc_compile(inpl, options, scrip, mh);
+    ASSERT_GE(compile_result, 0) << (mh.HasError() ? mh.GetError().Message : "");
+}
+
+// Compile 'inpl' with and without optimization, run the calls against both
+// and compare the results
+static void CompareOptimizedRuns(char const *inpl, std::vector<OptimizerCall> const &calls, bool line_numbers = false)
+{
+    AGS::FlagSet const options = SCOPT_EXPORTALL;
+    AGS::ccCompiledScript plain_scrip(line_numbers);
+    CompileForOptimizer(inpl, options, plain_scrip);
+    AGS::ccCompiledScript optimized_scrip(line_numbers);
+    CompileForOptimizer(inpl, options | SCOPT_OPTIMIZE, optimized_scrip);
+    if (::testing::Test::HasFatalFailure())
+        return;
+
+    EXPECT_LT(optimized_scrip.code.size(), plain_scrip.code.size());
+    EXPECT_EQ(plain_scrip.exports, optimized_scrip.exports);
+
+    TestVM plain_vm(plain_scrip), optimized_vm(optimized_scrip);
+    for (auto const &call : calls)
+    {
+        std::string plain_error, optimized_error;
+        int32_t const plain_result = plain_vm.Call(call.Function, call.Args, plain_error);
+        ASSERT_EQ("", plain_error) << call.Function;
+        int32_t const optimized_result = optimized_vm.Call(call.Function, call.Args, optimized_error);
+        ASSERT_EQ("", optimized_error) << call.Function;
+        EXPECT_EQ(plain_result, optimized_result) << call.Function;
+        EXPECT_EQ(plain_vm.Globals(), optimized_vm.Globals()) << call.Function;
+    }
+    EXPECT_LT(optimized_vm.Executed, plain_vm.Executed);
+}
+
+// Split the code into its instructions; returns the code locations of the instructions
+static std::vector<size_t> Instructions(AGS::ccCompiledScript const &scrip)
+{
+    std::vector<size_t> instrs;
+    for (size_t loc = 0u; loc < scrip.code.size(); loc += 1u + ArgsCount(scrip.code[loc]))
+        instrs.push_back(loc);
+    return instrs;
+}
+
+static size_t CountOpcode(AGS::ccCompiledScript const &scrip, int32_t const op)
+{
+    size_t count = 0u;
+    for (auto const loc : Instructions(scrip))
+        count += (op == scrip.code[loc]);
+    return count;
+}
+
+TEST(Optimizer, Arithmetic) {
+
+    char const *inpl = "\
+        int Sum(int a, int b)                       \n\
+        {                                           \n\
+            int s = a + b;                          \n\
+            return s;                               \n\
+        }                                           \n\
+        int Fib(int n)                              \n\
+        {                                           \n\
+            if (n < 2)                              \n\
+                return n;                           \n\
+            return Fib(n - 1) + Fib(n - 2);         \n\
+        }                                           \n\
+        int Mix(int a, int b, int c)                \n\
+        {                                           \n\
+            int d = (a * b - c) / (b + 1) % 7;      \n\
+            int e = (a << 3) ^ (b >> 1) | (c & 12); \n\
+            int f = (a > b) && (b >= c) || !(a == c);\n\
+            int g = a < b ? Sum(a, c) : Sum(b, c);  \n\
+            g += d; g -= e; g *= f + 2;             \n\
+            return -g + (a != b) + (c <= a);        \n\
+        }                                           \n\
+        ";
+
+    CompareOptimizedRuns(inpl, {
+        { "Sum", { 3, 4 } },
+        { "Fib", { 15 } },
+        { "Mix", { 5, 9, 3 } },
+        { "Mix", { 17, -4, 2 } },
+        { "Mix", { -8, -8, 100 } },
+    });
+}
+
+TEST(Optimizer, Loops) {
+
+    char const *inpl = "\
+        int Total;                                  \n\
+        int Loops(int n)                            \n\
+        {                                           \n\
+            int total = 0;                          \n\
+            for (int i = 0; i < n; i++)             \n\
+            {                                       \n\
+                if (i % 3 == 0)                     \n\
+                    continue;                       \n\
+                total += i;                         \n\
+                if (total > 1000)                   \n\
+                    break;                          \n\
+            }                                       \n\
+            int j = n;                              \n\
+            while (j > 0)                           \n\
+            {                                       \n\
+                j /= 2;                             \n\
+                if (j == 7) break;                  \n\
+                total++;                            \n\
+            }                                       \n\
+            do                                      \n\
+            {                                       \n\
+                total--;                            \n\
+            } while (total % 5 != 0);               \n\
+            Total += total;                         \n\
+            return total;                           \n\
+        }                                           \n\
+        int Nested(int n)                           \n\
+        {                                           \n\
+            int count = 0;                          \n\
+            for (int i = 0; i < n; i++)             \n\
+                for (int j = 0; j < n; j++)         \n\
+                {                                   \n\
+                    if (i == j)                     \n\
+                    {                               \n\
+                        if (i > 2)                  \n\
+                            count += 2;             \n\
+                        else                        \n\
+                            count += 3;             \n\
+                    }                               \n\
+                    else                            \n\
+                        count--;                    \n\
+                }                                   \n\
+            return count;                           \n\
+        }                                           \n\
+        ";
+
+    CompareOptimizedRuns(inpl, {
+        { "Loops", { 0 } },
+        { "Loops", { 17 } },
+        { "Loops", { 100 } },
+        { "Nested", { 6 } },
+    });
+}
+
+TEST(Optimizer, Memory) {
+
+    char const *inpl = "\
+        struct Point                                \n\
+        {                                           \n\
+            int X;                                  \n\
+            short Y;                                \n\
+            char Tag;                               \n\
+        };                                          \n\
+        Point Points[5];                            \n\
+        int Grid[4];                                \n\
+        short Small = -3;                           \n\
+        char Letter = 'a';                          \n\
+        int Fill(int n)                             \n\
+        {                                           \n\
+            for (int i = 0; i < 5; i++)             \n\
+            {                                       \n\
+                Points[i].X = i * n;                \n\
+                Points[i].Y = Points[i].X - 100;    \n\
+                Points[i].Tag = Letter + i;         \n\
+            }                                       \n\
+            Point p;                                \n\
+            p.X = Points[3].X;                      \n\
+            p.Y = Small * 2;                        \n\
+            int local[3];                           \n\
+            local[0] = p.X;                         \n\
+            local[1] = local[0] + p.Y;              \n\
+            local[2] = local[1] * local[0];         \n\
+            Grid[n % 4] = local[2];                 \n\
+            Grid[(n + 1) % 4] = Grid[n % 4] + 1;    \n\
+            Small++;                                \n\
+            Letter = Letter + 1;                    \n\
+            return local[2] + Points[4].Tag;        \n\
+        }                                           \n\
+        int Choose(int n)                           \n\
+        {                                           \n\
+            switch (n)                              \n\
+            {                                       \n\
+            case 1: return 10;                      \n\
+            case 2:                                 \n\
+            case 3: n *= 2;                         \n\
+            default: n += Grid[0];                  \n\
+            }                                       \n\
+            return n;                               \n\
+        }                                           \n\
+        ";
+
+    CompareOptimizedRuns(inpl, {
+        { "Fill", { 7 } },
+        { "Fill", { 12 } },
+        { "Choose", { 1 } },
+        { "Choose", { 3 } },
+        { "Choose", { 5 } },
+    });
+}
+
+TEST(Optimizer, LineNumbers) {
+
+    // The 'linenum' directives must stay in the same order,
+    // with the same code running in between
+
+    char const *inpl = "\
+        int Loop(int n)                             \n\
+        {                                           \n\
+            int total = 0;                          \n\
+            while (total < n)                       \n\
+            {                                       \n\
+                if (total == 3)                     \n\
+                    total += 2;                     \n\
+                else                                \n\
+                    total++;                        \n\
+            }                                       \n\
+            return total * 2 + n;                   \n\
+        }                                           \n\
+        ";
+
+    CompareOptimizedRuns(inpl, { { "Loop", { 10 } } }, true);
+
+    AGS::ccCompiledScript plain_scrip(true), optimized_scrip(true);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL, plain_scrip);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL | SCOPT_OPTIMIZE, optimized_scrip);
+    ASSERT_FALSE(::testing::Test::HasFatalFailure());
+
+    auto const line_numbers = [](AGS::ccCompiledScript const &scrip)
+    {
+        std::vector<int32_t> lines;
+        for (auto const loc : Instructions(scrip))
+            if (SCMD_LINENUM == scrip.code[loc])
+                lines.push_back(scrip.code[loc + 1]);
+        return lines;
+    };
+    EXPECT_EQ(line_numbers(plain_scrip), line_numbers(optimized_scrip));
+}
+
+TEST(Optimizer, Fixups) {
+
+    // Fixups must still point to the arguments of instructions;
+    // function addresses and exports must point to the start of functions
+
+    char const *inpl = "\
+        int Glob[3];                                \n\
+        int Square(int a)                           \n\
+        {                                           \n\
+            Glob[1] = a * a;                        \n\
+            return Glob[1];                         \n\
+        }                                           \n\
+        int Use(int a)                              \n\
+        {                                           \n\
+            Glob[0] = Square(a) + Square(a + 1);    \n\
+            Glob[2] = Glob[0];                      \n\
+            return Glob[2] + Glob[1];               \n\
+        }                                           \n\
+        ";
+
+    AGS::ccCompiledScript scrip(false);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL | SCOPT_OPTIMIZE, scrip);
+    ASSERT_FALSE(::testing::Test::HasFatalFailure());
+
+    auto const instrs = Instructions(scrip);
+    auto const is_instruction = [&instrs](int32_t const loc)
+    {
+        return std::find(instrs.cbegin(), instrs.cend(), static_cast<size_t>(loc)) != instrs.cend();
+    };
+    ASSERT_LT(0u, scrip.fixups.size());
+    for (size_t fixup_idx = 0u; fixup_idx < scrip.fixups.size(); fixup_idx++)
+    {
+        int32_t const loc = scrip.fixups[fixup_idx];
+        ASSERT_GE(loc, 1);
+        ASSERT_LT(loc, static_cast<int32_t>(scrip.code.size()));
+        EXPECT_FALSE(is_instruction(loc)) << "Fixup #" << fixup_idx;
+        if (FIXUP_FUNCTION == scrip.fixuptypes[fixup_idx])
+        {
+            EXPECT_TRUE(is_instruction(scrip.code[loc]));
+            EXPECT_EQ(SCMD_THISBASE, scrip.code[scrip.code[loc]]);
+        }
+    }
+    for (auto const addr : scrip.export_addr)
+        EXPECT_EQ(SCMD_THISBASE, scrip.code[addr & 0x00ffffff]);
+    for (auto const &func : scrip.Functions)
+    {
+        EXPECT_EQ(SCMD_THISBASE, scrip.code[func.CodeOffs]);
+        EXPECT_EQ(func.CodeOffs, scrip.code[func.CodeOffs + 1]);
+    }
+
+    CompareOptimizedRuns(inpl, { { "Use", { 4 } }, { "Square", { -3 } } });
+}
+
+TEST(Optimizer, PushPop) {
+
+    // Operands that are computed without needing 'bx' don't need the stack any more
+
+    char const *inpl = "\
+        int Expr(int a, int b, int c)               \n\
+        {                                           \n\
+            return (a + b) * c - a;                 \n\
+        }                                           \n\
+        ";
+
+    AGS::ccCompiledScript plain_scrip(false), optimized_scrip(false);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL, plain_scrip);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL | SCOPT_OPTIMIZE, optimized_scrip);
+    ASSERT_FALSE(::testing::Test::HasFatalFailure());
+
+    EXPECT_LT(0u, CountOpcode(plain_scrip, SCMD_PUSHREG));
+    EXPECT_LT(0u, CountOpcode(plain_scrip, SCMD_POPREG));
+    EXPECT_EQ(0u, CountOpcode(optimized_scrip, SCMD_PUSHREG));
+    EXPECT_EQ(0u, CountOpcode(optimized_scrip, SCMD_POPREG));
+
+    CompareOptimizedRuns(inpl, { { "Expr", { 3, 5, 7 } }, { "Expr", { -2, 0, 9 } } });
+}
+
+TEST(Optimizer, JumpToJump) {
+
+    // No forward jump may land on a forward 'jmp'
+
+    char const *inpl = "\
+        int Classify(int a, int b)                  \n\
+        {                                           \n\
+            int res;                                \n\
+            if (a > 0)                              \n\
+            {                                       \n\
+                if (b > 0)                          \n\
+                    res = 1;                        \n\
+                else                                \n\
+                    res = 2;                        \n\
+            }                                       \n\
+            else                                    \n\
+            {                                       \n\
+                if (b > 0)                          \n\
+                    res = 3;                        \n\
+                else                                \n\
+                    res = 4;                        \n\
+            }                                       \n\
+            return res;                             \n\
+        }                                           \n\
+        ";
+
+    auto const count_jumps_to_jumps = [](AGS::ccCompiledScript const &scrip)
+    {
+        size_t count = 0u;
+        for (auto const loc : Instructions(scrip))
+        {
+            int32_t const op = scrip.code[loc];
+            if (SCMD_JMP != op && SCMD_JZ != op && SCMD_JNZ != op)
+                continue;
+            int32_t const offset = scrip.code[loc + 1];
+            int32_t const dest = static_cast<int32_t>(loc) + 2 + offset;
+            if (offset >= 0 && SCMD_JMP == scrip.code[dest] && scrip.code[dest + 1] >= 0)
+                count++;
+        }
+        return count;
+    };
+
+    AGS::ccCompiledScript plain_scrip(false), optimized_scrip(false);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL, plain_scrip);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL | SCOPT_OPTIMIZE, optimized_scrip);
+    ASSERT_FALSE(::testing::Test::HasFatalFailure());
+
+    EXPECT_LT(0u, count_jumps_to_jumps(plain_scrip));
+    EXPECT_EQ(0u, count_jumps_to_jumps(optimized_scrip));
+
+    CompareOptimizedRuns(inpl, {
+        { "Classify", { 1, 1 } },
+        { "Classify", { 1, -1 } },
+        { "Classify", { -1, 1 } },
+        { "Classify", { -1, -1 } },
+    });
+}
+
+TEST(Optimizer, BackwardJumps) {
+
+    // The engine only checks backward 'jmp' for endless loops,
+    // so loops must keep their backward 'jmp'
+
+    char const *inpl = "\
+        int Spin(int n)                             \n\
+        {                                           \n\
+            while (n > 0)                           \n\
+            {                                       \n\
+                n--;                                \n\
+                if (n == 5)                         \n\
+                    continue;                       \n\
+            }                                       \n\
+            return n;                               \n\
+        }                                           \n\
+        ";
+
+    auto const count_backward = [](AGS::ccCompiledScript const &scrip, int32_t const jump_op)
+    {
+        size_t count = 0u;
+        for (auto const loc : Instructions(scrip))
+            count += (jump_op == scrip.code[loc] && scrip.code[loc + 1] < 0);
+        return count;
+    };
+
+    AGS::ccCompiledScript plain_scrip(false), optimized_scrip(false);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL, plain_scrip);
+    CompileForOptimizer(inpl, SCOPT_EXPORTALL | SCOPT_OPTIMIZE, optimized_scrip);
+    ASSERT_FALSE(::testing::Test::HasFatalFailure());
+
+    EXPECT_EQ(0u, count_backward(optimized_scrip, SCMD_JZ));
+    EXPECT_EQ(0u, count_backward(optimized_scrip, SCMD_JNZ));
+    EXPECT_LE(1u, count_backward(optimized_scrip, SCMD_JMP));
+
+    CompareOptimizedRuns(inpl, { { "Spin", { 12 } } });
+}
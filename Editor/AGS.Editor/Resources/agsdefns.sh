@@ -602,6 +602,25 @@ internalstring autoptr builtin managed struct String {
   readonly import attribute int Length;
 };
 
+#ifdef SCRIPT_API_v400
+builtin managed struct StringBuilder {
+  /// Creates a new empty StringBuilder, optionally reserving memory for the given number of bytes.
+  import static StringBuilder* Create(int capacity = 0); // $AUTOCOMPLETESTATICONLY$
+  /// Appends a string to the end of the accumulated text.
+  import void    Append(const string appendText);
+  /// Appends a character to the end of the accumulated text.
+  import void    AppendChar(int extraChar);
+  /// Appends a formatted string to the end of the accumulated text.
+  import void    AppendFormat(const string format, ...);
+  /// Removes all the accumulated text.
+  import void    Clear();
+  /// Creates a new String from the accumulated text.
+  import String  ToString();
+  /// Returns the length of the accumulated text.
+  readonly import attribute int Length;
+};
+#endif
+
 #ifdef SCRIPT_API_v350
 builtin managed struct Dictionary
 {
@@ -629,6 +648,12 @@ builtin managed struct Dictionary
   import String[] GetKeysAsArray();
   /// Creates a dynamic array filled with values in same order as they are stored in the Dictionary.
   import String[] GetValuesAsArray();
+#ifdef SCRIPT_API_v400
+  /// Reserves memory for the given number of key/value pairs; only has effect on unsorted dictionaries.
+  import void Reserve(int capacity);
+  /// Gets the number of key/value pairs that the dictionary may hold without reallocating memory.
+  import readonly attribute int Capacity;
+#endif
 };
 
 builtin managed struct Set
@@ -653,6 +678,12 @@ builtin managed struct Set
   import readonly attribute int ItemCount;
   /// Creates a dynamic array filled with items in same order as they are stored in the Set.
   import String[] GetItemsAsArray();
+#ifdef SCRIPT_API_v400
+  /// Reserves memory for the given number of items; only has effect on unsorted sets.
+  import void Reserve(int capacity);
+  /// Gets the number of items that the set may hold without reallocating memory.
+  import readonly attribute int Capacity;
+#endif
 };
 #endif
 
@@ -1038,6 +1069,14 @@ builtin managed struct File {
 #ifdef SCRIPT_API_v399
   /// Renames an existing file; if there's already a file with the new name then it will be overwritten
   import static bool Rename(const string old_filename, const string new_filename);   // $AUTOCOMPLETESTATICONLY$
+#endif
+#ifdef SCRIPT_API_v400
+  /// Reads all the remaining contents of the file, starting from the current position, and returns them as a String.
+  import String ReadAllText();
+  /// Reads up to the given number of bytes from the file, and returns them in a new array; returns null if nothing was read.
+  import char[] ReadBytes(int count);
+  /// Writes the contents of the array to the file; optionally limits the number of written bytes. Returns the number of bytes written.
+  import int  WriteBytes(char[], int count = -1);
 #endif
   int reserved[2];   // $AUTOCOMPLETEIGNORE$
 };
@@ -103,7 +103,7 @@ void GUIObject::MarkStateChanged(bool, bool)
 int GUILabel::PrepareTextToDraw()
 {
     _textToDraw = Text;
-    return GUI::SplitLinesForDrawing(_textToDraw.GetCStr(), false, Lines, Font, _width);
+    return GUI::SplitLinesForDrawing(_textToDraw.GetCStr(), false, _lines, Font, _width);
 }
 
 void GUITextBox::DrawTextBoxContents(Bitmap *ds, int x, int y, color_t text_color)
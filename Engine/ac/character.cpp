@@ -108,6 +108,11 @@ const char *text_lips_text = nullptr;
 std::vector<SpeechLipSyncLine> splipsync;
 int numLipLines = 0, curLipLine = -1, curLipLinePhoneme = 0;
 
+// Characters which require per-frame update
+std::vector<int> active_chars;
+bool active_chars_valid = false;
+int active_chars_room = -1;
+
 // **** CHARACTER: FUNCTIONS ****
 
 bool is_valid_character(int char_id)
@@ -262,6 +267,7 @@ void Character_ChangeRoomSetLoop(CharacterInfo *chaa, int room, int x, int y, in
         }
         chaa->prevroom = chaa->room;
         chaa->room = room;
+        invalidate_active_characters();
 
 		debug_script_log("%s moved to room %d, location %d,%d, loop %d",
 			chaa->scrname.GetCStr(), room, chaa->x, chaa->y, chaa->loop);
@@ -525,6 +531,7 @@ void Character_FollowCharacter(CharacterInfo *chaa, CharacterInfo *tofollow, int
         chaa->following = -1;
     else
         chaa->following = tofollow->index_id;
+    invalidate_active_characters();
 
     chaa->followinfo=(distaway << 8) | eagerness;
 
@@ -955,6 +962,7 @@ void Character_SetSpeed(CharacterInfo *chaa, int xspeed, int yspeed) {
 void Character_StopMoving(CharacterInfo *charp) {
 
     int chaa = charp->index_id;
+    charextra[chaa].path_request = 0u; // cancel pending route
     if (chaa == play.skip_until_char_stops)
         EndSkippingUntilCharStops();
 
@@ -1955,6 +1963,9 @@ void start_character_turning (CharacterInfo *chinf, int useloop, int no_diagonal
         go_anticlock = 1;
     // strip any current turning_around stages
     chinf->walking = chinf->walking % TURNING_AROUND;
+    // turning is updated regardless of the room the character is in
+    if (chinf->room != displayed_room)
+        invalidate_active_characters();
     if (go_anticlock)
         chinf->walking += TURNING_BACKWARDS;
     else
@@ -2189,6 +2200,44 @@ void move_character(CharacterInfo *chaa, const std::vector<Point> &path, bool wa
     move_character_impl(chaa, &path, 0, 0, true /* ignore walls */, walk_anim, run_params);
 }
 
+void move_character_async(CharacterInfo *chaa, int tox, int toy, bool walk_anim)
+{
+    const int chac = chaa->index_id;
+    if (charextra[chac].path_request != 0u)
+        return; // previous request is still pending
+
+    MaskRouteFinder *pathfind = get_room_pathfinder();
+    pathfind->SetWalkableArea(prepare_walkable_areas(chac), thisroom.MaskResolution);
+    // Remember where the search starts, the character may be moved or
+    // change rooms while the route is being searched for
+    const int srcx = chaa->x, srcy = chaa->y;
+    const int src_room = displayed_room;
+    charextra[chac].path_request = pathfind->FindRouteAsync(srcx, srcy, tox, toy, false, false,
+        [chac, srcx, srcy, src_room, tox, toy, walk_anim](uint32_t request_id, bool found, const std::vector<Point> &path)
+        {
+            if (charextra[chac].path_request != request_id)
+                return; // cancelled or superseded
+            charextra[chac].path_request = 0u;
+            CharacterInfo *chi = &game.chars[chac];
+            // The character could have been changed since the request was made
+            if (!chi->is_enabled() || (src_room != displayed_room) || (chi->room != displayed_room) || (chi->walking > 0))
+                return;
+            // If the character was moved meanwhile, then the found route does
+            // not start at its position anymore; search again from the new one
+            if ((chi->x != srcx) || (chi->y != srcy))
+            {
+                move_character_async(chi, tox, toy, walk_anim);
+                return;
+            }
+            if (!found)
+                return;
+            // Path starts at the mask-aligned position, begin at the exact one instead
+            std::vector<Point> char_path = path;
+            char_path.front() = Point(srcx, srcy);
+            move_character_impl(chi, &char_path, 0, 0, false /* walls */, walk_anim, RunPathParams());
+        });
+}
+
 void move_character_straight(CharacterInfo *chaa, int x, int y, bool walk_anim)
 {
     MaskRouteFinder *pathfind = get_room_pathfinder();
@@ -3113,6 +3162,34 @@ void restore_characters()
         charextra[i].zoom_offs = (game.options[OPT_SCALECHAROFFSETS] != 0) ?
             charextra[i].zoom : 100;
     }
+    invalidate_active_characters();
+}
+
+void invalidate_active_characters()
+{
+    active_chars_valid = false;
+}
+
+const std::vector<int> &get_active_characters()
+{
+    if (active_chars_valid && (active_chars_room == displayed_room))
+        return active_chars;
+
+    active_chars.clear();
+    for (int i = 0; i < game.numcharacters; ++i)
+    {
+        const CharacterInfo &chi = game.chars[i];
+        // NOTE: disabled characters are included too, as they may be
+        // enabled again at any time; the update checks that on its own
+        if ((chi.room == displayed_room) || (chi.following >= 0) ||
+            (chi.walking >= TURNING_AROUND))
+            active_chars.push_back(i);
+        else
+            charextra[i].process_idle_this_time = 0;
+    }
+    active_chars_valid = true;
+    active_chars_room = displayed_room;
+    return active_chars;
 }
 
 Rect GetCharacterRoomBBox(int charid, bool use_frame_0)
@@ -190,6 +190,9 @@ void find_nearest_walkable_area (int *xx, int *yy);
 void move_character(CharacterInfo *chaa, int tox, int toy, bool ignwal, bool walk_anim);
 // Start character walk or move, using a predefined path
 void move_character(CharacterInfo *chaa, const std::vector<Point> &path, bool walk_anim, const RunPathParams &run_params);
+// Start character walk, calculating path on a background thread;
+// the character starts moving on one of the next frames, when the route is found
+void move_character_async(CharacterInfo *chaa, int tox, int toy, bool walk_anim);
 // Start character walk or move along the straight line without pathfinding, until any non-passable area is met
 void move_character_straight(CharacterInfo *chaa, int x, int y, bool walk_anim);
 void FindReasonableLoopForCharacter(CharacterInfo *chap);
@@ -219,6 +222,14 @@ int update_lip_sync(int talkview, int talkloop, int *talkframeptr);
 
 // Recalculate dynamic character properties, e.g. after restoring a game save
 void restore_characters();
+// Marks the list of actively updated characters as outdated; this must be
+// called whenever a character changes room, starts or stops following
+// another character, or starts turning around.
+void invalidate_active_characters();
+// Gets the list of characters which may require per-frame update: these are
+// characters in the current room, followers, and characters turning around.
+// Other characters cannot move or animate, and are skipped by the game update.
+const std::vector<int> &get_active_characters();
 
 // Calculates character's bounding box in room coordinates (takes only in-room transform into account)
 // use_frame_0 optionally tells to use frame 0 of current loop instead of current frame.
@@ -71,6 +71,8 @@ struct CharacterExtras
     //
     // zoom factor of sprite offsets, fixed at 100 in backwards compatible mode
     int   zoom_offs = 100;
+    // pending asynchronous route request, 0 = none
+    uint32_t path_request = 0u;
 
     int GetEffectiveY(CharacterInfo *chi) const; // return Y - Z
 
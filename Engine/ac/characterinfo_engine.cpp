@@ -418,8 +418,8 @@ void CharacterInfo::update_character_follower(int &aa, std::vector<int> &followi
         // make sure he's not standing on top of the other man
         if (goxoffs < 0) goxoffs-=distaway;
         else goxoffs+=distaway;
-        move_character(&game.chars[aa], game.chars[following].x + goxoffs,
-          game.chars[following].y + (Random(50)-25), false /* ignwall */, true /* walk anim */);
+        move_character_async(&game.chars[aa], game.chars[following].x + goxoffs,
+          game.chars[following].y + (Random(50)-25), true /* walk anim */);
         doing_nothing = 0;
       }
     }
@@ -2388,10 +2388,15 @@ void dispose_engine_overlay()
 void draw_fps(const Rect &viewport)
 {
     const int font = FONT_NORMAL;
+    // texture upload stats are only gathered by the hardware-accelerated drivers,
+    // and are displayed on an extra line above the fps and the loop counter
+    const bool show_upload_stats = gfxDriver->HasAcceleratedTransform();
+    const int line_height = get_font_surface_height(font) + 5;
+    const int panel_height = line_height * (show_upload_stats ? 2 : 1);
     auto &fpsDisplay = gl_DrawFPS.bmp;
-    if (fpsDisplay == nullptr || gl_DrawFPS.font != font)
+    if (fpsDisplay == nullptr || gl_DrawFPS.font != font || fpsDisplay->GetHeight() != panel_height)
     {
-        recycle_bitmap(fpsDisplay, game.GetColorDepth(), viewport.GetWidth(), (get_font_surface_height(font) + 5));
+        recycle_bitmap(fpsDisplay, game.GetColorDepth(), viewport.GetWidth(), panel_height);
         gl_DrawFPS.font = font;
     }
 
@@ -2416,8 +2421,17 @@ void draw_fps(const Rect &viewport)
     snprintf(loop_buffer, sizeof(loop_buffer), "Loop %u", loopcounter);
 
     int text_off = get_font_surface_extent(font).first; // TODO: a generic function that accounts for this?
-    wouttext_outline(fpsDisplay.get(), 1, 1 - text_off, font, text_color, fps_buffer);
-    wouttext_outline(fpsDisplay.get(), viewport.GetWidth() / 2, 1 - text_off, font, text_color, loop_buffer);
+    if (show_upload_stats)
+    {
+        const TextureUploadStats upload_stats = gfxDriver->GetTextureUploadStats();
+        char upload_buffer[80];
+        snprintf(upload_buffer, sizeof(upload_buffer), "Tex uploads: %u, %u KB, %.2f ms",
+            upload_stats.Count, static_cast<uint32_t>(upload_stats.Bytes / 1024), upload_stats.StallUs / 1000.0);
+        wouttext_outline(fpsDisplay.get(), 1, 1 - text_off, font, text_color, upload_buffer);
+    }
+    const int fps_line_y = panel_height - line_height;
+    wouttext_outline(fpsDisplay.get(), 1, fps_line_y + 1 - text_off, font, text_color, fps_buffer);
+    wouttext_outline(fpsDisplay.get(), viewport.GetWidth() / 2, fps_line_y + 1 - text_off, font, text_color, loop_buffer);
 
     gl_DrawFPS.ddb = recycle_ddb_bitmap(gl_DrawFPS.ddb, gl_DrawFPS.bmp.get());
     int yp = viewport.GetHeight() - fpsDisplay->GetHeight();
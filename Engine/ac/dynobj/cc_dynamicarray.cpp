@@ -16,6 +16,7 @@
 #include "ac/dynobj/managedobjectpool.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "script/cc_instance.h"
+#include "script/cc_reflecthelper.h"
 #include "script/cc_script.h" // RTTI
 #include "util/memorystream.h"
 #include "ac/dynobj/scriptstring.h"
@@ -66,6 +67,7 @@ void CCDynamicArray::Unserialize(int index, Stream *in, size_t data_sz)
     hdr.TypeID = in->ReadInt32();
     hdr.ElemCount = in->ReadInt32();
     hdr.TotalSize = hdr.ElemCount * in->ReadInt32(); // elem size
+    hdr.ElemType = nullptr; // will be resolved when necessary
     in->Read(new_arr + MemHeaderSz, data_sz - FileHeaderSz);
     ccRegisterUnserializedObject(index, &new_arr[MemHeaderSz], this);
 }
@@ -83,6 +85,7 @@ void CCDynamicArray::Unserialize(int index, Stream *in, size_t data_sz)
     hdr.TypeID = type_id | (ARRAY_MANAGED_TYPE_FLAG * is_managed);
     hdr.ElemCount = elem_count;
     hdr.TotalSize = elem_count * elem_size;
+    hdr.ElemType = (type_id > 0) ? ccInstance::GetRTTIHelper()->GetRuntimeType(type_id) : nullptr;
     void *obj_ptr = &new_arr[MemHeaderSz];
     int32_t handle = ccRegisterManagedObject(obj_ptr, &globalDynamicArray);
     if (handle == 0)
@@ -102,50 +105,47 @@ void CCDynamicArray::RemapTypeids(void *address,
     const auto it = typeid_map.find(type_id);
     assert(type_id == 0u || it != typeid_map.end());
     hdr.TypeID = ((it != typeid_map.end()) ? it->second : 0u) | (ARRAY_MANAGED_TYPE_FLAG * is_managed);
+    hdr.ElemType = nullptr; // will be resolved when necessary
 }
 
 void CCDynamicArray::TraverseRefs(void *address, PfnTraverseRefOp traverse_op)
 {
-    // TODO: may be a bit faster if we make a "runtime type"
-    // struct, merging joint type info and auxiliary helper data,
-    // and store a pointer in the arr data.
-    // might also have a dummy "type" for "unknown type" arrays.
     const Header &hdr = GetHeader(address);
-    const uint32_t type_id = hdr.TypeID & (~ARRAY_MANAGED_TYPE_FLAG);
-    bool is_managed = (hdr.TypeID & ARRAY_MANAGED_TYPE_FLAG) != 0;
-    const RTTI::Type *ti = nullptr;
-    if (type_id > 0)
-    {
-        assert(ccInstance::GetRTTI()->GetTypes().size() > type_id);
-        ti = &ccInstance::GetRTTI()->GetTypes()[type_id];
-    }
 
     // Dynamic array of managed pointers: subref them directly
-    if (is_managed)
+    if (hdr.IsPointerArray())
     {
         const uint32_t *handles = reinterpret_cast<const uint32_t*>(address);
         for (uint32_t i = 0; i < hdr.ElemCount; ++i)
         {
             traverse_op(handles[i]);
         }
+        return;
+    }
+
+    // Dynamic array of regular structs that *may* contain managed pointers;
+    // the runtime type is resolved on the first use, because restored objects
+    // may get their type registered later (e.g. along with the room script)
+    const uint32_t type_id = hdr.TypeID & (~ARRAY_MANAGED_TYPE_FLAG);
+    if (!hdr.ElemType && (type_id > 0))
+    {
+        assert(ccInstance::GetRTTI()->GetTypes().size() > type_id);
+        hdr.ElemType = ccInstance::GetRTTIHelper()->GetRuntimeType(type_id);
     }
-    // Dynamic array of regular structs that *may* contain managed pointers
-    else if (ti && (ti->flags & RTTI::kType_Struct))
+    if (!hdr.ElemType || !hdr.ElemType->has_refs)
+        return; // no managed pointers inside
+
+    const uint32_t *offs_begin = hdr.ElemType->managed_offsets.data();
+    const uint32_t *offs_end = offs_begin + hdr.ElemType->managed_offsets.size();
+    const uint8_t *elem_ptr = static_cast<const uint8_t*>(address);
+    // For each array element...
+    const uint32_t el_size = hdr.TotalSize / hdr.ElemCount;
+    for (uint32_t i = 0; i < hdr.ElemCount; ++i, elem_ptr += el_size)
     {
-        const auto fref = ccInstance::GetRTTIHelper()->GetManagedOffsetsForType(type_id);
-        if (fref.second > fref.first)
-        { // there are managed pointers inside!
-            const uint8_t *elem_ptr = static_cast<const uint8_t*>(address);
-            // For each array element...
-            const uint32_t el_size = hdr.TotalSize / hdr.ElemCount;
-            for (uint32_t i = 0; i < hdr.ElemCount; ++i, elem_ptr += el_size)
-            {
-                // ..subref each managed pointer found inside
-                for (auto it = fref.first; it < fref.second; ++it)
-                {
-                    traverse_op(*(int32_t*)(elem_ptr + *it));
-                }
-            }
+        // ..subref each managed pointer found inside
+        for (const uint32_t *off = offs_begin; off < offs_end; ++off)
+        {
+            traverse_op(*(const int32_t*)(elem_ptr + *off));
         }
     }
 }
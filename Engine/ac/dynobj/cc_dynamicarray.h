@@ -22,6 +22,8 @@
 
 #define ARRAY_MANAGED_TYPE_FLAG    0x80000000
 
+namespace AGS { namespace Engine { struct RuntimeType; } }
+
 struct CCDynamicArray final : AGSCCDynamicObject
 {
 public:
@@ -35,6 +37,9 @@ public:
         uint32_t ElemCount = 0u;
         // TODO: refactor and store "elem size" instead
         uint32_t TotalSize = 0u;
+        // Runtime type of elements, resolved from TypeID on first use;
+        // this is not serialized, and reset whenever TypeID changes
+        mutable const AGS::Engine::RuntimeType *ElemType = nullptr;
 
         inline bool IsPointerArray() const { return (TypeID & ARRAY_MANAGED_TYPE_FLAG) != 0; }
     };
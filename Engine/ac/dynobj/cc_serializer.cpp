@@ -21,6 +21,7 @@
 #include "ac/dynobj/scriptcamera.h"
 #include "ac/dynobj/scriptcontainers.h"
 #include "ac/dynobj/scriptfile.h"
+#include "ac/dynobj/scriptstringbuilder.h"
 #include "ac/dynobj/scriptviewport.h"
 #include "ac/game.h"
 #include "debug/debug_log.h"
@@ -110,6 +111,10 @@ void AGSDeSerializer::Unserialize(int index, const char *objectType, const char
     else if (strcmp(objectType, "String") == 0) {
         myScriptStringImpl.Unserialize(index, &mems, data_sz);
     }
+    else if (strcmp(objectType, "StringBuilder") == 0) {
+        ScriptStringBuilder *sb = new ScriptStringBuilder();
+        sb->Unserialize(index, &mems, data_sz);
+    }
     else if (strcmp(objectType, "File") == 0) {
         // files cannot be restored properly -- so just recreate
         // the object; attempting any operations on it will fail
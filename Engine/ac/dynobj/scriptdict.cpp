@@ -38,10 +38,10 @@ void ScriptDictBase::Serialize(const void* /*address*/, Stream *out)
     SerializeContainer(out);
 }
 
-void ScriptDictBase::Unserialize(int index, Stream *in, size_t /*data_sz*/)
+void ScriptDictBase::Unserialize(int index, Stream *in, size_t data_sz)
 {
     // NOTE: we expect sorted/case flags are read by external reader;
     // this is awkward, but I did not find better design solution atm
-    UnserializeContainer(in);
+    UnserializeContainer(in, data_sz);
     ccRegisterUnserializedObject(index, this, this);
 }
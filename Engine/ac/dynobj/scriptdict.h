@@ -13,7 +13,7 @@
 //=============================================================================
 //
 // Managed script object wrapping std::map<String, String> and
-// unordered_map<String, String>.
+// OpenHashMap<String, String>.
 //
 // TODO: support wrapping non-owned Dictionary, passed by the reference, -
 // that would let expose internal engine's dicts using same interface.
@@ -25,10 +25,11 @@
 #ifndef __AC_SCRIPTDICT_H
 #define __AC_SCRIPTDICT_H
 
+#include <algorithm>
 #include <map>
-#include <unordered_map>
 #include <string.h>
 #include "ac/dynobj/cc_agsdynamicobject.h"
+#include "util/openhashmap.h"
 #include "util/stream.h"
 #include "util/string.h"
 #include "util/string_types.h"
@@ -51,6 +52,10 @@ public:
     virtual bool Remove(const char *key) = 0;
     virtual bool Set(const char *key, const char *value) = 0;
     virtual int GetItemCount() = 0;
+    // Reserves space for the given number of items; only has effect on unsorted dicts
+    virtual void Reserve(size_t item_count) = 0;
+    // Gets number of items that may be stored without reallocation
+    virtual int GetCapacity() const = 0;
     virtual void GetKeys(std::vector<const char*> &buf) const = 0;
     virtual void GetValues(std::vector<const char*> &buf) const = 0;
 
@@ -63,7 +68,8 @@ protected:
 private:
     virtual size_t CalcContainerSize() = 0;
     virtual void SerializeContainer(AGS::Common::Stream *out) = 0;
-    virtual void UnserializeContainer(AGS::Common::Stream *in) = 0;
+    // Reads container items; data_sz is the size of the container data in stream
+    virtual void UnserializeContainer(AGS::Common::Stream *in, size_t data_sz) = 0;
 };
 
 template <typename TDict, bool is_sorted, bool is_casesensitive>
@@ -109,6 +115,8 @@ public:
         return TryAddItem(String(key), String(value));
     }
     int GetItemCount() override { return _dic.size(); }
+    void Reserve(size_t item_count) override { ReserveImpl(_dic, item_count); }
+    int GetCapacity() const override { return CapacityImpl(_dic); }
     void GetKeys(std::vector<const char*> &buf) const override
     {
         for (auto it = _dic.begin(); it != _dic.end(); ++it)
@@ -128,6 +136,18 @@ private:
     }
     void DeleteItem(ConstIterator /*it*/) { /* do nothing */ }
 
+    // Sorted dicts allocate a node per item, and cannot preallocate
+    template <typename TMap>
+    static void ReserveImpl(TMap &/*dic*/, size_t /*item_count*/) { /* do nothing */ }
+    template <typename TMap>
+    static int CapacityImpl(const TMap &dic) { return dic.size(); }
+    template <typename THash, typename TEqual>
+    static void ReserveImpl(OpenHashMap<String, String, THash, TEqual> &dic, size_t item_count)
+        { dic.reserve(item_count); }
+    template <typename THash, typename TEqual>
+    static int CapacityImpl(const OpenHashMap<String, String, THash, TEqual> &dic)
+        { return dic.capacity(); }
+
     size_t CalcContainerSize() override
     {
         // 2 class properties + item count
@@ -153,9 +173,15 @@ private:
         }
     }
 
-    void UnserializeContainer(AGS::Common::Stream *in) override
+    void UnserializeContainer(AGS::Common::Stream *in, size_t data_sz) override
     {
-        size_t item_count = in->ReadInt32();
+        if (data_sz < sizeof(int32_t))
+            return;
+        size_t item_count = static_cast<uint32_t>(in->ReadInt32());
+        // Each item takes at least its key and value lengths, don't trust
+        // a stored count that cannot fit into the remaining data
+        item_count = std::min(item_count, (data_sz - sizeof(int32_t)) / (sizeof(int32_t) * 2));
+        ReserveImpl(_dic, item_count);
         for (size_t i = 0; i < item_count; ++i)
         {
             size_t key_len = in->ReadInt32();
@@ -174,7 +200,7 @@ private:
 
 typedef ScriptDictImpl< std::map<String, String>, true, true > ScriptDict;
 typedef ScriptDictImpl< std::map<String, String, StrLessNoCase>, true, false > ScriptDictCI;
-typedef ScriptDictImpl< std::unordered_map<String, String>, false, true > ScriptHashDict;
-typedef ScriptDictImpl< std::unordered_map<String, String, HashStrNoCase, StrEqNoCase>, false, false > ScriptHashDictCI;
+typedef ScriptDictImpl< OpenHashMap<String, String>, false, true > ScriptHashDict;
+typedef ScriptDictImpl< OpenHashMap<String, String, HashStrNoCase, StrEqNoCase>, false, false > ScriptHashDictCI;
 
 #endif // __AC_SCRIPTDICT_H
@@ -12,7 +12,7 @@
 //
 //=============================================================================
 //
-// Managed script object wrapping std::set<String> and unordered_set<String>.
+// Managed script object wrapping std::set<String> and OpenHashSet<String>.
 //
 // TODO: support wrapping non-owned Set, passed by the reference, -
 // that would let expose internal engine's sets using same interface.
@@ -24,10 +24,11 @@
 #ifndef __AC_SCRIPTSET_H
 #define __AC_SCRIPTSET_H
 
+#include <algorithm>
 #include <set>
-#include <unordered_set>
 #include <string.h>
 #include "ac/dynobj/cc_agsdynamicobject.h"
+#include "util/openhashmap.h"
 #include "util/stream.h"
 #include "util/string.h"
 #include "util/string_types.h"
@@ -49,6 +50,10 @@ public:
     virtual bool Contains(const char *item) const = 0;
     virtual bool Remove(const char *item) = 0;
     virtual int GetItemCount() const = 0;
+    // Reserves space for the given number of items; only has effect on unsorted sets
+    virtual void Reserve(size_t item_count) = 0;
+    // Gets number of items that may be stored without reallocation
+    virtual int GetCapacity() const = 0;
     virtual void GetItems(std::vector<const char*> &buf) const = 0;
 
 protected:
@@ -60,7 +65,8 @@ protected:
 private:
     virtual size_t CalcContainerSize() = 0;
     virtual void SerializeContainer(AGS::Common::Stream *out) = 0;
-    virtual void UnserializeContainer(AGS::Common::Stream *in) = 0;
+    // Reads container items; data_sz is the size of the container data in stream
+    virtual void UnserializeContainer(AGS::Common::Stream *in, size_t data_sz) = 0;
 };
 
 template <typename TSet, bool is_sorted, bool is_casesensitive>
@@ -95,6 +101,8 @@ public:
         return true;
     }
     int GetItemCount() const override { return _set.size(); }
+    void Reserve(size_t item_count) override { ReserveImpl(_set, item_count); }
+    int GetCapacity() const override { return CapacityImpl(_set); }
     void GetItems(std::vector<const char*> &buf) const override
     {
         for (auto it = _set.begin(); it != _set.end(); ++it)
@@ -108,6 +116,18 @@ private:
     }
     void DeleteItem(ConstIterator /*it*/) { /* do nothing */ }
 
+    // Sorted sets allocate a node per item, and cannot preallocate
+    template <typename TSetImpl>
+    static void ReserveImpl(TSetImpl &/*set*/, size_t /*item_count*/) { /* do nothing */ }
+    template <typename TSetImpl>
+    static int CapacityImpl(const TSetImpl &set) { return set.size(); }
+    template <typename THash, typename TEqual>
+    static void ReserveImpl(OpenHashSet<String, THash, TEqual> &set, size_t item_count)
+        { set.reserve(item_count); }
+    template <typename THash, typename TEqual>
+    static int CapacityImpl(const OpenHashSet<String, THash, TEqual> &set)
+        { return set.capacity(); }
+
     size_t CalcContainerSize() override
     {
         // 2 class properties + item count
@@ -128,9 +148,15 @@ private:
         }
     }
 
-    void UnserializeContainer(AGS::Common::Stream *in) override
+    void UnserializeContainer(AGS::Common::Stream *in, size_t data_sz) override
     {
-        size_t item_count = in->ReadInt32();
+        if (data_sz < sizeof(int32_t))
+            return;
+        size_t item_count = static_cast<uint32_t>(in->ReadInt32());
+        // Each item takes at least its length, don't trust a stored count
+        // that cannot fit into the remaining data
+        item_count = std::min(item_count, (data_sz - sizeof(int32_t)) / sizeof(int32_t));
+        ReserveImpl(_set, item_count);
         for (size_t i = 0; i < item_count; ++i)
         {
             size_t len = in->ReadInt32();
@@ -144,7 +170,7 @@ private:
 
 typedef ScriptSetImpl< std::set<String>, true, true > ScriptSet;
 typedef ScriptSetImpl< std::set<String, StrLessNoCase>, true, false > ScriptSetCI;
-typedef ScriptSetImpl< std::unordered_set<String>, false, true > ScriptHashSet;
-typedef ScriptSetImpl< std::unordered_set<String, HashStrNoCase, StrEqNoCase>, false, false > ScriptHashSetCI;
+typedef ScriptSetImpl< OpenHashSet<String>, false, true > ScriptHashSet;
+typedef ScriptSetImpl< OpenHashSet<String, HashStrNoCase, StrEqNoCase>, false, false > ScriptHashSetCI;
 
 #endif // __AC_SCRIPTSET_H
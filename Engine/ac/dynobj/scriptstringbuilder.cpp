@@ -0,0 +1,88 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "ac/dynobj/scriptstringbuilder.h"
+#include <allegro.h>
+#include "ac/dynobj/dynobj_manager.h"
+#include "util/stream.h"
+
+using namespace AGS::Common;
+
+ScriptStringBuilder::ScriptStringBuilder(size_t capacity)
+{
+    _buf.reserve(capacity + 1);
+    _buf.push_back(0);
+}
+
+int ScriptStringBuilder::Dispose(void* /*address*/, bool /*force*/)
+{
+    delete this;
+    return 1;
+}
+
+const char *ScriptStringBuilder::GetType()
+{
+    return "StringBuilder";
+}
+
+void ScriptStringBuilder::Append(const char *text)
+{
+    int len, ulen;
+    ustrlen2(text, &len, &ulen);
+    if (len == 0)
+        return;
+    // insert before the terminating null; std::vector grows geometrically
+    _buf.insert(_buf.end() - 1, text, text + len);
+    _ulength += ulen;
+}
+
+void ScriptStringBuilder::AppendChar(int uchar)
+{
+    char chr[5]{};
+    size_t chw = usetc(chr, uchar);
+    _buf.insert(_buf.end() - 1, chr, chr + chw);
+    _ulength++;
+}
+
+void ScriptStringBuilder::Clear()
+{
+    _buf.resize(1);
+    _buf[0] = 0;
+    _ulength = 0u;
+}
+
+void ScriptStringBuilder::Reserve(size_t capacity)
+{
+    _buf.reserve(capacity + 1);
+}
+
+size_t ScriptStringBuilder::CalcSerializeSize(const void* /*address*/)
+{
+    return sizeof(int32_t) + GetLength();
+}
+
+void ScriptStringBuilder::Serialize(const void* /*address*/, Stream *out)
+{
+    out->WriteInt32(GetLength());
+    out->Write(_buf.data(), GetLength());
+}
+
+void ScriptStringBuilder::Unserialize(int index, Stream *in, size_t /*data_sz*/)
+{
+    size_t len = in->ReadInt32();
+    _buf.resize(len + 1);
+    in->Read(_buf.data(), len);
+    _buf[len] = 0;
+    _ulength = ustrlen(_buf.data());
+    ccRegisterUnserializedObject(index, this, this);
+}
@@ -0,0 +1,65 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Managed script object which accumulates text in a growing buffer.
+// Unlike String, which is immutable and has to be copied in whole on each
+// concatenation, StringBuilder appends with an amortized constant cost,
+// and only creates a new String when its contents are requested.
+//
+//=============================================================================
+#ifndef __AC_SCRIPTSTRINGBUILDER_H
+#define __AC_SCRIPTSTRINGBUILDER_H
+
+#include <vector>
+#include "ac/dynobj/cc_agsdynamicobject.h"
+
+struct ScriptStringBuilder final : AGSCCDynamicObject
+{
+public:
+    ScriptStringBuilder(size_t capacity = 0u);
+
+    int Dispose(void *address, bool force) override;
+    const char *GetType() override;
+    void Unserialize(int index, AGS::Common::Stream *in, size_t data_sz) override;
+
+    // Returns the text length in bytes
+    size_t GetLength() const { return _buf.size() - 1; }
+    // Returns the text length in characters
+    size_t GetULength() const { return _ulength; }
+    // Returns the accumulated text
+    const char *GetCStr() const { return _buf.data(); }
+
+    // Appends a null-terminated string
+    void Append(const char *text);
+    // Appends a single (Unicode) character
+    void AppendChar(int uchar);
+    // Removes all text, but keeps the allocated buffer
+    void Clear();
+    // Reserves space for at least the given number of bytes
+    void Reserve(size_t capacity);
+
+protected:
+    // Calculate and return required space for serialization, in bytes
+    size_t CalcSerializeSize(const void *address) override;
+    // Write object data into the provided stream
+    void Serialize(const void *address, AGS::Common::Stream *out) override;
+
+private:
+    // Text buffer, always null-terminated
+    std::vector<char> _buf;
+    // Text length in characters
+    size_t _ulength = 0u;
+};
+
+#endif // __AC_SCRIPTSTRINGBUILDER_H
@@ -16,6 +16,7 @@
 #include "ac/dynobj/dynobj_manager.h"
 #include "ac/dynobj/managedobjectpool.h"
 #include "ac/dynobj/cc_dynamicarray.h"
+#include "script/cc_reflecthelper.h"
 #include "script/cc_script.h"
 #include "script/cc_instance.h"
 #include "util/memorystream.h"
@@ -38,6 +39,7 @@ const char *ScriptUserObject::GetType()
     Header &hdr = reinterpret_cast<Header&>(*new_data);
     hdr.TypeId = type_id;
     hdr.Size = size;
+    hdr.Type = (type_id > 0) ? ccInstance::GetRTTIHelper()->GetRuntimeType(type_id) : nullptr;
     void *obj_ptr = &new_data[MemHeaderSz];
     int32_t handle = ccRegisterManagedObject(obj_ptr, &globalDynamicStruct);
     if (handle == 0)
@@ -84,6 +86,7 @@ void ScriptUserObject::Unserialize(int index, Stream *in, size_t data_sz)
     size_t hdr_sz = static_cast<uint32_t>(in->ReadInt32());
     hdr.TypeId = static_cast<uint32_t>(in->ReadInt32());
     hdr.Size = (data_sz - FileHeaderSz);
+    hdr.Type = nullptr; // will be resolved when necessary
     in->Read(new_data + MemHeaderSz, hdr.Size);
     ccRegisterUnserializedObject(index, &new_data[MemHeaderSz], this);
 }
@@ -95,23 +98,30 @@ void ScriptUserObject::RemapTypeids(void *address,
     const auto it = typeid_map.find(hdr.TypeId);
     assert(hdr.TypeId == 0u || it != typeid_map.end());
     hdr.TypeId = (it != typeid_map.end()) ? it->second : 0u;
+    hdr.Type = nullptr; // will be resolved when necessary
 }
 
 void ScriptUserObject::TraverseRefs(void *address, PfnTraverseRefOp traverse_op)
 {
-    // TODO: may be a bit faster if we make a "runtime type"
-    // struct, merging joint type info and auxiliary helper data,
-    // and store a pointer in the arr data.
-    // might also have a dummy "type" for "unknown type" arrays.
     const Header &hdr = GetHeader(address);
     if (hdr.TypeId == 0u)
         return;
-    assert(ccInstance::GetRTTI()->GetTypes().size() > hdr.TypeId);
-    const auto *helper = ccInstance::GetRTTIHelper();
-    const auto fref = helper->GetManagedOffsetsForType(hdr.TypeId);
-    for (auto it = fref.first; it < fref.second; ++it)
+    // The runtime type is resolved on the first use, because restored objects
+    // may get their type registered later (e.g. along with the room script)
+    if (!hdr.Type)
     {
-        traverse_op(*(int32_t*)(static_cast<uint8_t*>(address) + *it));
+        assert(ccInstance::GetRTTI()->GetTypes().size() > hdr.TypeId);
+        hdr.Type = ccInstance::GetRTTIHelper()->GetRuntimeType(hdr.TypeId);
+        if (!hdr.Type)
+            return;
+    }
+    if (!hdr.Type->has_refs)
+        return; // no managed pointers inside
+
+    const uint8_t *data = static_cast<const uint8_t*>(address);
+    for (const uint32_t off : hdr.Type->managed_offsets)
+    {
+        traverse_op(*(const int32_t*)(data + off));
     }
 }
 
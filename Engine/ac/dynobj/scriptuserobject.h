@@ -22,6 +22,7 @@
 #include "util/geometry.h"
 #include "util/stream.h"
 
+namespace AGS { namespace Engine { struct RuntimeType; } }
 
 struct ScriptUserObject final : AGSCCDynamicObject
 {
@@ -33,6 +34,9 @@ public:
         // Type id of the struct, refering the RTTI
         uint32_t TypeId = 0u;
         uint32_t Size = 0u;
+        // Runtime type, resolved from TypeId on first use;
+        // this is not serialized, and reset whenever TypeId changes
+        mutable const AGS::Engine::RuntimeType *Type = nullptr;
         // NOTE: we use signed int for Size at the moment, because the managed
         // object interface's Serialize() function requires the object to return
         // negative value of size in case the provided buffer was not large
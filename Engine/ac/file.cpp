@@ -11,6 +11,8 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
+#include <string.h>
 #include "ac/asset_helper.h"
 #include "ac/audiocliptype.h"
 #include "ac/file.h"
@@ -22,6 +24,7 @@
 #include "ac/path_helper.h"
 #include "ac/runtime_defines.h"
 #include "ac/string.h"
+#include "ac/dynobj/cc_dynamicarray.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
@@ -120,29 +123,58 @@ void File_WriteRawLine(sc_File *fil, const char *towrite) {
   FileWriteRawLine(fil->handle, towrite);
 }
 
+// Finds the first linebreak char (CR or LF) in the given range
+static char *FindLinebreak(char *buf, size_t len) {
+    char *lf = static_cast<char*>(memchr(buf, '\n', len));
+    char *cr = static_cast<char*>(memchr(buf, '\r', lf ? lf - buf : len));
+    return cr ? cr : lf;
+}
+
 // Reads line of chars until linebreak is met or buffer is filled;
 // returns whether reached the end of line (false in case not enough buffer);
 // guarantees null-terminator in the buffer.
+// The file data is read in chunks directly into the output buffer and scanned
+// for the linebreak; whatever was read past the line end is "given back"
+// by seeking, which is cheap, as script files are always buffered.
 static bool File_ReadRawLineImpl(sc_File *fil, char* buffer, size_t buf_len) {
     if (buf_len == 0) return false;
     Stream *in = get_file_stream(fil->handle, "File.ReadRawLine");
-    for (size_t i = 0; i < buf_len - 1; ++i)
+    const size_t ChunkSize = 256u;
+    for (size_t total = 0; total < buf_len - 1;)
     {
-        int c = in->ReadByte();
-        if (c < 0 || c == '\n') // EOF or LF
+        const size_t chunk_sz = std::min(ChunkSize, buf_len - 1 - total);
+        const size_t read_sz = in->Read(buffer + total, chunk_sz);
+        if (read_sz == 0) // EOF
         {
-            buffer[i] = 0;
+            buffer[total] = 0;
             return true;
         }
-        if (c == '\r') // CR or CRLF
+        char *eol = FindLinebreak(buffer + total, read_sz);
+        if (!eol)
+        {
+            total += read_sz;
+            continue;
+        }
+
+        char *chunk_end = buffer + total + read_sz;
+        char *next = eol + 1;
+        if (*eol == '\r') // CR or CRLF
         {
-            c = in->ReadByte();
             // Look for '\n', but it may be missing, which is also a valid case
-            if (c >= 0 && c != '\n') in->Seek(-1, kSeekCurrent);
-            buffer[i] = 0;
-            return true;
+            if (next < chunk_end)
+            {
+                if (*next == '\n') next++;
+            }
+            else
+            {
+                int c = in->ReadByte();
+                if (c >= 0 && c != '\n') in->Seek(-1, kSeekCurrent);
+            }
         }
-        buffer[i] = c;
+        if (next < chunk_end)
+            in->Seek(-(chunk_end - next), kSeekCurrent);
+        *eol = 0;
+        return true;
     }
     buffer[buf_len - 1] = 0;
     return false; // not enough buffer
@@ -188,6 +220,55 @@ const char* File_ReadStringBack(sc_File *fil) {
   return CreateNewScriptString(std::move(buf));
 }
 
+const char* File_ReadAllText(sc_File *fil) {
+  Stream *in = get_file_stream(fil->handle, "File.ReadAllText");
+  const soff_t remains = in->GetLength() - in->GetPosition();
+  if (remains <= 0)
+    return CreateNewScriptString("");
+  if (remains > INT32_MAX)
+  {
+    debug_script_warn("File.ReadAllText: file is too large (%lld bytes)", static_cast<long long>(remains));
+    return nullptr;
+  }
+
+  const size_t data_sz = static_cast<size_t>(remains);
+  auto buf = ScriptString::CreateBuffer(data_sz);
+  const size_t read_sz = in->Read(buf.Get(), data_sz);
+  buf.Get()[read_sz] = 0;
+  // Short read, or the data contains null-terminators: copy only the valid part
+  if (read_sz < data_sz || strlen(buf.Get()) < data_sz)
+    return CreateNewScriptString(buf.Get());
+  return CreateNewScriptString(std::move(buf));
+}
+
+void *File_ReadBytes(sc_File *fil, int count) {
+  Stream *in = get_file_stream(fil->handle, "File.ReadBytes");
+  const soff_t remains = in->GetLength() - in->GetPosition();
+  const size_t data_sz = static_cast<size_t>(std::max<soff_t>(0, std::min<soff_t>(count, remains)));
+  if (data_sz == 0)
+    return nullptr;
+
+  DynObjectRef arr = CCDynamicArray::CreateOld(data_sz, sizeof(char), false);
+  const size_t read_sz = in->Read(arr.Obj, data_sz);
+  if (read_sz < data_sz)
+    memset(static_cast<uint8_t*>(arr.Obj) + read_sz, 0, data_sz - read_sz);
+  return arr.Obj;
+}
+
+int File_WriteBytes(sc_File *fil, void *arr, int count) {
+  Stream *out = get_file_stream(fil->handle, "File.WriteBytes");
+  if (!arr)
+    return 0;
+  const auto &hdr = CCDynamicArray::GetHeader(arr);
+  if (hdr.IsPointerArray())
+  {
+    debug_script_warn("File.WriteBytes: cannot write an array of managed pointers");
+    return 0;
+  }
+  const size_t data_sz = (count < 0) ? hdr.TotalSize : std::min<size_t>(count, hdr.TotalSize);
+  return static_cast<int>(out->Write(arr, data_sz));
+}
+
 int File_ReadInt(sc_File *fil) {
   return FileReadInt(fil->handle);
 }
@@ -836,6 +917,24 @@ RuntimeScriptValue Sc_File_ReadStringBack(void *self, const RuntimeScriptValue *
     API_OBJCALL_OBJ(sc_File, const char, myScriptStringImpl, File_ReadStringBack);
 }
 
+// const char* (sc_File *fil)
+RuntimeScriptValue Sc_File_ReadAllText(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_OBJ(sc_File, const char, myScriptStringImpl, File_ReadAllText);
+}
+
+// void* (sc_File *fil, int count)
+RuntimeScriptValue Sc_File_ReadBytes(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_OBJ_PINT(sc_File, void, globalDynamicArray, File_ReadBytes);
+}
+
+// int (sc_File *fil, void *arr, int count)
+RuntimeScriptValue Sc_File_WriteBytes(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_INT_POBJ_PINT(sc_File, File_WriteBytes, void);
+}
+
 // void (sc_File *fil, int towrite)
 RuntimeScriptValue Sc_File_WriteInt(void *self, const RuntimeScriptValue *params, int32_t param_count)
 {
@@ -920,6 +1019,9 @@ void RegisterFileAPI()
         { "File::get_Error",          API_FN_PAIR(File_GetError) },
         { "File::get_Position",       API_FN_PAIR(File_GetPosition) },
         { "File::get_Path",           API_FN_PAIR(File_GetPath) },
+        { "File::ReadAllText^0",      API_FN_PAIR(File_ReadAllText) },
+        { "File::ReadBytes^1",        API_FN_PAIR(File_ReadBytes) },
+        { "File::WriteBytes^2",       API_FN_PAIR(File_WriteBytes) },
     };
 
     ccAddExternalFunctions(file_api);
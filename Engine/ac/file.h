@@ -37,6 +37,9 @@ void	File_ReadRawLine(sc_File *fil, char* buffer);
 const char* File_ReadRawLineBack(sc_File *fil);
 void	File_ReadString(sc_File *fil, char *toread);
 const char* File_ReadStringBack(sc_File *fil);
+const char* File_ReadAllText(sc_File *fil);
+void   *File_ReadBytes(sc_File *fil, int count);
+int     File_WriteBytes(sc_File *fil, void *arr, int count);
 int		File_ReadInt(sc_File *fil);
 int		File_ReadRawChar(sc_File *fil);
 int		File_ReadRawInt(sc_File *fil);
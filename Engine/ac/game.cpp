@@ -40,6 +40,7 @@
 #include "ac/path_helper.h"
 #include "ac/sys_events.h"
 #include "ac/room.h"
+#include "ac/roomcache.h"
 #include "ac/roomstatus.h"
 #include "ac/sprite.h"
 #include "ac/spritecache.h"
@@ -506,6 +507,7 @@ void unload_game()
     // IMPORTANT: this is hard reset, including locked items
     spriteset.Reset();
     soundcache_clear();
+    roomcache_clear();
 }
 
 int Game_GetInventoryItemCount() {
@@ -948,8 +950,10 @@ void save_game(int slotn, const char*descript)
         return;
     }
 
-    // Save dynamic game data
-    SaveGameState(out.get());
+    // Save dynamic game data: the game state is serialized in memory first,
+    // then compressed and written to the file in background
+    WriteGameStateAsync(std::move(out), MakeGameStateSnapshot(),
+        usetup.delta_saves ? get_save_game_directory() : String());
     // call "After Save" event callback
     run_on_event(kScriptEvent_GameSaved, RuntimeScriptValue().SetInt32(slotn));
 }
@@ -1059,7 +1063,7 @@ HSaveError load_game(const String &path, int slotNumber, bool &data_overwritten)
     }
 
     // do the actual restore
-    err = RestoreGameState(src.InputStream.get(), src.Version);
+    err = RestoreGameState(src);
     data_overwritten = true;
     if (!err)
         return err;
@@ -32,6 +32,7 @@ GameSetup::GameSetup()
     RenderAtScreenRes = false;
     clear_cache_on_room_change = false;
     load_latest_save = false;
+    delta_saves = false;
     rotation = kScreenRotation_Unlocked;
     show_fps = false;
 
@@ -63,6 +63,12 @@ struct GameSetup
     static const size_t DefTexCacheSize = (128 * 1024); // 128 MB
     static const size_t DefSoundLoadAtOnce = 1024; // 1 MB
     static const size_t DefSoundCache = 1024u * 32; // 32 MB
+    static const size_t DefSoundPcmCache = 1024u * 16; // 16 MB
+#if AGS_PLATFORM_OS_ANDROID || AGS_PLATFORM_OS_IOS
+    static const size_t DefRoomCacheSize = (32 * 1024); // 32 MB
+#else
+    static const size_t DefRoomCacheSize = (64 * 1024); // 64 MB
+#endif
 
 
     bool  audio_enabled;
@@ -101,8 +107,12 @@ struct GameSetup
     size_t TextureCacheSize = DefTexCacheSize; // in KB
     size_t SoundLoadAtOnceSize = DefSoundLoadAtOnce; // threshold for loading sounds immediately, in KB
     size_t SoundCacheSize = DefSoundCache; // sound cache limit, in KB
+    size_t SoundPcmCacheSize = DefSoundPcmCache; // decoded sound cache limit, in KB
+    size_t RoomCacheSize = DefRoomCacheSize; // loaded rooms cache limit, in KB
+    bool  room_prefetch = false; // load neighbouring rooms in background
     bool  clear_cache_on_room_change; // for low-end devices: clear resource caches on room change
     bool  load_latest_save; // load latest saved game on launch
+    bool  delta_saves; // write only changes against a base save
     ScreenRotation rotation;
     bool  show_fps;
     bool  multitasking = false; // whether run on background, when game is switched out
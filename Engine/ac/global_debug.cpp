@@ -37,6 +37,7 @@
 #include "gfx/bitmap.h"
 #include "gfx/graphicsdriver.h"
 #include "main/graphics_mode.h"
+#include "media/audio/audio_core.h"
 
 using namespace AGS::Common;
 using namespace AGS::Engine;
@@ -70,7 +71,8 @@ String GetRuntimeInfo()
         "Game resolution %d x %d (%d-bit)\n"
         "Running %d x %d at %d-bit%s\nGFX: %s; %s\nDraw frame %d x %d\n"
         "Sprite cache KB: %zu / %zu (%u%%), locked: %zu, ext: %zu\n"
-        "Texture cache KB: %zu / %zu (%u%%)",
+        "Texture cache KB: %zu / %zu (%u%%)\n"
+        "Audio underruns: %u",
         get_engine_name(),
         get_engine_version_and_build().GetCStr(),
         game.GetGameRes().Width, game.GetGameRes().Height, game.GetColorDepth(),
@@ -79,12 +81,13 @@ String GetRuntimeInfo()
         gfxDriver->GetDriverName(), filter->GetInfo().Name.GetCStr(),
         render_frame.GetWidth(), render_frame.GetHeight(),
         total_normspr / 1024, max_normspr / 1024, norm_spr_filled, total_lockspr / 1024, total_extspr / 1024,
-        total_txcached / 1024, max_txcached / 1024, tx_filled);
+        total_txcached / 1024, max_txcached / 1024, tx_filled,
+        audio_core_get_underrun_count());
     if (play.separate_music_lib)
         runtimeInfo.Append("[AUDIO.VOX enabled");
     if (play.voice_avail)
         runtimeInfo.Append("[SPEECH.VOX enabled");
-    if (get_translation_tree().size() > 0) {
+    if (get_translation_count() > 0) {
         runtimeInfo.Append("[Using translation ");
         runtimeInfo.Append(get_translation_name());
     }
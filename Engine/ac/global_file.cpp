@@ -70,8 +70,7 @@ void FileWrite(int32_t handle, const char *towrite) {
 void FileWriteRawLine(int32_t handle, const char*towrite) {
   Stream *out = get_file_stream(handle, "FileWriteRawLine");
   out->Write(towrite,strlen(towrite));
-  out->WriteInt8('\r');
-  out->WriteInt8('\n');
+  out->Write("\r\n", 2);
   }
 void FileRead(int32_t handle,char*toread) {
   VALIDATE_STRING(toread);
@@ -46,6 +46,7 @@
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "gui/guidialog.h"
 #include "main/engine.h"
 #include "main/game_start.h"
@@ -113,11 +114,13 @@ void RestoreGameSlot(int slnum) {
 void MoveSaveSlot(int old_save, int new_save) {
     String old_filename = get_save_game_path(old_save);
     String new_filename = get_save_game_path(new_save);
+    WaitForSavegameWrite(); // in case it's still being written
     File::RenameFile(old_filename, new_filename);
 }
 
 void DeleteSaveSlot (int slnum) {
     String save_filename = get_save_game_path(slnum);
+    WaitForSavegameWrite(); // in case it's still being written
     File::DeleteFile(save_filename);
 }
 
@@ -37,22 +37,23 @@ const char *get_translation (const char *text) {
 #if AGS_PLATFORM_64BIT
     // check if a plugin wants to translate it - if so, return that
     // TODO: plugin API is currently strictly 32-bit, so this may break on 64-bit systems
-    char *plResult = Int32ToPtr<char>(pl_run_plugin_hooks(AGSE_TRANSLATETEXT, PtrToInt32(text)));
-    if (plResult) {
-        return plResult;
+    if (pl_any_want_hook(AGSE_TRANSLATETEXT)) {
+        char *plResult = Int32ToPtr<char>(pl_run_plugin_hooks(AGSE_TRANSLATETEXT, PtrToInt32(text)));
+        if (plResult) {
+            return plResult;
+        }
     }
 #endif
 
-    const auto &transtree = get_translation_tree();
-    const auto it = transtree.find(String::Wrapper(text));
-    if (it != transtree.end())
-        return it->second.GetCStr();
+    const char *translated = find_translation(text);
+    if (translated)
+        return translated;
     // return the original text
     return text;
 }
 
 int IsTranslationAvailable () {
-    if (get_translation_tree().size() > 0)
+    if (get_translation_count() > 0)
         return 1;
     return 0;
 }
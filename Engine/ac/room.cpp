@@ -38,11 +38,13 @@
 #include "ac/region.h"
 #include "ac/sys_events.h"
 #include "ac/room.h"
+#include "ac/roomcache.h"
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
 #include "ac/screen.h"
 #include "ac/string.h"
 #include "ac/system.h"
+#include "ac/translation.h"
 #include "ac/walkablearea.h"
 #include "ac/walkbehind.h"
 #include "ac/dynobj/scriptobjects.h"
@@ -395,26 +397,6 @@ static void update_all_viewcams_with_newroom()
     }
 }
 
-// Looks up for the room script available as a separate asset.
-// This is optional, so no error is raised if one is not found.
-// If found however, it will replace room script if one had been loaded
-// from the room file itself.
-HError LoadRoomScript(RoomStruct *room, int newnum)
-{
-    String filename = String::FromFormat("room%d.o", newnum);
-    auto in = AssetMgr->OpenAsset(filename);
-    if (in)
-    {
-        PScript script(ccScript::CreateFromStream(in.get()));
-        if (!script)
-            return new Error(String::FromFormat(
-                "Failed to load a script module: %s", filename.GetCStr()),
-                cc_get_error().ErrorString);
-        room->CompiledScript = script;
-    }
-    return HError::None();
-}
-
 static void reset_temp_room()
 {
     troom = RoomStatus();
@@ -424,8 +406,11 @@ static void reset_temp_room()
 void load_new_room(int newnum, CharacterInfo*forchar) {
 
     debug_script_log("Loading room %d", newnum);
+    invalidate_active_characters();
+    // Drop any routes found for the previous room
+    for (auto &chex : charextra)
+        chex.path_request = 0u;
 
-    String room_filename;
     done_es_error = 0;
     play.room_changes ++;
     // TODO: find out why do we need to temporarily lower color depth to 8-bit.
@@ -435,28 +420,19 @@ void load_new_room(int newnum, CharacterInfo*forchar) {
     set_color_depth(8);
     displayed_room=newnum;
 
-    room_filename.Format("room%d.crm", newnum);
-
-    // load the room from disk
+    // load the room from disk, or take one from the room cache
     set_our_eip(200);
     thisroom.GameID = NO_GAME_ID_IN_ROOM_FILE;
-    HError err = LoadRoom(room_filename, &thisroom, AssetMgr.get(), game.SpriteInfos);
+    HError err = roomcache_load_room(newnum, thisroom);
     if (!err)
     {
-        quitprintf("Unable to load the room file '%s'. Error: %s", room_filename.GetCStr(), err->FullMessage().GetCStr());
+        quitprintf("Unable to load the room %d. Error: %s", newnum, err->FullMessage().GetCStr());
     }
 
     if ((thisroom.GameID != NO_GAME_ID_IN_ROOM_FILE) &&
         (thisroom.GameID != game.uniqueid))
     {
-        quitprintf("!Unable to load '%s'. This room file is assigned to a different game.", room_filename.GetCStr());
-    }
-
-    err = LoadRoomScript(&thisroom, newnum);
-    if (!err)
-    {
-        quitprintf("!Unable to load script from '%s'. Error: %s", room_filename.GetCStr(),
-            err->FullMessage().GetCStr());
+        quitprintf("!Unable to load 'room%d.crm'. This room file is assigned to a different game.", newnum);
     }
 
     // Optionally dump joint RTTI into the log
@@ -795,6 +771,8 @@ void load_new_room(int newnum, CharacterInfo*forchar) {
     debug_script_log("Now in room %d", displayed_room);
     GUIE::MarkAllGUIForUpdate(true, true);
     pl_run_plugin_hooks(AGSE_ENTERROOM, displayed_room);
+    // start loading rooms which the player may go next
+    roomcache_prefetch_neighbours(displayed_room, thisroom);
 }
 
 // new_room: changes the current room number, and loads the new room from disk
@@ -833,6 +811,7 @@ void new_room(int newnum,CharacterInfo*forchar) {
         spriteset.DisposeAllCached();
         soundcache_clear();
         texturecache_clear();
+        roomcache_clear();
     }
 
     load_new_room(newnum,forchar);
@@ -908,6 +887,8 @@ void compile_room_script() {
     if (roominstFork == nullptr)
         quitprintf("Unable to create forked room instance:\n%s", cc_get_error().ErrorString.GetCStr());
 
+    translation_register_static_text(roominst->strings, roominst->stringssize);
+
     repExecAlways.roomHasFunction = true;
     lateRepExecAlways.roomHasFunction = true;
     getDialogOptionsDimensionsFunc.roomHasFunction = true;
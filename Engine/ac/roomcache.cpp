@@ -0,0 +1,395 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "ac/roomcache.h"
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include "ac/game.h"
+#include "core/assetmanager.h"
+#include "debug/out.h"
+#include "game/room_file.h"
+#include "gfx/bitmap.h"
+#include "script/cc_instance.h"
+#include "util/resourcecache.h"
+
+using namespace AGS::Common;
+
+// Room cache, stores most recent used rooms, tracks use history with MRU list.
+// Cached rooms are kept in the state they were loaded from the file, and must
+// not be modified: the engine receives copies of their bitmaps.
+class RoomCache final :
+    public ResourceCache<int, std::shared_ptr<const RoomStruct>>
+{
+public:
+    typedef std::shared_ptr<const RoomStruct> DataRef;
+
+    RoomCache() : ResourceCache(DEFAULT_ROOMCACHESIZE_KB * 1024)
+    {
+    }
+
+private:
+    // Calculates item size; expects to return 0 if an item is invalid
+    // and should not be added to the cache.
+    size_t CalcSize(const DataRef &item) override
+    {
+        assert(item);
+        if (!item)
+            return 0u;
+        size_t size = sizeof(RoomStruct);
+        for (size_t i = 0; i < item->BgFrameCount; ++i)
+        {
+            if (item->BgFrames[i].Graphic)
+                size += item->BgFrames[i].Graphic->GetDataSize();
+        }
+        for (int i = kRoomArea_First; i <= kRoomArea_Last; ++i)
+        {
+            const Bitmap *mask = item->GetMask(static_cast<RoomAreaMask>(i));
+            if (mask)
+                size += mask->GetDataSize();
+        }
+        if (item->CompiledScript)
+            size += item->CompiledScript->code.size() * sizeof(int32_t)
+                + item->CompiledScript->globaldata.size()
+                + item->CompiledScript->strings.size();
+        return size;
+    }
+};
+
+// Maximal number of rooms scheduled for prefetching after entering a room
+static const size_t MaxPrefetchRooms = 4;
+
+// Room prefetching state; the worker thread only reads the room files,
+// the loaded rooms are passed back to the main thread, which puts them
+// into the cache when the next room is requested.
+static struct
+{
+    bool enabled = false;
+    std::thread worker;
+    bool worker_running = false;
+    std::mutex mutex;
+    std::condition_variable cv;
+    // rooms scheduled for loading
+    std::deque<int> queue;
+    // room which is being loaded right now, or -1
+    int loading = -1;
+    // loaded rooms, waiting to be put into the cache
+    std::vector<std::pair<int, std::shared_ptr<RoomStruct>>> loaded;
+} g_prefetch;
+
+static RoomCache RmCache;
+
+
+// Looks up for the room script available as a separate asset.
+// This is optional, so no error is raised if one is not found.
+// If found however, it will replace room script if one had been loaded
+// from the room file itself.
+static HError LoadRoomScript(RoomStruct *room, int newnum)
+{
+    String filename = String::FromFormat("room%d.o", newnum);
+    auto in = AssetMgr->OpenAsset(filename);
+    if (in)
+    {
+        // NOTE: may be called on the prefetch thread, so don't use the global script error
+        String error;
+        PScript script(ccScript::CreateFromStream(in.get(), error));
+        if (!script)
+            return new Error(String::FromFormat(
+                "Failed to load a script module: %s", filename.GetCStr()), error);
+        room->CompiledScript = script;
+    }
+    return HError::None();
+}
+
+// Reads room data and script from the game assets
+static HError LoadRoomAssets(int room_num, RoomStruct *room)
+{
+    const String room_filename = String::FromFormat("room%d.crm", room_num);
+    // NOTE: sprite infos are not used by the current room loader,
+    // and game's list may be modified by the main thread while prefetching
+    HError err = LoadRoom(room_filename, room, AssetMgr.get(), std::vector<SpriteInfo>());
+    if (!err)
+        return new Error(String::FromFormat("Unable to load the room file '%s'.", room_filename.GetCStr()), err);
+    err = LoadRoomScript(room, room_num);
+    if (!err)
+        return new Error(String::FromFormat("Unable to load script from '%s'.", room_filename.GetCStr()), err);
+    return HError::None();
+}
+
+// Replaces each of the room's bitmaps with its own copy
+static void CopyRoomBitmaps(RoomStruct &room)
+{
+    for (size_t i = 0; i < room.BgFrameCount; ++i)
+    {
+        if (room.BgFrames[i].Graphic)
+            room.BgFrames[i].Graphic.reset(BitmapHelper::CreateBitmapCopy(room.BgFrames[i].Graphic.get()));
+    }
+    for (int i = kRoomArea_First; i <= kRoomArea_Last; ++i)
+    {
+        const RoomAreaMask mask = static_cast<RoomAreaMask>(i);
+        if (room.GetMask(mask))
+            room.SetMask(mask, BitmapHelper::CreateBitmapCopy(room.GetMask(mask)));
+    }
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+static void roomcache_prefetch_entry()
+{
+    std::unique_lock<std::mutex> lk(g_prefetch.mutex);
+    while (g_prefetch.worker_running)
+    {
+        if (g_prefetch.queue.empty())
+        {
+            g_prefetch.cv.wait(lk);
+            continue;
+        }
+
+        const int room_num = g_prefetch.queue.front();
+        g_prefetch.queue.pop_front();
+        g_prefetch.loading = room_num;
+        lk.unlock();
+
+        auto room = std::make_shared<RoomStruct>();
+        HError err = LoadRoomAssets(room_num, room.get());
+
+        lk.lock();
+        if (err)
+            g_prefetch.loaded.emplace_back(room_num, std::move(room));
+        // errors are ignored here, and will be reported if the room is
+        // actually going to be loaded by the game
+        g_prefetch.loading = -1;
+        g_prefetch.cv.notify_all();
+    }
+}
+#endif // !AGS_DISABLE_THREADS
+
+// Moves rooms loaded by the prefetching thread into the cache
+static void collect_prefetched_rooms()
+{
+    std::vector<std::pair<int, std::shared_ptr<RoomStruct>>> loaded;
+    {
+        std::lock_guard<std::mutex> lk(g_prefetch.mutex);
+        std::swap(loaded, g_prefetch.loaded);
+    }
+    for (auto &room : loaded)
+    {
+        if (!RmCache.Exists(room.first))
+            RmCache.Put(room.first, std::move(room.second));
+    }
+}
+
+void roomcache_stop_prefetch()
+{
+    std::unique_lock<std::mutex> lk(g_prefetch.mutex);
+    g_prefetch.queue.clear();
+    g_prefetch.cv.wait(lk, []() { return g_prefetch.loading < 0; });
+}
+
+void roomcache_set_rules(size_t max_cachesize, bool prefetch)
+{
+    RmCache.SetMaxCacheSize(max_cachesize);
+#if !defined(AGS_DISABLE_THREADS)
+    g_prefetch.enabled = prefetch && (max_cachesize > 0);
+#else
+    g_prefetch.enabled = false;
+#endif
+    Debug::Printf("Room cache set: %zu KB, prefetch: %s",
+        max_cachesize / 1024, g_prefetch.enabled ? "on" : "off");
+}
+
+HError roomcache_load_room(int room_num, RoomStruct &room)
+{
+    if (RmCache.GetMaxCacheSize() == 0)
+        return LoadRoomAssets(room_num, &room); // cache is disabled
+
+    {
+        // If this room is currently being prefetched, then wait for it
+        std::unique_lock<std::mutex> lk(g_prefetch.mutex);
+        auto it = std::find(g_prefetch.queue.begin(), g_prefetch.queue.end(), room_num);
+        if (it != g_prefetch.queue.end())
+            g_prefetch.queue.erase(it);
+        g_prefetch.cv.wait(lk, [room_num]() { return g_prefetch.loading != room_num; });
+    }
+    collect_prefetched_rooms();
+
+    RoomCache::DataRef cached = RmCache.Get(room_num);
+    if (!cached)
+    {
+        auto loaded = std::make_shared<RoomStruct>();
+        HError err = LoadRoomAssets(room_num, loaded.get());
+        if (!err)
+            return err;
+        cached = loaded;
+        RmCache.Put(room_num, cached);
+    }
+    else
+    {
+        Debug::Printf("Room %d taken from the room cache", room_num);
+    }
+
+    room = *cached;
+    CopyRoomBitmaps(room);
+    return HError::None();
+}
+
+// Finds numbers of rooms which the script may change to, by looking for
+// the calls of the room changing functions with a literal room number.
+static void find_room_changes(const ccScript &script, std::unordered_set<int> &rooms)
+{
+    static const char *room_funcs[] = { "NewRoom", "NewRoomEx", "NewRoomNPC",
+        "Character::ChangeRoom", "Character::ChangeRoomAutoPosition" };
+    // Mark the imports of room changing functions
+    std::vector<bool> room_import(script.imports.size());
+    for (size_t i = 0; i < script.imports.size(); ++i)
+    {
+        const std::string &name = script.imports[i];
+        const std::string base_name = name.substr(0, name.find('^'));
+        for (const char *func : room_funcs)
+            room_import[i] = room_import[i] || (base_name == func);
+    }
+    // Mark code positions which contain an import index
+    std::unordered_set<int32_t> import_refs;
+    for (size_t i = 0; i < script.fixups.size(); ++i)
+    {
+        if (script.fixuptypes[i] == FIXUP_IMPORT)
+            import_refs.insert(script.fixups[i]);
+    }
+
+    // Follow the literal values put in registers and pushed to the stack;
+    // room number is the last pushed argument for every function of interest.
+    const int32_t *code = script.code.data();
+    const int32_t codesize = static_cast<int32_t>(script.code.size());
+    int32_t reg_value[CC_NUM_REGISTERS]{};
+    bool reg_valid[CC_NUM_REGISTERS]{};
+    bool reg_import[CC_NUM_REGISTERS]{};
+    int32_t last_pushed = -1;
+    bool last_pushed_valid = false;
+    for (int32_t pc = 0; pc < codesize;)
+    {
+        const int32_t op = code[pc];
+        const int arg_count = ccInstance::GetInstructionArgCount(op);
+        if (arg_count < 0 || pc + arg_count >= codesize)
+            break; // corrupt or unknown bytecode
+        const int32_t arg1 = (arg_count > 0) ? code[pc + 1] : 0;
+        const int32_t arg2 = (arg_count > 1) ? code[pc + 2] : 0;
+        const bool arg1_reg = (arg1 >= 0) && (arg1 < CC_NUM_REGISTERS);
+        const bool arg2_reg = (arg2 >= 0) && (arg2 < CC_NUM_REGISTERS);
+        switch (op)
+        {
+        case SCMD_LITTOREG:
+            if (arg1_reg)
+            {
+                reg_value[arg1] = arg2;
+                reg_valid[arg1] = true;
+                reg_import[arg1] = import_refs.count(pc + 2) > 0;
+            }
+            break;
+        case SCMD_REGTOREG:
+            if (arg1_reg && arg2_reg)
+            {
+                reg_value[arg2] = reg_value[arg1];
+                reg_valid[arg2] = reg_valid[arg1];
+                reg_import[arg2] = reg_import[arg1];
+            }
+            break;
+        case SCMD_PUSHREAL:
+            last_pushed_valid = arg1_reg && reg_valid[arg1] && !reg_import[arg1];
+            last_pushed = last_pushed_valid ? reg_value[arg1] : -1;
+            break;
+        case SCMD_CALLEXT:
+            if (arg1_reg && reg_valid[arg1] && reg_import[arg1] &&
+                (reg_value[arg1] >= 0) && (static_cast<size_t>(reg_value[arg1]) < room_import.size()) &&
+                room_import[reg_value[arg1]] && last_pushed_valid && (last_pushed >= 0))
+            {
+                rooms.insert(last_pushed);
+            }
+            last_pushed_valid = false;
+            std::fill(std::begin(reg_valid), std::end(reg_valid), false);
+            break;
+        case SCMD_LINENUM:
+        case SCMD_NUMFUNCARGS:
+        case SCMD_CALLOBJ:
+            break; // these do not change registers or real stack
+        default:
+            // anything else is treated as invalidating all known values
+            last_pushed_valid = false;
+            std::fill(std::begin(reg_valid), std::end(reg_valid), false);
+            break;
+        }
+        pc += arg_count + 1;
+    }
+}
+
+void roomcache_prefetch_neighbours(int room_num, const RoomStruct &room)
+{
+    if (!g_prefetch.enabled || !room.CompiledScript)
+        return;
+
+    collect_prefetched_rooms();
+
+    std::unordered_set<int> rooms;
+    find_room_changes(*room.CompiledScript, rooms);
+    rooms.erase(room_num);
+
+    std::lock_guard<std::mutex> lk(g_prefetch.mutex);
+    g_prefetch.queue.clear();
+    for (int num : rooms)
+    {
+        if (g_prefetch.queue.size() >= MaxPrefetchRooms)
+            break;
+        if (!RmCache.Exists(num) && (num != g_prefetch.loading))
+            g_prefetch.queue.push_back(num);
+    }
+    if (g_prefetch.queue.empty())
+        return;
+
+    Debug::Printf("Room cache: prefetching %zu room(s) for room %d", g_prefetch.queue.size(), room_num);
+#if !defined(AGS_DISABLE_THREADS)
+    if (!g_prefetch.worker_running)
+    {
+        g_prefetch.worker_running = true;
+        g_prefetch.worker = std::thread(roomcache_prefetch_entry);
+    }
+#endif
+    g_prefetch.cv.notify_all();
+}
+
+void roomcache_clear()
+{
+    roomcache_stop_prefetch();
+    {
+        std::lock_guard<std::mutex> lk(g_prefetch.mutex);
+        g_prefetch.loaded.clear();
+    }
+    RmCache.Clear();
+}
+
+void roomcache_shutdown()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    {
+        std::lock_guard<std::mutex> lk(g_prefetch.mutex);
+        g_prefetch.queue.clear();
+        g_prefetch.worker_running = false;
+        g_prefetch.cv.notify_all();
+    }
+    if (g_prefetch.worker.joinable())
+        g_prefetch.worker.join();
+#endif
+    g_prefetch.loaded.clear();
+    RmCache.Clear();
+}
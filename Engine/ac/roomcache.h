@@ -0,0 +1,55 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Room data cache: keeps loaded data of the recently visited rooms
+// (backgrounds, masks and compiled scripts), letting to skip reading and
+// decompressing room files when the player returns into these rooms.
+// Optionally prefetches rooms which may be visited next on a background thread.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__ROOMCACHE_H
+#define __AGS_EE_AC__ROOMCACHE_H
+
+#include "core/platform.h"
+#include "game/roomstruct.h"
+#include "util/error.h"
+
+// Default room cache limit, in KB
+#if AGS_PLATFORM_OS_ANDROID || AGS_PLATFORM_OS_IOS
+const size_t DEFAULT_ROOMCACHESIZE_KB = 1024u * 32; // 32 MB
+#else
+const size_t DEFAULT_ROOMCACHESIZE_KB = 1024u * 64; // 64 MB
+#endif
+
+// Sets room caching rules:
+// * max_cachesize - room cache limit, in bytes; 0 disables the cache
+// * prefetch - whether to load neighbouring rooms in background
+void roomcache_set_rules(size_t max_cachesize, bool prefetch);
+// Loads the room data, either taking it from the cache, or reading room file
+// and the optional separate room script. Returned room has its own copies of
+// all bitmaps, which are safe to modify.
+AGS::Common::HError roomcache_load_room(int room_num, AGS::Common::RoomStruct &room);
+// Looks up the room numbers which the given room may lead to, and schedules
+// them for loading in background, if room prefetching is enabled.
+void roomcache_prefetch_neighbours(int room_num, const AGS::Common::RoomStruct &room);
+// Cancels any scheduled prefetching and waits until the room which is being
+// loaded in background is complete; this should be called before modifying
+// the asset library list.
+void roomcache_stop_prefetch();
+// Disposes all cached rooms
+void roomcache_clear();
+// Stops prefetching thread and disposes all cached rooms
+void roomcache_shutdown();
+
+#endif // __AGS_EE_AC__ROOMCACHE_H
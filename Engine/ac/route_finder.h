@@ -14,6 +14,7 @@
 #ifndef __AGS_EN_AC__ROUTEFINDER_H
 #define __AGS_EN_AC__ROUTEFINDER_H
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include "ac/movelist.h"
@@ -53,8 +54,20 @@ class MaskRouteFinder : public IRouteFinder
 public:
     // Assign a walkable mask, and an optional coordinate scale factor which will be used
     // to convert (divide) input coordinates, and resulting path back (multiply).
-    // Note that this may make routefinder to generate additional data, taking more time.
+    // Note that this may make routefinder to generate additional data, taking more time;
+    // the mask must be assigned again if its contents change.
     virtual void SetWalkableArea(const AGS::Common::Bitmap *walkablearea, uint32_t coord_scale = 1) = 0;
+
+    // Callback for the asynchronous route search:
+    // receives request's id, whether the route was found, and the resulting path.
+    typedef std::function<void(uint32_t request_id, bool found, const std::vector<Point> &path)> RouteCallback;
+    // Schedules a route search on a background thread, using a copy of the
+    // currently assigned walkable mask. Returns request's id, which is never 0.
+    // The result is passed to the callback by the next PollRoutes call.
+    virtual uint32_t FindRouteAsync(int srcx, int srcy, int dstx, int dsty,
+        bool exact_dest, bool ignore_walls, RouteCallback callback) = 0;
+    // Runs callbacks for the completed asynchronous route searches
+    virtual void PollRoutes() = 0;
 };
 
 
@@ -65,6 +78,8 @@ namespace Pathfinding
 {
     // Creates a default engine's MaskRouteFinder implementation
     std::unique_ptr<MaskRouteFinder> CreateDefaultMaskPathfinder();
+    // Stops the threads used for the asynchronous route search
+    void ShutdownRouteWorkers();
 
     // Find route using a provided IRouteFinder, and calculate the MoveList using move speeds
     bool FindRoute(MoveList &mls, IRouteFinder *finder, int srcx, int srcy, int dstx, int dsty,
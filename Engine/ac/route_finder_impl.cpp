@@ -16,9 +16,16 @@
 //
 //=============================================================================
 #include <algorithm>
+#include <deque>
+#if !defined(AGS_DISABLE_THREADS)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 #include "ac/route_finder_impl.h"
 #include "ac/route_finder_jps.inl"
 #include "gfx/bitmap.h"
+#include "util/memory_compat.h"
 
 using namespace AGS::Common;
 
@@ -29,67 +36,26 @@ namespace AGS
 namespace Engine
 {
 
-JPSRouteFinder::JPSRouteFinder()
-    : nav(*new Navigation())
-{
-}
+// Route search helpers; these are shared by the main thread and async workers,
+// so they receive all the working state as arguments.
 
-JPSRouteFinder::~JPSRouteFinder()
+// Copies walkable mask into the Navigation's grid; this must be done
+// whenever the mask is assigned or its contents change.
+static void SyncNavWalkablearea(Navigation &nav, const Bitmap *walkablearea)
 {
-    delete &nav;
-}
+    nav.Resize(walkablearea->GetWidth(), walkablearea->GetHeight());
 
-void JPSRouteFinder::SetWalkableArea(const Bitmap *walkablearea, uint32_t coord_scale) 
-{
-    _walkablearea = walkablearea;
-    assert(coord_scale > 0);
-    _coordScale = std::max(1u, coord_scale);
-}
-
-void JPSRouteFinder::SyncNavWalkablearea()
-{
-    // FIXME: this is dumb, but...
-    nav.Resize(_walkablearea->GetWidth(), _walkablearea->GetHeight());
-
-    for (int y = 0; y < _walkablearea->GetHeight(); y++)
-        nav.SetMapRow(y, _walkablearea->GetScanLine(y));
+    for (int y = 0; y < walkablearea->GetHeight(); y++)
+        nav.SetMapRow(y, walkablearea->GetScanLine(y));
 }
 
-bool JPSRouteFinder::CanSeeFrom(int srcx, int srcy, int dstx, int dsty, int *lastcx, int *lastcy)
-{
-    if (!_walkablearea)
-    {
-        if (lastcx)
-            *lastcx = srcx;
-        if (lastcy)
-            *lastcy = srcy;
-        return false;
-    }
-
-    // convert input to the mask coords
-    srcx /= _coordScale;
-    srcy /= _coordScale;
-    dstx /= _coordScale;
-    dsty /= _coordScale;
-
-    int last_valid_x, last_valid_y;
-    bool result = CanSeeFromImpl(srcx, srcy, dstx, dsty, &last_valid_x, &last_valid_y);
-
-    // convert output from the mask coords
-    if (lastcx)
-        *lastcx = last_valid_x * _coordScale;
-    if (lastcy)
-        *lastcy = last_valid_y * _coordScale;
-    return result;
-}
-
-bool JPSRouteFinder::CanSeeFromImpl(int srcx, int srcy, int dstx, int dsty, int *lastcx, int *lastcy)
+static bool CanSeeFromImpl(Navigation &nav, const Bitmap *walkablearea,
+    int srcx, int srcy, int dstx, int dsty, int *lastcx = nullptr, int *lastcy = nullptr)
 {
     bool result = false;
     int last_valid_x = srcx, last_valid_y = srcy;
     if ((srcx != dstx) || (srcy != dsty))
     {
-        SyncNavWalkablearea();
         result = !nav.TraceLine(srcx, srcy, dstx, dsty, last_valid_x, last_valid_y);
     }
     if (lastcx)
@@ -99,13 +65,10 @@ bool JPSRouteFinder::CanSeeFromImpl(int srcx, int srcy, int dstx, int dsty, int
     return result;
 }
 
-bool JPSRouteFinder::FindRouteJPS(std::vector<Point> &nav_path, int fromx, int fromy, int destx, int desty)
+static bool FindRouteJPS(Navigation &nav, const Bitmap *walkablearea,
+    std::vector<int> &path, std::vector<int> &cpath,
+    std::vector<Point> &nav_path, int fromx, int fromy, int destx, int desty)
 {
-    if (!_walkablearea)
-        return false;
-
-    SyncNavWalkablearea();
-
     path.clear();
     cpath.clear();
 
@@ -124,31 +87,30 @@ bool JPSRouteFinder::FindRouteJPS(std::vector<Point> &nav_path, int fromx, int f
     return true;
 }
 
-bool JPSRouteFinder::FindRoute(std::vector<Point> &nav_path, int srcx, int srcy, int dstx, int dsty,
+static bool FindRouteImpl(Navigation &nav, const Bitmap *walkablearea, uint32_t coord_scale,
+    std::vector<int> &path, std::vector<int> &cpath,
+    std::vector<Point> &nav_path, int srcx, int srcy, int dstx, int dsty,
     bool exact_dest, bool ignore_walls)
 {
-    if (!_walkablearea)
-        return false;
-
     // convert input to the mask coords
-    srcx /= _coordScale;
-    srcy /= _coordScale;
-    dstx /= _coordScale;
-    dsty /= _coordScale;
+    srcx /= coord_scale;
+    srcy /= coord_scale;
+    dstx /= coord_scale;
+    dsty /= coord_scale;
 
     nav_path.clear();
 
-    if (ignore_walls || CanSeeFromImpl(srcx, srcy, dstx, dsty))
+    if (ignore_walls || CanSeeFromImpl(nav, walkablearea, srcx, srcy, dstx, dsty))
     {
         nav_path.emplace_back( srcx, srcy );
         nav_path.emplace_back( dstx, dsty );
     }
     else
     {
-        if ((exact_dest) && (_walkablearea->GetPixel(dstx, dsty) == 0))
+        if ((exact_dest) && (walkablearea->GetPixel(dstx, dsty) == 0))
             return false; // clicked on a wall
 
-        FindRouteJPS(nav_path, srcx, srcy, dstx, dsty);
+        FindRouteJPS(nav, walkablearea, path, cpath, nav_path, srcx, srcy, dstx, dsty);
     }
 
     if (nav_path.size() == 0)
@@ -159,13 +121,262 @@ bool JPSRouteFinder::FindRoute(std::vector<Point> &nav_path, int srcx, int srcy,
         nav_path.push_back(nav_path[0]);
 
 #ifdef DEBUG_PATHFINDER
-    AGS::Common::Debug::Printf("Route from %d,%d to %d,%d - %d stages", srcx,srcy,xx,yy,(int)nav_path.size());
+    AGS::Common::Debug::Printf("Route from %d,%d to %d,%d - %d stages", srcx,srcy,dstx,dsty,(int)nav_path.size());
 #endif
     // convert output from the mask coords
     for (auto &pt : nav_path)
-        pt *= _coordScale;
+        pt *= coord_scale;
     return true;
 }
 
+
+// Results of the asynchronous route searches, waiting to be collected
+// by the pathfinder which scheduled them. Shared between the pathfinder
+// and its pending jobs, so that the jobs may outlive the pathfinder.
+struct AsyncRouteResults
+{
+    struct Result
+    {
+        uint32_t Id = 0u;
+        bool Found = false;
+        std::vector<Point> Path;
+    };
+
+#if !defined(AGS_DISABLE_THREADS)
+    std::mutex Mutex;
+#endif
+    std::vector<Result> Completed;
+};
+
+// A single asynchronous route search request
+struct AsyncRouteJob
+{
+    uint32_t Id = 0u;
+    // Own copy of the walkable mask, as the room may change meanwhile
+    std::unique_ptr<Bitmap> Mask;
+    uint32_t CoordScale = 1u;
+    int SrcX = 0, SrcY = 0, DstX = 0, DstY = 0;
+    bool ExactDest = false;
+    bool IgnoreWalls = false;
+    std::shared_ptr<AsyncRouteResults> Results;
+};
+
+// Per-thread search state
+struct RouteWorkerState
+{
+    Navigation Nav;
+    std::vector<int> Path, CPath;
+};
+
+static void RunRouteJob(RouteWorkerState &state, AsyncRouteJob &job)
+{
+    AsyncRouteResults::Result result;
+    result.Id = job.Id;
+    SyncNavWalkablearea(state.Nav, job.Mask.get());
+    result.Found = FindRouteImpl(state.Nav, job.Mask.get(), job.CoordScale, state.Path, state.CPath,
+        result.Path, job.SrcX, job.SrcY, job.DstX, job.DstY, job.ExactDest, job.IgnoreWalls);
+    job.Mask.reset();
+#if !defined(AGS_DISABLE_THREADS)
+    std::lock_guard<std::mutex> lk(job.Results->Mutex);
+#endif
+    job.Results->Completed.push_back(std::move(result));
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+// Max number of threads used for the asynchronous route search
+static const unsigned MaxRouteWorkers = 4u;
+
+// The pool of route search threads, started on the first request
+static struct
+{
+    std::vector<std::thread> Threads;
+    std::mutex Mutex;
+    std::condition_variable CV;
+    std::deque<std::unique_ptr<AsyncRouteJob>> Jobs;
+    bool Running = false;
+} g_routePool;
+
+static void RouteWorkerProc()
+{
+    RouteWorkerState state;
+    for (;;)
+    {
+        std::unique_ptr<AsyncRouteJob> job;
+        {
+            std::unique_lock<std::mutex> lk(g_routePool.Mutex);
+            g_routePool.CV.wait(lk, []() { return !g_routePool.Running || !g_routePool.Jobs.empty(); });
+            if (!g_routePool.Running)
+                return;
+            job = std::move(g_routePool.Jobs.front());
+            g_routePool.Jobs.pop_front();
+        }
+        RunRouteJob(state, *job);
+    }
+}
+
+static void ScheduleRouteJob(std::unique_ptr<AsyncRouteJob> job)
+{
+    std::lock_guard<std::mutex> lk(g_routePool.Mutex);
+    if (!g_routePool.Running)
+    {
+        g_routePool.Running = true;
+        const unsigned hw_threads = std::thread::hardware_concurrency();
+        const unsigned num_threads = std::min(MaxRouteWorkers, std::max(1u, hw_threads > 0 ? hw_threads - 1 : 1u));
+        for (unsigned i = 0; i < num_threads; ++i)
+            g_routePool.Threads.emplace_back(RouteWorkerProc);
+    }
+    g_routePool.Jobs.push_back(std::move(job));
+    g_routePool.CV.notify_one();
+}
+#else
+static void ScheduleRouteJob(std::unique_ptr<AsyncRouteJob> job)
+{
+    // No threads: search immediately, result is delivered on the next poll
+    static RouteWorkerState state;
+    RunRouteJob(state, *job);
+}
+#endif // !AGS_DISABLE_THREADS
+
+
+JPSRouteFinder::JPSRouteFinder()
+    : nav(*new Navigation())
+    , _asyncResults(std::make_shared<AsyncRouteResults>())
+{
+}
+
+JPSRouteFinder::~JPSRouteFinder()
+{
+    delete &nav;
+}
+
+void JPSRouteFinder::SetWalkableArea(const Bitmap *walkablearea, uint32_t coord_scale) 
+{
+    _walkablearea = walkablearea;
+    assert(coord_scale > 0);
+    _coordScale = std::max(1u, coord_scale);
+    // Walkable grid is prepared once here, and reused by all the searches
+    // until the next assignment; assigning same mask again only compares
+    // the grid rows, and updates the cells which changed
+    if (_walkablearea)
+        SyncNavWalkablearea(nav, _walkablearea);
+}
+
+bool JPSRouteFinder::CanSeeFrom(int srcx, int srcy, int dstx, int dsty, int *lastcx, int *lastcy)
+{
+    if (!_walkablearea)
+    {
+        if (lastcx)
+            *lastcx = srcx;
+        if (lastcy)
+            *lastcy = srcy;
+        return false;
+    }
+
+    // convert input to the mask coords
+    srcx /= _coordScale;
+    srcy /= _coordScale;
+    dstx /= _coordScale;
+    dsty /= _coordScale;
+
+    int last_valid_x, last_valid_y;
+    bool result = CanSeeFromImpl(nav, _walkablearea, srcx, srcy, dstx, dsty, &last_valid_x, &last_valid_y);
+
+    // convert output from the mask coords
+    if (lastcx)
+        *lastcx = last_valid_x * _coordScale;
+    if (lastcy)
+        *lastcy = last_valid_y * _coordScale;
+    return result;
+}
+
+bool JPSRouteFinder::FindRoute(std::vector<Point> &nav_path, int srcx, int srcy, int dstx, int dsty,
+    bool exact_dest, bool ignore_walls)
+{
+    if (!_walkablearea)
+        return false;
+
+    return FindRouteImpl(nav, _walkablearea, _coordScale, path, cpath,
+        nav_path, srcx, srcy, dstx, dsty, exact_dest, ignore_walls);
+}
+
+uint32_t JPSRouteFinder::FindRouteAsync(int srcx, int srcy, int dstx, int dsty,
+    bool exact_dest, bool ignore_walls, RouteCallback callback)
+{
+    if (++_nextRequestId == 0u)
+        ++_nextRequestId; // 0 is reserved for "no request"
+    const uint32_t request_id = _nextRequestId;
+    _routeCallbacks[request_id] = std::move(callback);
+
+    if (!_walkablearea)
+    {
+        // Nothing to search in, report failure on the next poll
+        AsyncRouteResults::Result result;
+        result.Id = request_id;
+#if !defined(AGS_DISABLE_THREADS)
+        std::lock_guard<std::mutex> lk(_asyncResults->Mutex);
+#endif
+        _asyncResults->Completed.push_back(std::move(result));
+        return request_id;
+    }
+
+    auto job = std::make_unique<AsyncRouteJob>();
+    job->Id = request_id;
+    job->Mask.reset(BitmapHelper::CreateBitmapCopy(const_cast<Bitmap*>(_walkablearea)));
+    job->CoordScale = _coordScale;
+    job->SrcX = srcx;
+    job->SrcY = srcy;
+    job->DstX = dstx;
+    job->DstY = dsty;
+    job->ExactDest = exact_dest;
+    job->IgnoreWalls = ignore_walls;
+    job->Results = _asyncResults;
+    ScheduleRouteJob(std::move(job));
+    return request_id;
+}
+
+void JPSRouteFinder::PollRoutes()
+{
+    std::vector<AsyncRouteResults::Result> completed;
+    {
+#if !defined(AGS_DISABLE_THREADS)
+        std::lock_guard<std::mutex> lk(_asyncResults->Mutex);
+#endif
+        completed.swap(_asyncResults->Completed);
+    }
+
+    for (const auto &result : completed)
+    {
+        auto it = _routeCallbacks.find(result.Id);
+        if (it == _routeCallbacks.end())
+            continue;
+        RouteCallback callback = std::move(it->second);
+        _routeCallbacks.erase(it);
+        if (callback)
+            callback(result.Id, result.Found, result.Path);
+    }
+}
+
+namespace Pathfinding
+{
+
+void ShutdownRouteWorkers()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    {
+        std::lock_guard<std::mutex> lk(g_routePool.Mutex);
+        if (!g_routePool.Running)
+            return;
+        g_routePool.Running = false;
+        g_routePool.Jobs.clear();
+    }
+    g_routePool.CV.notify_all();
+    for (auto &thread : g_routePool.Threads)
+        thread.join();
+    g_routePool.Threads.clear();
+#endif
+}
+
+} // namespace Pathfinding
+
 } // namespace Engine
 } // namespace AGS
@@ -14,6 +14,8 @@
 #ifndef __AGS_EN_AC__ROUTEFINDER_IMPL_H
 #define __AGS_EN_AC__ROUTEFINDER_IMPL_H
 
+#include <memory>
+#include <unordered_map>
 #include "ac/movelist.h"
 #include "ac/route_finder.h"
 #include "util/geometry.h"
@@ -24,6 +26,7 @@ namespace Engine
 {
 
 class Navigation;
+struct AsyncRouteResults;
 
 // JPSRouteFinder: a jump point search (JPS) A* pathfinder by Martin Sedlak.
 class JPSRouteFinder : public MaskRouteFinder
@@ -44,16 +47,22 @@ public:
     // Assign a walkable mask;
     // Note that this may make routefinder to generate additional data, taking more time.
     void SetWalkableArea(const AGS::Common::Bitmap *walkablearea, uint32_t coord_scale) override;
+    // Schedules a route search on a background thread, using a copy of the
+    // currently assigned walkable mask.
+    uint32_t FindRouteAsync(int srcx, int srcy, int dstx, int dsty,
+        bool exact_dest, bool ignore_walls, RouteCallback callback) override;
+    // Runs callbacks for the completed asynchronous route searches
+    void PollRoutes() override;
 
 private:
-    void SyncNavWalkablearea();
-    bool CanSeeFromImpl(int srcx, int srcy, int dstx, int dsty, int *lastcx = nullptr, int *lastcy = nullptr);
-    bool FindRouteJPS(std::vector<Point> &nav_path, int fromx, int fromy, int destx, int desty);
-
     Navigation &nav; // declare as reference, because we must hide real Navigation decl here
     const Bitmap *_walkablearea = nullptr;
     uint32_t _coordScale = 1;
     std::vector<int> path, cpath;
+    // Asynchronous search results, shared with the worker threads
+    std::shared_ptr<AsyncRouteResults> _asyncResults;
+    std::unordered_map<uint32_t, RouteCallback> _routeCallbacks;
+    uint32_t _nextRequestId = 0u;
 };
 
 } // namespace Engine
@@ -24,7 +24,11 @@
 #include <functional>
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <math.h>
+#if defined(_MSC_VER) && defined(_WIN64)
+#include <intrin.h>
+#endif
 
 namespace AGS
 {
@@ -63,7 +67,13 @@ public:
 	bool TraceLine(int srcx, int srcy, int targx, int targy, int &lastValidX, int &lastValidY) const;
 	bool TraceLine(int srcx, int srcy, int targx, int targy, std::vector<int> *rpath = nullptr) const;
 
-	inline void SetMapRow(int y, const unsigned char *row) {map[y] = row;}
+	// Assigns walkable row, where non-zero bytes are walkable cells;
+	// the row's contents are copied into the internal grid
+	void SetMapRow(int y, const unsigned char *row);
+
+	// Makes orthogonal jumps scan the map cell by cell rather than by grid words;
+	// this is slower, and is meant only as a reference for testing
+	void SetScanByCell(bool on) { scanByCell = on; }
 
 	inline static int PackSquare(int x, int y);
 	inline static void UnpackSquare(int sq, int &x, int &y);
@@ -96,7 +106,17 @@ private:
 
 	int mapWidth;
 	int mapHeight;
-	std::vector<const unsigned char *> map;
+	// walkable map, packed as 1 bit per cell; each line is padded to whole words,
+	// which lets to test up to 64 cells at once when scanning for jump points
+	typedef uint64_t tGridWord;
+	static const int GRID_WORD_BITS = 64;
+	static const int GRID_WORD_SHIFT = 6;
+	// row-major grid, 'rowWords' words per map row
+	std::vector<tGridWord> gridRows;
+	int rowWords;
+	// transposed grid (column-major), 'colWords' words per map column
+	std::vector<tGridWord> gridCols;
+	int colWords;
 
 	typedef unsigned short tFrameId;
 	typedef int tPrev;
@@ -140,6 +160,8 @@ private:
 
 	bool navLock;
 
+	bool scanByCell;
+
 	void IncFrameId();
 
 	// outside map test
@@ -151,8 +173,19 @@ private:
 
 	void AddPruned(int *buf, int &bcount, int x, int y) const;
 	bool HasForcedNeighbor(int x, int y, int dx, int dy) const;
+	// gets a grid's word, returns an empty word for out of map positions
+	static inline tGridWord GridWord(const std::vector<tGridWord> &grid, int stride, int numLines, int line, int w);
+	// scans a grid line from (but not including) pos in dir (+1 or -1) direction;
+	// returns the first position which is either not passable or has a forced
+	// neighbour (in either adjacent line); result may be outside of the map
+	static int ScanLine(const std::vector<tGridWord> &grid, int stride, int numLines, int lineLen,
+		int line, int pos, int dir);
+	// index of the lowest / highest set bit, word must be non-zero
+	static inline int LowBit(tGridWord w);
+	static inline int HighBit(tGridWord w);
 	int FindJump(int x, int y, int dx, int dy, int ex, int ey);
 	int FindOrthoJump(int x, int y, int dx, int dy, int ex, int ey);
+	int FindOrthoJumpByCell(int x, int y, int dx, int dy, int ex, int ey);
 
 	// neighbor reachable (nodiag only)
 	bool Reachable(int x0, int y0, int x1, int y1) const;
@@ -190,26 +223,64 @@ const float Navigation::DIST_SCALE_UNPACK = 1.0f / Navigation::DIST_SCALE_PACK;
 Navigation::Navigation()
 	: mapWidth(0)
 	, mapHeight(0)
+	, rowWords(0)
+	, colWords(0)
 	, frameId(1)
 	, cnode(0)
 	, closest(0)
 	// no diagonal route - this should correspond to what AGS does
 	, nodiag(true)
 	, navLock(false)
+	, scanByCell(false)
 {
 }
 
 void Navigation::Resize(int width, int height)
 {
+	// same size: keep the grids, rows are compared to the old ones when assigned
+	if (width == mapWidth && height == mapHeight)
+		return;
+
 	mapWidth = width;
 	mapHeight = height;
 
 	int size = mapWidth*mapHeight;
 
-	map.resize(mapHeight);
+	rowWords = (mapWidth + GRID_WORD_BITS - 1) >> GRID_WORD_SHIFT;
+	colWords = (mapHeight + GRID_WORD_BITS - 1) >> GRID_WORD_SHIFT;
+	// grids are updated by the changed bits, so must be cleared first
+	gridRows.assign(rowWords*mapHeight, 0);
+	gridCols.assign(colWords*mapWidth, 0);
 	mapNodes.resize(size);
 }
 
+void Navigation::SetMapRow(int y, const unsigned char *row)
+{
+	tGridWord *dst = &gridRows[y*rowWords];
+	const tGridWord ybit = (tGridWord)1 << (y & (GRID_WORD_BITS - 1));
+	const int ycol = y >> GRID_WORD_SHIFT;
+
+	for (int w = 0; w < rowWords; w++)
+	{
+		const int x0 = w << GRID_WORD_SHIFT;
+		const int x1 = std::min(x0 + GRID_WORD_BITS, mapWidth);
+		tGridWord bits = 0;
+
+		for (int x = x0; x < x1; x++)
+		{
+			if (row[x] != 0)
+				bits |= (tGridWord)1 << (x - x0);
+		}
+
+		// the transposed grid is only updated for the cells that changed,
+		// as the same mask is usually assigned again before each search
+		for (tGridWord diff = dst[w] ^ bits; diff; diff &= diff - 1)
+			gridCols[(x0 + LowBit(diff))*colWords + ycol] ^= ybit;
+
+		dst[w] = bits;
+	}
+}
+
 void Navigation::IncFrameId()
 {
 	if (++frameId == 0)
@@ -241,8 +312,48 @@ inline bool Navigation::Outside(int x, int y) const
 
 inline bool Navigation::Walkable(int x, int y) const
 {
-	// invert condition because of AGS
-	return map[y][x] != 0;
+	return ((gridRows[y*rowWords + (x >> GRID_WORD_SHIFT)] >> (x & (GRID_WORD_BITS - 1))) & 1) != 0;
+}
+
+inline Navigation::tGridWord Navigation::GridWord(const std::vector<tGridWord> &grid, int stride, int numLines, int line, int w)
+{
+	if ((unsigned)line >= (unsigned)numLines || (unsigned)w >= (unsigned)stride)
+		return 0;
+	return grid[line*stride + w];
+}
+
+inline int Navigation::LowBit(tGridWord w)
+{
+	assert(w);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(w);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, w);
+	return (int)index;
+#else
+	int index = 0;
+	for (; !(w & 1); w >>= 1)
+		index++;
+	return index;
+#endif
+}
+
+inline int Navigation::HighBit(tGridWord w)
+{
+	assert(w);
+#if defined(__GNUC__) || defined(__clang__)
+	return (GRID_WORD_BITS - 1) - __builtin_clzll(w);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanReverse64(&index, w);
+	return (int)index;
+#else
+	int index = GRID_WORD_BITS - 1;
+	for (; !(w >> (GRID_WORD_BITS - 1)); w <<= 1)
+		index--;
+	return index;
+#endif
 }
 
 bool Navigation::Passable(int x, int y) const
@@ -287,10 +398,103 @@ bool Navigation::HasForcedNeighbor(int x, int y, int dx, int dy) const
 		(!Passable(x, y - dy) && Passable(x + dx, y - dy));
 }
 
+int Navigation::ScanLine(const std::vector<tGridWord> &grid, int stride, int numLines, int lineLen,
+	int line, int pos, int dir)
+{
+	const int first = pos + dir;
+	if ((unsigned)first >= (unsigned)lineLen)
+		return first;
+
+	// a cell stops the scan if it's not passable, or if there's a wall
+	// next to it in the adjacent line, but the cell ahead of that wall is free;
+	// this is same as HasForcedNeighbor test, but done for the whole word
+	int w = first >> GRID_WORD_SHIFT;
+	tGridWord mask = (dir > 0) ?
+		~(tGridWord)0 << (first & (GRID_WORD_BITS - 1)) :
+		~(tGridWord)0 >> ((GRID_WORD_BITS - 1) - (first & (GRID_WORD_BITS - 1)));
+
+	for (; w >= 0 && w < stride; w += dir, mask = ~(tGridWord)0)
+	{
+		const tGridWord cur = GridWord(grid, stride, numLines, line, w);
+		const tGridWord prev = GridWord(grid, stride, numLines, line - 1, w);
+		const tGridWord next = GridWord(grid, stride, numLines, line + 1, w);
+		tGridWord prevAhead, nextAhead;
+
+		if (dir > 0)
+		{
+			prevAhead = (prev >> 1) | (GridWord(grid, stride, numLines, line - 1, w + 1) << (GRID_WORD_BITS - 1));
+			nextAhead = (next >> 1) | (GridWord(grid, stride, numLines, line + 1, w + 1) << (GRID_WORD_BITS - 1));
+		}
+		else
+		{
+			prevAhead = (prev << 1) | (GridWord(grid, stride, numLines, line - 1, w - 1) >> (GRID_WORD_BITS - 1));
+			nextAhead = (next << 1) | (GridWord(grid, stride, numLines, line + 1, w - 1) >> (GRID_WORD_BITS - 1));
+		}
+
+		const tGridWord stop = (~cur | (~prev & prevAhead) | (~next & nextAhead)) & mask;
+
+		if (stop)
+			return (w << GRID_WORD_SHIFT) + ((dir > 0) ? LowBit(stop) : HighBit(stop));
+	}
+
+	// ran off the map
+	return (dir > 0) ? (stride << GRID_WORD_SHIFT) : -1;
+}
+
 int Navigation::FindOrthoJump(int x, int y, int dx, int dy, int ex, int ey)
 {
 	assert((!dx || !dy) && (dx || dy));
 
+	if (scanByCell)
+		return FindOrthoJumpByCell(x, y, dx, dy, ex, ey);
+
+	// scan along the line, either a row or a column (using transposed grid)
+	const bool horz = !dy;
+	const int dir = horz ? dx : dy;
+	const int line = horz ? y : x;
+	const int pos = horz ? x : y;
+	const int lineLen = horz ? mapWidth : mapHeight;
+	const int tline = horz ? ey : ex;
+	const int tpos = horz ? ex : ey;
+
+	int stop = horz ?
+		ScanLine(gridRows, rowWords, mapHeight, mapWidth, line, pos, dir) :
+		ScanLine(gridCols, colWords, mapWidth, mapHeight, line, pos, dir);
+
+	// stop cell is a jump point if it's passable (has forced neighbour),
+	// otherwise the scan ends on the preceding cell
+	bool found = (unsigned)stop < (unsigned)lineLen &&
+		(horz ? Walkable(stop, line) : Walkable(line, stop));
+	int last = found ? stop : stop - dir;
+
+	// target cell met on the way is a jump point too
+	if (line == tline && (tpos - pos) * dir > 0 && (tpos - last) * dir <= 0)
+	{
+		stop = last = tpos;
+		found = true;
+	}
+
+	// nothing passed
+	if ((last - pos) * dir <= 0)
+		return -1;
+
+	// update closest to the target node, which is the passed cell nearest to the target
+	const int cpos = iclamp(tpos, std::min(pos + dir, last), std::max(pos + dir, last));
+	const int edist = ClosestDist(cpos - tpos, line - tline);
+
+	if (edist < closest)
+	{
+		closest = edist;
+		cnode = horz ? PackSquare(cpos, line) : PackSquare(line, cpos);
+	}
+
+	if (!found)
+		return -1;
+	return horz ? PackSquare(stop, line) : PackSquare(line, stop);
+}
+
+int Navigation::FindOrthoJumpByCell(int x, int y, int dx, int dy, int ex, int ey)
+{
 	for (;;)
 	{
 		x += dx;
@@ -23,10 +23,26 @@
 #include "ac/dynobj/scriptset.h"
 #include "ac/dynobj/scriptstring.h"
 #include "ac/dynobj/dynobj_manager.h"
+#include "debug/debug_log.h"
 #include "script/script_api.h"
 #include "script/script_runtime.h"
 #include "util/bbop.h"
 
+// Max number of items which may be reserved by a script at once;
+// larger requests are most likely script mistakes, and are clamped
+static const int MaxReserveItems = 1024 * 1024;
+
+static int ClampReserveCapacity(const char *api_name, int capacity)
+{
+    if (capacity > MaxReserveItems)
+    {
+        debug_script_warn("%s: requested capacity %d is too large, clamped to %d",
+            api_name, capacity, MaxReserveItems);
+        return MaxReserveItems;
+    }
+    return capacity;
+}
+
 //=============================================================================
 //
 // Dictionary of strings script API.
@@ -113,6 +129,17 @@ int Dict_GetItemCount(ScriptDictBase *dic)
     return dic->GetItemCount();
 }
 
+void Dict_Reserve(ScriptDictBase *dic, int capacity)
+{
+    if (capacity > 0)
+        dic->Reserve(ClampReserveCapacity("Dictionary.Reserve", capacity));
+}
+
+int Dict_GetCapacity(ScriptDictBase *dic)
+{
+    return dic->GetCapacity();
+}
+
 void *Dict_GetKeysAsArray(ScriptDictBase *dic)
 {
     std::vector<const char*> items;
@@ -178,6 +205,16 @@ RuntimeScriptValue Sc_Dict_GetItemCount(void *self, const RuntimeScriptValue *pa
     API_OBJCALL_INT(ScriptDictBase, Dict_GetItemCount);
 }
 
+RuntimeScriptValue Sc_Dict_Reserve(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_PINT(ScriptDictBase, Dict_Reserve);
+}
+
+RuntimeScriptValue Sc_Dict_GetCapacity(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_INT(ScriptDictBase, Dict_GetCapacity);
+}
+
 RuntimeScriptValue Sc_Dict_GetKeysAsArray(void *self, const RuntimeScriptValue *params, int32_t param_count)
 {
     API_OBJCALL_OBJ(ScriptDictBase, void, globalDynamicArray, Dict_GetKeysAsArray);
@@ -268,6 +305,17 @@ int Set_GetItemCount(ScriptSetBase *set)
     return set->GetItemCount();
 }
 
+void Set_Reserve(ScriptSetBase *set, int capacity)
+{
+    if (capacity > 0)
+        set->Reserve(ClampReserveCapacity("Set.Reserve", capacity));
+}
+
+int Set_GetCapacity(ScriptSetBase *set)
+{
+    return set->GetCapacity();
+}
+
 void *Set_GetItemsAsArray(ScriptSetBase *set)
 {
     std::vector<const char*> items;
@@ -318,6 +366,16 @@ RuntimeScriptValue Sc_Set_GetItemCount(void *self, const RuntimeScriptValue *par
     API_OBJCALL_INT(ScriptSetBase, Set_GetItemCount);
 }
 
+RuntimeScriptValue Sc_Set_Reserve(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_PINT(ScriptSetBase, Set_Reserve);
+}
+
+RuntimeScriptValue Sc_Set_GetCapacity(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_INT(ScriptSetBase, Set_GetCapacity);
+}
+
 RuntimeScriptValue Sc_Set_GetItemsAsArray(void *self, const RuntimeScriptValue *params, int32_t param_count)
 {
     API_OBJCALL_OBJ(ScriptSetBase, void, globalDynamicArray, Set_GetItemsAsArray);
@@ -338,6 +396,8 @@ void RegisterContainerAPI()
         { "Dictionary::get_CompareStyle", API_FN_PAIR(Dict_GetCompareStyle) },
         { "Dictionary::get_SortStyle",  API_FN_PAIR(Dict_GetSortStyle) },
         { "Dictionary::get_ItemCount",  API_FN_PAIR(Dict_GetItemCount) },
+        { "Dictionary::Reserve",        API_FN_PAIR(Dict_Reserve) },
+        { "Dictionary::get_Capacity",   API_FN_PAIR(Dict_GetCapacity) },
         { "Dictionary::GetKeysAsArray", API_FN_PAIR(Dict_GetKeysAsArray) },
         { "Dictionary::GetValuesAsArray", API_FN_PAIR(Dict_GetValuesAsArray) },
         // Set
@@ -349,6 +409,8 @@ void RegisterContainerAPI()
         { "Set::get_CompareStyle",      API_FN_PAIR(Set_GetCompareStyle) },
         { "Set::get_SortStyle",         API_FN_PAIR(Set_GetSortStyle) },
         { "Set::get_ItemCount",         API_FN_PAIR(Set_GetItemCount) },
+        { "Set::Reserve",               API_FN_PAIR(Set_Reserve) },
+        { "Set::get_Capacity",          API_FN_PAIR(Set_GetCapacity) },
         { "Set::GetItemsAsArray",       API_FN_PAIR(Set_GetItemsAsArray) },
     };
 
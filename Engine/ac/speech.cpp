@@ -17,6 +17,7 @@
 #include "ac/game.h"
 #include "ac/gamesetup.h"
 #include "ac/gamestate.h"
+#include "ac/roomcache.h"
 #include "ac/runtime_defines.h"
 #include "ac/dynobj/scriptoverlay.h"
 #include "core/assetmanager.h"
@@ -105,7 +106,9 @@ bool init_voicepak(const String &name)
     if (ResPaths.SpeechPak.Name.CompareNoCase(speech_file) == 0)
         return true; // same pak already assigned
 
-    // First remove existing voice packs
+    // First remove existing voice packs; room prefetching must not be
+    // reading assets while the library list is modified
+    roomcache_stop_prefetch();
     ResPaths.VoiceAvail = false;
     AssetMgr->RemoveLibrary(ResPaths.SpeechPak.Path);
     AssetMgr->RemoveLibrary(ResPaths.VoiceDirSub);
@@ -22,6 +22,7 @@
 #include "ac/global_translation.h"
 #include "ac/runtime_defines.h"
 #include "ac/dynobj/scriptstring.h"
+#include "ac/dynobj/scriptstringbuilder.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "font/fonts.h"
 #include "debug/debug_log.h"
@@ -457,6 +458,45 @@ int String_GetLength(const char *thisString) {
 
 //=============================================================================
 
+ScriptStringBuilder *StringBuilder_Create(int capacity)
+{
+    if (capacity < 0)
+        quit("!StringBuilder.Create: invalid capacity");
+    ScriptStringBuilder *sb = new ScriptStringBuilder(capacity);
+    ccRegisterManagedObject(sb, sb);
+    return sb;
+}
+
+void StringBuilder_Append(ScriptStringBuilder *sb, const char *text)
+{
+    VALIDATE_STRING(text);
+    sb->Append(text);
+}
+
+void StringBuilder_AppendChar(ScriptStringBuilder *sb, int extraOne)
+{
+    sb->AppendChar(extraOne);
+}
+
+void StringBuilder_Clear(ScriptStringBuilder *sb)
+{
+    sb->Clear();
+}
+
+const char *StringBuilder_ToString(ScriptStringBuilder *sb)
+{
+    auto buf = ScriptString::CreateBuffer(sb->GetLength(), sb->GetULength());
+    memcpy(buf.Get(), sb->GetCStr(), sb->GetLength() + 1);
+    return CreateNewScriptString(std::move(buf));
+}
+
+int StringBuilder_GetLength(ScriptStringBuilder *sb)
+{
+    return sb->GetULength();
+}
+
+//=============================================================================
+
 size_t break_up_text_into_lines(const char *todis, bool apply_direction, SplitLines &lines, int wii, int fonnt, size_t max_lines)
 {
     lines.Reset();
@@ -650,6 +690,43 @@ RuntimeScriptValue Sc_String_GetLength(void *self, const RuntimeScriptValue *par
     return RuntimeScriptValue().SetInt32(String_GetLength((const char*)self));
 }
 
+RuntimeScriptValue Sc_StringBuilder_Create(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_OBJAUTO_PINT(ScriptStringBuilder, StringBuilder_Create);
+}
+
+RuntimeScriptValue Sc_StringBuilder_Append(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_POBJ(ScriptStringBuilder, StringBuilder_Append, const char);
+}
+
+RuntimeScriptValue Sc_StringBuilder_AppendChar(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID_PINT(ScriptStringBuilder, StringBuilder_AppendChar);
+}
+
+RuntimeScriptValue Sc_StringBuilder_AppendFormat(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_SCRIPT_SPRINTF(StringBuilder_AppendFormat, 1);
+    StringBuilder_Append((ScriptStringBuilder*)self, scsf_buffer);
+    return RuntimeScriptValue((int32_t)0);
+}
+
+RuntimeScriptValue Sc_StringBuilder_Clear(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_VOID(ScriptStringBuilder, StringBuilder_Clear);
+}
+
+RuntimeScriptValue Sc_StringBuilder_ToString(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_OBJ(ScriptStringBuilder, const char, myScriptStringImpl, StringBuilder_ToString);
+}
+
+RuntimeScriptValue Sc_StringBuilder_GetLength(void *self, const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_OBJCALL_INT(ScriptStringBuilder, StringBuilder_GetLength);
+}
+
 //=============================================================================
 //
 // Exclusive variadic API implementation for Plugins
@@ -663,6 +740,13 @@ const char *ScPl_String_Format(const char *texx, ...)
     return CreateNewScriptString(scsf_buffer);
 }
 
+// void (ScriptStringBuilder *sb, const char *texx, ...)
+void ScPl_StringBuilder_AppendFormat(ScriptStringBuilder *sb, const char *texx, ...)
+{
+    API_PLUGIN_SCRIPT_SPRINTF(texx);
+    StringBuilder_Append(sb, scsf_buffer);
+}
+
 
 void RegisterStringAPI()
 {
@@ -691,6 +775,14 @@ void RegisterStringAPI()
         { "String::get_AsInt",        API_FN_PAIR(StringToInt) },
         { "String::geti_Chars",       API_FN_PAIR(String_GetChars) },
         { "String::get_Length",       API_FN_PAIR(String_GetLength) },
+
+        { "StringBuilder::Create^1",  API_FN_PAIR(StringBuilder_Create) },
+        { "StringBuilder::Append^1",  API_FN_PAIR(StringBuilder_Append) },
+        { "StringBuilder::AppendChar^1", API_FN_PAIR(StringBuilder_AppendChar) },
+        { "StringBuilder::AppendFormat^101", Sc_StringBuilder_AppendFormat, ScPl_StringBuilder_AppendFormat },
+        { "StringBuilder::Clear^0",   API_FN_PAIR(StringBuilder_Clear) },
+        { "StringBuilder::ToString^0", API_FN_PAIR(StringBuilder_ToString) },
+        { "StringBuilder::get_Length", API_FN_PAIR(StringBuilder_GetLength) },
     };
 
     ccAddExternalFunctions(string_api);
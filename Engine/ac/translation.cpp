@@ -12,6 +12,9 @@
 //
 //=============================================================================
 #include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
 #include "ac/asset_helper.h"
 #include "ac/common.h"
 #include "ac/game.h"
@@ -32,13 +35,122 @@ using namespace AGS::Common;
 
 extern GameSetupStruct game;
 
+// TranslationIndex is a compact read-only lookup table for the translation
+// dictionary. All the texts are stored in a single arena of null-terminated
+// strings, and the table is an open-addressing hash with linear probing,
+// which lets find a translation without any allocations or string copies.
+class TranslationIndex
+{
+public:
+    void Build(const StringMap &dict)
+    {
+        Clear();
+        if (dict.empty())
+            return;
+        size_t arena_size = 0;
+        for (const auto &item : dict)
+            arena_size += item.first.GetLength() + item.second.GetLength() + 2;
+        _arena.reserve(arena_size);
+        // Keep load factor at 0.5 or less, for short probe sequences
+        size_t capacity = 16;
+        while (capacity < dict.size() * 2)
+            capacity <<= 1;
+        _slots.resize(capacity);
+        _mask = capacity - 1;
+        for (const auto &item : dict)
+        {
+            Slot slot;
+            slot.Hash = static_cast<uint32_t>(FNV::Hash(item.first.GetCStr(), item.first.GetLength()));
+            slot.KeyLen = static_cast<uint32_t>(item.first.GetLength());
+            slot.KeyOff = AddText(item.first);
+            slot.ValueOff = AddText(item.second);
+            size_t i = slot.Hash & _mask;
+            while (_slots[i].ValueOff != NoText)
+                i = (i + 1) & _mask;
+            _slots[i] = slot;
+        }
+        _count = dict.size();
+    }
+
+    void Clear()
+    {
+        _arena = std::vector<char>();
+        _slots = std::vector<Slot>();
+        _mask = 0;
+        _count = 0;
+    }
+
+    size_t GetCount() const { return _count; }
+
+    const char *Find(const char *text) const
+    {
+        if (_count == 0)
+            return nullptr;
+        // Hash and measure the text in one pass; same as FNV::Hash
+        uint32_t hash = FNV::PRIME_NUMBER;
+        size_t len = 0;
+        for (const char *p = text; *p; ++p, ++len)
+            hash = (FNV::SECONDARY_NUMBER * hash) ^ (uint8_t)(*p);
+        for (size_t i = hash & _mask; _slots[i].ValueOff != NoText; i = (i + 1) & _mask)
+        {
+            const Slot &slot = _slots[i];
+            if ((slot.Hash == hash) && (slot.KeyLen == len) &&
+                (memcmp(&_arena[slot.KeyOff], text, len) == 0))
+                return &_arena[slot.ValueOff];
+        }
+        return nullptr;
+    }
+
+private:
+    static const uint32_t NoText = UINT32_MAX;
+
+    struct Slot
+    {
+        uint32_t Hash = 0u;
+        uint32_t KeyLen = 0u;
+        uint32_t KeyOff = NoText;
+        uint32_t ValueOff = NoText;
+    };
+
+    uint32_t AddText(const String &text)
+    {
+        const uint32_t off = static_cast<uint32_t>(_arena.size());
+        _arena.insert(_arena.end(), text.GetCStr(), text.GetCStr() + text.GetLength() + 1);
+        return off;
+    }
+
+    std::vector<char> _arena;
+    std::vector<Slot> _slots;
+    size_t _mask = 0u;
+    size_t _count = 0u;
+};
+
 String trans_name;
 String trans_filename;
 Translation trans;
+TranslationIndex trans_index;
+// Ranges of immutable texts, registered as begin -> end
+std::unordered_map<const char*, const char*> trans_static_ranges;
+// Lookup results for the texts found in the static ranges, by address;
+// nullptr value means that the text has no translation
+std::unordered_map<const char*, const char*> trans_static_cache;
+
+
+static bool is_static_text(const char *text)
+{
+    for (const auto &range : trans_static_ranges)
+    {
+        if ((text >= range.first) && (text < range.second))
+            return true;
+    }
+    return false;
+}
 
 
 void close_translation () {
     trans = Translation();
+    trans_index.Clear();
+    trans_static_cache.clear();
     trans_name = "";
     trans_filename = "";
 
@@ -64,6 +176,8 @@ bool init_translation(const String &lang, const String &fallback_lang)
     }
 
     trans = Translation();
+    trans_index.Clear();
+    trans_static_cache.clear();
 
     // First test if the translation is meant for this game
     HError err = TestTraGameID(game.uniqueid, game.gamename, std::move(in));
@@ -146,6 +260,10 @@ bool init_translation(const String &lang, const String &fallback_lang)
         }
     }
 
+    // Pack the dictionary into the lookup index, and release the map
+    trans_index.Build(trans.Dict);
+    trans.Dict = StringMap();
+
     Debug::Printf(kDbgMsg_Info, "Translation initialized: %s (format: %s)", trans_name.GetCStr(), encoding_msg.GetCStr());
     return true;
 }
@@ -160,7 +278,36 @@ String get_translation_path()
     return trans_filename;
 }
 
-const StringMap& get_translation_tree()
+size_t get_translation_count()
+{
+    return trans_index.GetCount();
+}
+
+const char *find_translation(const char *text)
+{
+    if (trans_index.GetCount() == 0)
+        return nullptr;
+    if (trans_static_ranges.empty() || !is_static_text(text))
+        return trans_index.Find(text);
+
+    const auto it = trans_static_cache.find(text);
+    if (it != trans_static_cache.end())
+        return it->second;
+    const char *result = trans_index.Find(text);
+    trans_static_cache.insert(std::make_pair(text, result));
+    return result;
+}
+
+void translation_register_static_text(const char *begin, size_t size)
+{
+    if (!begin || size == 0)
+        return;
+    trans_static_ranges[begin] = begin + size;
+    trans_static_cache.clear();
+}
+
+void translation_unregister_static_text(const char *begin)
 {
-    return trans.Dict;
+    if (trans_static_ranges.erase(begin) > 0)
+        trans_static_cache.clear();
 }
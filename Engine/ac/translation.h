@@ -29,7 +29,14 @@ bool init_translation (const String &lang, const String &fallback_lang);
 String get_translation_name();
 // Returns fill path to the translation file, or empty string if default translation is used
 String get_translation_path();
-// Returns translation map for reading only
-const StringMap &get_translation_tree();
+// Returns number of entries in the loaded translation
+size_t get_translation_count();
+// Looks up a translation for the given text; returns nullptr if there's none
+const char *find_translation(const char *text);
+// Registers a memory range containing immutable texts (e.g. script's string
+// literals), which lookup results may be cached for, by their address.
+// The range must be unregistered before the memory is released.
+void translation_register_static_text(const char *begin, size_t size);
+void translation_unregister_static_text(const char *begin);
 
 #endif // __AGS_EE_AC__TRANSLATION_H
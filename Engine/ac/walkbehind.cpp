@@ -20,6 +20,7 @@
 #include "ac/dynobj/scriptobjects.h"
 #include "ac/dynobj/cc_walkbehind.h"
 #include "gfx/bitmap.h"
+#include "gfx/bitmapdata.h"
 #include "gfx/graphicsdriver.h"
 
 
@@ -32,14 +33,14 @@ extern RoomStatus *croom;
 extern ScriptWalkbehind scrWalkbehind[MAX_WALK_BEHINDS];
 extern CCWalkbehind ccDynamicWalkbehind;
 
-// An info on vertical column of walk-behind mask, which may contain WB area
-struct WalkBehindColumn
+// An info on horizontal row of walk-behind mask, which may contain WB area
+struct WalkBehindRow
 {
-    bool Exists = false; // whether any WB area is in this column
-    int Y1 = 0, Y2 = 0; // WB top and bottom Y coords
+    bool Exists = false; // whether any WB area is in this row
+    int X1 = 0, X2 = 0; // WB left and right X coords (X2 is exclusive)
 };
 
-std::vector<WalkBehindColumn> walkBehindCols; // precalculated WB positions
+std::vector<WalkBehindRow> walkBehindRows; // precalculated WB positions
 Rect walkBehindAABB[MAX_WALK_BEHINDS]; // WB bounding box
 int walkBehindsCachedForBgNum = 0; // WB textures are for this background
 bool noWalkBehindsAtAll = false; // quick report that no WBs in this room
@@ -53,6 +54,7 @@ void walkbehinds_generate_sprites()
     const Bitmap *bg = thisroom.BgFrames[play.bg_frame].Graphic.get();
     
     const int coldepth = bg->GetColorDepth();
+    const int bpp = bg->GetBPP();
     Bitmap wbbmp; // temp buffer
     // Iterate through walk-behinds and generate a texture for each of them
     for (int wb = 1 /* 0 is "no area" */; wb < MAX_WALK_BEHINDS; ++wb)
@@ -65,28 +67,9 @@ void walkbehinds_generate_sprites()
             const int sx = pos.Left, ex = pos.Right, sy = pos.Top, ey = pos.Bottom;
             for (int y = sy; y <= ey; ++y)
             {
-                const uint8_t *check_line = mask->GetScanLine(y);
-                const uint8_t *src_line = bg->GetScanLine(y);
-                uint8_t *dst_line = wbbmp.GetScanLineForWriting(y - sy);
-                for (int x = sx; x <= ex; ++x)
-                {
-                    if (check_line[x] != wb) continue;
-                    switch (coldepth)
-                    {
-                    case 8:
-                        dst_line[(x - sx)] = src_line[x];
-                        break;
-                    case 16:
-                        reinterpret_cast<uint16_t*>(dst_line)[(x - sx)] =
-                            reinterpret_cast<const uint16_t*>(src_line)[x];
-                        break;
-                    case 32:
-                        reinterpret_cast<uint32_t*>(dst_line)[(x - sx)] =
-                            reinterpret_cast<const uint32_t*>(src_line)[x];
-                        break;
-                    default: assert(0); break;
-                    }
-                }
+                PixelOp::CopyPixelsMasked(wbbmp.GetScanLineForWriting(y - sy),
+                    bg->GetScanLine(y) + sx * bpp, mask->GetScanLine(y) + sx,
+                    static_cast<uint8_t>(wb), bpp, ex - sx + 1);
             }
             // Add to walk-behinds image list
             add_walkbehind_image(wb, &wbbmp, pos.Left, pos.Top);
@@ -103,49 +86,38 @@ bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
     if (noWalkBehindsAtAll)
         return false;
 
+    // Mark the walk-behind areas which are in front of the sprite
+    uint8_t wb_covers[256] = {};
+    bool any_covers = false;
+    for (int wb = 1 /* 0 is "no area" */; wb < MAX_WALK_BEHINDS; ++wb)
+    {
+        wb_covers[wb] = croom->walkbehind_base[wb] > basel;
+        any_covers |= (wb_covers[wb] != 0);
+    }
+    if (!any_covers)
+        return false;
+
+    const Bitmap *mask = thisroom.WalkBehindMask.get();
     const int maskcol = sprit->GetMaskColor();
-    const int spcoldep = sprit->GetColorDepth();
+    const int bpp = sprit->GetBPP();
 
     bool pixels_changed = false;
-    // pass along the sprite's pixels, but skip those that lie outside the mask
-    for (int x = std::max(0, 0 - sprx);
-        (x < sprit->GetWidth()) && (x + sprx < thisroom.WalkBehindMask->GetWidth()); ++x)
+    // pass along the sprite's rows, but skip those that lie outside the mask
+    for (int y = std::max(0, 0 - spry);
+        (y < sprit->GetHeight()) && (y + spry < mask->GetHeight()); ++y)
     {
-        // select the WB column at this x
-        const auto &wbcol = walkBehindCols[x + sprx];
-        // skip if no area, or sprite lies outside of all areas in this column
-        if ((!wbcol.Exists) ||
-            (wbcol.Y2 <= spry) ||
-            (wbcol.Y1 > spry + sprit->GetHeight()))
+        // select the WB row at this y
+        const auto &wbrow = walkBehindRows[y + spry];
+        if (!wbrow.Exists)
             continue;
-
-        // ensure we only check within the valid areas (between Y1 and Y2)
-        // we assume that Y1 and Y2 are always within the mask
-        for (int y = std::max(0, wbcol.Y1 - spry);
-            (y < sprit->GetHeight()) && (y + spry < wbcol.Y2); ++y)
-        {
-            const int wb = thisroom.WalkBehindMask->GetScanLine(y + spry)[x + sprx];
-            if (wb < 1) continue; // "no area"
-            if (croom->walkbehind_base[wb] <= basel) continue;
-
-            pixels_changed = true;
-            uint8_t *dst_line = sprit->GetScanLineForWriting(y);
-            switch (spcoldep)
-            {
-            case 8:
-                dst_line[x] = maskcol;
-                break;
-            case 16:
-                reinterpret_cast<uint16_t*>(dst_line)[x] = maskcol;
-                break;
-            case 32:
-                reinterpret_cast<uint32_t*>(dst_line)[x] = maskcol;
-                break;
-            default:
-                assert(0);
-                break;
-            }
-        }
+        // ensure we only check within the valid areas (between X1 and X2)
+        // we assume that X1 and X2 are always within the mask
+        const int x1 = std::max(0, wbrow.X1 - sprx);
+        const int x2 = std::min(sprit->GetWidth(), wbrow.X2 - sprx);
+        if (x1 >= x2)
+            continue;
+        pixels_changed |= PixelOp::FillPixelsMasked(sprit->GetScanLineForWriting(y) + x1 * bpp,
+            mask->GetScanLine(y + spry) + x1 + sprx, wb_covers, maskcol, bpp, x2 - x1);
     }
     return pixels_changed;
 }
@@ -153,38 +125,42 @@ bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
 void walkbehinds_recalc()
 {
     // Reset all data
-    walkBehindCols.clear();
+    walkBehindRows.clear();
     for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
     {
         walkBehindAABB[wb] = Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
     }
     noWalkBehindsAtAll = true;
 
-    // Recalculate everything; note that mask is always 8-bit
+    // Recalculate everything in a single pass over the mask rows;
+    // note that mask is always 8-bit
     const Bitmap *mask = thisroom.WalkBehindMask.get();
-    walkBehindCols.resize(mask->GetWidth());
-    for (int col = 0; col < mask->GetWidth(); ++col)
+    const int width = mask->GetWidth();
+    walkBehindRows.resize(mask->GetHeight());
+    for (int y = 0; y < mask->GetHeight(); ++y)
     {
-        auto &wbcol = walkBehindCols[col];
-        for (int y = 0; y < mask->GetHeight(); ++y)
+        auto &wbrow = walkBehindRows[y];
+        const uint8_t *check_line = mask->GetScanLine(y);
+        // skip the "no area" pixels in bulk, and test only the rest
+        for (int x = PixelOp::FindNonZero(check_line, width); x < width;
+            x += 1 + PixelOp::FindNonZero(check_line + x + 1, width - x - 1))
         {
-            int wb = mask->GetScanLine(y)[col];
+            int wb = check_line[x];
             // Valid areas start with index 1, 0 = no area
-            if ((wb >= 1) && (wb < MAX_WALK_BEHINDS))
+            if (wb >= MAX_WALK_BEHINDS)
+                continue;
+            if (!wbrow.Exists)
             {
-                if (!wbcol.Exists)
-                {
-                    wbcol.Y1 = y;
-                    wbcol.Exists = true;
-                    noWalkBehindsAtAll = false;
-                }
-                wbcol.Y2 = y + 1; // +1 to allow bottom line of screen to work (CHECKME??)
-                // resize the bounding rect
-                walkBehindAABB[wb].Left = std::min(col, walkBehindAABB[wb].Left);
-                walkBehindAABB[wb].Top = std::min(y, walkBehindAABB[wb].Top);
-                walkBehindAABB[wb].Right = std::max(col, walkBehindAABB[wb].Right);
-                walkBehindAABB[wb].Bottom = std::max(y, walkBehindAABB[wb].Bottom);
+                wbrow.X1 = x;
+                wbrow.Exists = true;
+                noWalkBehindsAtAll = false;
             }
+            wbrow.X2 = x + 1;
+            // resize the bounding rect
+            walkBehindAABB[wb].Left = std::min(x, walkBehindAABB[wb].Left);
+            walkBehindAABB[wb].Top = std::min(y, walkBehindAABB[wb].Top);
+            walkBehindAABB[wb].Right = std::max(x, walkBehindAABB[wb].Right);
+            walkBehindAABB[wb].Bottom = std::max(y, walkBehindAABB[wb].Bottom);
         }
     }
 }
@@ -11,6 +11,8 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
+#include <thread>
 #include "ac/button.h"
 #include "ac/character.h"
 #include "ac/common.h"
@@ -57,7 +59,10 @@
 #include "plugin/plugin_engine.h"
 #include "script/script.h"
 #include "script/cc_common.h"
+#include "util/directory.h"
 #include "util/file.h"
+#include "util/memorystream.h"
+#include "util/path.h"
 #include "util/memory_compat.h"
 #include "util/stream.h"
 #include "util/string_utils.h"
@@ -163,6 +168,8 @@ String GetSavegameErrorText(SavegameErrorType err)
         return "Saved with the engine running at a different colour depth.";
     case kSvgErr_GameObjectInitFailed:
         return "Game object initialization failed after save restoration.";
+    case kSvgErr_BaseSaveMismatch:
+        return "Base save of the delta save is missing or does not match.";
     default:
         return "Unknown error.";
     }
@@ -291,13 +298,52 @@ HSaveError OpenSavegameBase(const String &filename, SavegameSource *src, Savegam
     return err;
 }
 
+// Max length of the delta saves chain, for the sanity check
+static const int MaxBaseSaveChain = 16;
+
+// Reads the data of all the components which a delta save takes from its base
+// saves, following the chain of base saves; each base save is opened once.
+// Fails if any base save is missing, or does not match the delta save.
+static HSaveError ResolveBaseSaves(const String &filename, SavegameSource &src)
+{
+    String base_save;
+    SavegameComponents::ComponentHashes refs;
+    HSaveError err = SavegameComponents::ReadBaseRefs(src.InputStream.get(), src.Version, base_save, refs);
+    if (!err)
+        return err;
+    const String svg_dir = Path::GetParent(filename);
+    for (int depth = 0; !refs.empty(); ++depth)
+    {
+        if (base_save.IsEmpty())
+            return new SavegameError(kSvgErr_InconsistentFormat, "Components refer to the base save, but there's none.");
+        if (depth >= MaxBaseSaveChain)
+            return new SavegameError(kSvgErr_BaseSaveMismatch, "Delta saves chain is too long.");
+        SavegameSource base_src;
+        String next_base;
+        err = OpenSavegameBase(Path::ConcatPaths(svg_dir, base_save), &base_src, nullptr, kSvgDesc_None);
+        if (err)
+            err = SavegameComponents::ReadBaseComponents(base_src.InputStream.get(), base_src.Version,
+                refs, src.BaseData, next_base);
+        if (!err)
+            return new SavegameError(kSvgErr_BaseSaveMismatch, String::FromFormat("Base save: %s", base_save.GetCStr()), err);
+        base_save = next_base;
+    }
+    return HSaveError::None();
+}
+
 HSaveError OpenSavegame(const String &filename, SavegameSource &src, SavegameDescription &desc, SavegameDescElem elems)
 {
-    return OpenSavegameBase(filename, &src, &desc, elems);
+    // The file may still be written by the background thread
+    WaitForSavegameWrite();
+    HSaveError err = OpenSavegameBase(filename, &src, &desc, elems);
+    if (!err)
+        return err;
+    return ResolveBaseSaves(filename, src);
 }
 
 HSaveError OpenSavegame(const String &filename, SavegameDescription &desc, SavegameDescElem elems)
 {
+    WaitForSavegameWrite();
     return OpenSavegameBase(filename, nullptr, &desc, elems);
 }
 
@@ -603,12 +649,12 @@ HSaveError DoAfterRestore(const PreservedParams &pp, RestoredData &r_data)
     return HSaveError::None();
 }
 
-HSaveError RestoreGameState(Stream *in, SavegameVersion svg_version)
+HSaveError RestoreGameState(SavegameSource &src)
 {
     PreservedParams pp;
     RestoredData r_data;
     DoBeforeRestore(pp);
-    HSaveError err = SavegameComponents::ReadAll(in, svg_version, pp, r_data);
+    HSaveError err = SavegameComponents::ReadAll(src.InputStream.get(), src.Version, src.BaseData, pp, r_data);
     if (!err)
         return err;
     return DoAfterRestore(pp, r_data);
@@ -675,10 +721,148 @@ void DoBeforeSave()
     }
 }
 
-void SaveGameState(Stream *out)
+std::unique_ptr<SavegameSnapshot> MakeGameStateSnapshot()
 {
     DoBeforeSave();
-    SavegameComponents::WriteAllCommon(out);
+    auto snap = std::make_unique<SavegameSnapshot>();
+    HSaveError err = SavegameComponents::WriteAllCommon(*snap);
+    if (!err)
+    {
+        Debug::Printf(kDbgMsg_Error, "ERROR: failed to serialize game state:\n%s",
+            err->FullMessage().GetCStr());
+    }
+    // Prepare a header, in case this snapshot will become a delta save base
+    Stream header_out(std::make_unique<VectorStream>(snap->BaseHeader, kStream_Write));
+    header_out.Write(SavegameSource::Signature.GetCStr(), SavegameSource::Signature.GetLength());
+    WriteDescription(&header_out, "", nullptr);
+    return snap;
+}
+
+// The thread which writes the last made savegame
+static std::thread SavegameWriteThread;
+// Current base save for the delta saves;
+// accessed only by the savegame writing procedure
+static String DeltaBaseDir;
+static SavegameComponents::SavegameBase DeltaBase;
+static size_t DeltaBaseSize = 0u;
+// Delta save is written against a new base if the size of the changed
+// components exceeds this fraction of the whole game state
+static const float DeltaBaseRenewRatio = 0.5f;
+
+// Deletes base saves that are not referenced by any savegame anymore
+static void DeleteUnusedDeltaBases(const String &svg_dir, const String &keep_base)
+{
+    std::vector<String> bases;
+    for (FindFile ff = FindFile::OpenFiles(svg_dir, "agsbase.*"); !ff.AtEnd(); ff.Next())
+    {
+        if (ff.Current().CompareNoCase(keep_base) != 0)
+            bases.push_back(ff.Current());
+    }
+    if (bases.empty())
+        return;
+    for (FindFile ff = FindFile::OpenFiles(svg_dir, "agssave.*"); !ff.AtEnd(); ff.Next())
+    {
+        SavegameSource src;
+        if (!OpenSavegameBase(Path::ConcatPaths(svg_dir, ff.Current()), &src, nullptr, kSvgDesc_None))
+            continue;
+        String base = SavegameComponents::ReadBaseSaveName(src.InputStream.get(), src.Version);
+        if (base.IsEmpty())
+            continue;
+        bases.erase(std::remove_if(bases.begin(), bases.end(),
+            [&base](const String &b) { return b.CompareNoCase(base) == 0; }), bases.end());
+    }
+    for (const auto &base : bases)
+        File::DeleteFile(Path::ConcatPaths(svg_dir, base));
+}
+
+// Writes a new base save for the following delta saves
+static bool WriteDeltaBase(const String &svg_dir, const SavegameSnapshot &snap)
+{
+    uint64_t base_id = 0u;
+    size_t full_size = 0u;
+    for (const auto &cmp : snap.Components)
+    {
+        base_id = (base_id * 31u) ^ cmp.Hash;
+        full_size += cmp.Data.size();
+    }
+    String base_name = String::FromFormat("agsbase.%08x%08x",
+        static_cast<uint32_t>(base_id >> 32), static_cast<uint32_t>(base_id));
+    auto out = File::CreateFile(Path::ConcatPaths(svg_dir, base_name));
+    if (!out)
+        return false;
+    out->Write(snap.BaseHeader.data(), snap.BaseHeader.size());
+    SavegameComponents::WriteSnapshot(out.get(), snap);
+    const bool success = !out->GetError();
+    out->Close();
+    if (!success)
+        return false;
+
+    DeltaBaseDir = svg_dir;
+    DeltaBaseSize = full_size;
+    DeltaBase.Filename = base_name;
+    DeltaBase.Components.clear();
+    for (const auto &cmp : snap.Components)
+        DeltaBase.Components[cmp.Name] = std::make_pair(cmp.Version, cmp.Hash);
+    return true;
+}
+
+// Tells whether the current delta base is valid and suits the given snapshot
+static bool IsDeltaBaseUsable(const String &svg_dir, const SavegameSnapshot &snap)
+{
+    if (DeltaBase.Filename.IsEmpty() || (Path::ComparePaths(DeltaBaseDir, svg_dir) != 0)
+        || !File::IsFile(Path::ConcatPaths(svg_dir, DeltaBase.Filename)))
+        return false;
+    size_t changed_size = 0u;
+    for (const auto &cmp : snap.Components)
+    {
+        auto it = DeltaBase.Components.find(cmp.Name);
+        if ((it == DeltaBase.Components.end()) ||
+            (it->second.first != cmp.Version) || (it->second.second != cmp.Hash))
+            changed_size += cmp.Data.size();
+    }
+    return changed_size <= DeltaBaseSize * DeltaBaseRenewRatio;
+}
+
+static void WriteGameStateProc(std::unique_ptr<Stream> out, std::unique_ptr<SavegameSnapshot> snap,
+    String delta_dir)
+{
+    SavegameComponents::CalcSnapshotHashes(*snap);
+    const SavegameComponents::SavegameBase *base = nullptr;
+    bool new_base = false;
+    if (!delta_dir.IsEmpty())
+    {
+        if (IsDeltaBaseUsable(delta_dir, *snap) ||
+            (new_base = WriteDeltaBase(delta_dir, *snap)))
+            base = &DeltaBase;
+        else
+            Debug::Printf(kDbgMsg_Warn, "WARNING: failed to write delta save base, writing a full save");
+    }
+
+    SavegameComponents::WriteSnapshot(out.get(), *snap, base);
+    if (out->GetError())
+        Debug::Printf(kDbgMsg_Error, "ERROR: failed to write savegame file");
+    out->Close();
+
+    if (new_base)
+        DeleteUnusedDeltaBases(delta_dir, DeltaBase.Filename);
+}
+
+void WriteGameStateAsync(std::unique_ptr<Stream> out, std::unique_ptr<SavegameSnapshot> snap,
+    const String &delta_dir)
+{
+    // Only one save may be written at a time
+    WaitForSavegameWrite();
+#if defined(AGS_DISABLE_THREADS)
+    WriteGameStateProc(std::move(out), std::move(snap), delta_dir);
+#else
+    SavegameWriteThread = std::thread(WriteGameStateProc, std::move(out), std::move(snap), delta_dir);
+#endif
+}
+
+void WaitForSavegameWrite()
+{
+    if (SavegameWriteThread.joinable())
+        SavegameWriteThread.join();
 }
 
 void ReadPluginSaveData(Stream *in, PluginSvgVersion svg_ver, soff_t max_size)
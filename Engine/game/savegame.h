@@ -16,8 +16,11 @@
 #define __AGS_EE_GAME__SAVEGAME_H
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include "ac/game_version.h"
 #include "util/error.h"
+#include "util/string_types.h"
 #include "util/version.h"
 
 
@@ -59,7 +62,9 @@ enum SavegameVersion
     kSvgVersion_361       = 3060115,
     kSvgVersion_399       = 3999999,
     kSvgVersion_400       = 4000000,
-    kSvgVersion_Current   = kSvgVersion_400,
+    kSvgVersion_400_20    = 4000020, // components may be compressed
+    kSvgVersion_400_21    = 4000021, // component hashes, delta saves
+    kSvgVersion_Current   = kSvgVersion_400_21,
     kSvgVersion_LowestSupported = kSvgVersion_Components // change if support dropped
 };
 
@@ -87,6 +92,7 @@ enum SavegameErrorType
     kSvgErr_InconsistentPlugin,
     kSvgErr_DifferentColorDepth,
     kSvgErr_GameObjectInitFailed,
+    kSvgErr_BaseSaveMismatch,
     kNumSavegameError
 };
 
@@ -95,6 +101,9 @@ String GetSavegameErrorText(SavegameErrorType err);
 typedef TypedCodeError<SavegameErrorType, GetSavegameErrorText> SavegameError;
 typedef ErrorHandle<SavegameError> HSaveError;
 
+// Data of the components which a delta save takes from its base saves, by component name
+typedef std::unordered_map<String, std::vector<uint8_t>> SavegameBaseData;
+
 // SavegameSource defines a successfully opened savegame stream
 struct SavegameSource
 {
@@ -107,6 +116,8 @@ struct SavegameSource
     SavegameVersion     Version;
     // A pointer to the opened stream
     std::unique_ptr<Stream> InputStream;
+    // Components taken from the base saves, resolved when opening the savegame
+    SavegameBaseData    BaseData;
 
     SavegameSource();
 };
@@ -153,17 +164,48 @@ struct SavegameDescription
 };
 
 
-// Opens savegame for reading; optionally reads description, if any is provided
+// SavegameComponentData is a serialized game state component
+struct SavegameComponentData
+{
+    String              Name;
+    int32_t             Version = 0;
+    std::vector<uint8_t> Data;
+    uint64_t            Hash = 0u; // content hash, calculated when writing
+};
+
+// SavegameSnapshot is a full game state serialized into memory,
+// which may be written into the savegame file at any later time
+struct SavegameSnapshot
+{
+    std::vector<SavegameComponentData> Components;
+    // Savegame signature and a description without user's data,
+    // used when this snapshot has to be written as a delta save base
+    std::vector<uint8_t> BaseHeader;
+};
+
+
+// Opens savegame for reading; optionally reads description, if any is provided.
+// If this is a delta save, then also reads and validates the components
+// which it takes from its base saves.
 HSaveError     OpenSavegame(const String &filename, SavegameSource &src,
                             SavegameDescription &desc, SavegameDescElem elems = kSvgDesc_All);
 // Opens savegame and reads the savegame description
 HSaveError     OpenSavegame(const String &filename, SavegameDescription &desc, SavegameDescElem elems = kSvgDesc_All);
 // Reads the game data from the save stream and reinitializes game state
-HSaveError     RestoreGameState(Stream *in, SavegameVersion svg_version);
+HSaveError     RestoreGameState(SavegameSource &src);
 // Opens savegame for writing and puts in savegame description
 std::unique_ptr<Stream> StartSavegame(const String &filename, const String &user_text, const Bitmap *user_image);
-// Prepares game for saving state and writes game data into the save stream
-void           SaveGameState(Stream *out);
+// Prepares game for saving state and serializes game data into memory;
+// must be called on the game thread
+std::unique_ptr<SavegameSnapshot> MakeGameStateSnapshot();
+// Writes the game state snapshot into the save stream and closes the stream;
+// compression and file writing are done on a background thread.
+// If delta_dir is not empty, then writes a delta save, which only contains
+// components changed since the base save, kept in that directory.
+void           WriteGameStateAsync(std::unique_ptr<Stream> out, std::unique_ptr<SavegameSnapshot> snap,
+                                   const String &delta_dir);
+// Waits until the savegame writing in progress (if any) is complete
+void           WaitForSavegameWrite();
 
 } // namespace Engine
 } // namespace AGS
@@ -48,7 +48,10 @@
 #include "plugin/plugin_engine.h"
 #include "script/cc_common.h"
 #include "script/script.h"
+#include "util/compress.h"
 #include "util/filestream.h" // TODO: needed only because plugins expect file handle
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
 #include "util/string_utils.h"
 #include "media/audio/audio_system.h"
 
@@ -73,6 +76,18 @@ namespace SavegameComponents
 
 const String ComponentListTag = "Components";
 
+// Component data storage type
+enum ComponentStorage
+{
+    kCmpStore_Raw       = 0, // plain data
+    kCmpStore_Deflate   = 1, // compressed data
+    kCmpStore_Base      = 2  // no data, same as in the base save
+};
+
+// Components of at least this size are compressed when written;
+// this is meant primarily for the bitmaps, which take most of the save
+const size_t ComponentCompressMinSize = 4096;
+
 void WriteFormatTag(Stream *out, const String &tag, bool open = true)
 {
     String full_tag = String::FromFormat(open ? "<%s>" : "</%s>", tag.GetCStr());
@@ -1305,6 +1320,8 @@ struct SvgCmpReadHelper
                                     // will be applied after loading is done
     // The map of serialization handlers, one per supported component type ID
     HandlersMap            Handlers;
+    // Data of the components taken from the base saves, if this is a delta save
+    SavegameBaseData      *BaseData = nullptr;
 
     SvgCmpReadHelper(SavegameVersion svg_version, const PreservedParams &pp, RestoredData &r_data)
         : Version(svg_version)
@@ -1322,19 +1339,172 @@ struct ComponentInfo
     soff_t  Offset;     // offset at which an opening tag is located
     soff_t  DataOffset; // offset at which component data begins
     soff_t  DataSize;   // expected size of component data
+    ComponentStorage Storage; // data storage type
+    soff_t  RawSize;    // size of uncompressed component data
+    uint64_t Hash;      // content hash, if available
 
-    ComponentInfo() : Version(-1), Offset(0), DataOffset(0), DataSize(0) {}
+    ComponentInfo() : Version(-1), Offset(0), DataOffset(0), DataSize(0)
+        , Storage(kCmpStore_Raw), RawSize(0), Hash(0) {}
 };
 
-HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
+// Calculates 64-bit FNV-1a hash of the component data
+static uint64_t CalcComponentHash(const std::vector<uint8_t> &data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint8_t b : data)
+        hash = (hash ^ b) * 1099511628211ULL;
+    return hash;
+}
+
+// Reads the component header, up to the beginning of its data
+static bool ReadComponentHeader(Stream *in, SavegameVersion svg_ver, ComponentInfo &info)
 {
     info = ComponentInfo(); // reset in case of early error
     info.Offset = in->GetPosition();
     if (!ReadFormatTag(in, info.Name, true))
-        return new SavegameError(kSvgErr_ComponentOpeningTagFormat);
+        return false;
     info.Version = in->ReadInt32();
-    info.DataSize = hlp.Version >= kSvgVersion_Cmp_64bit ? in->ReadInt64() : in->ReadInt32();
+    if (svg_ver >= kSvgVersion_400_20)
+        info.Storage = static_cast<ComponentStorage>(in->ReadInt8());
+    if (svg_ver >= kSvgVersion_400_21)
+        info.Hash = in->ReadInt64();
+    info.DataSize = svg_ver >= kSvgVersion_Cmp_64bit ? in->ReadInt64() : in->ReadInt32();
+    info.RawSize = (info.Storage == kCmpStore_Deflate) ? in->ReadInt64() : info.DataSize;
     info.DataOffset = in->GetPosition();
+    return true;
+}
+
+// Reads the name of the base save, which is present in delta saves
+static String ReadBaseSaveRef(Stream *in, SavegameVersion svg_ver)
+{
+    if (svg_ver < kSvgVersion_400_21)
+        return {};
+    return StrUtil::ReadString(in);
+}
+
+// Reads the component data which is not stored plainly in the stream;
+// takes components stored in the base save from the already resolved base data
+static HSaveError ReadComponentData(Stream *in, const ComponentInfo &info,
+    SavegameBaseData *base_data, std::vector<uint8_t> &data)
+{
+    switch (info.Storage)
+    {
+    case kCmpStore_Raw:
+        data.resize(static_cast<size_t>(info.DataSize));
+        in->Read(data.data(), data.size());
+        return HSaveError::None();
+    case kCmpStore_Deflate:
+        if (info.DataSize < 0 || info.RawSize < 0)
+            return new SavegameError(kSvgErr_InconsistentFormat, "Invalid compressed component size.");
+        data.resize(static_cast<size_t>(info.RawSize));
+        if (!inflate_decompress(data.data(), data.size(), 0, in, static_cast<size_t>(info.DataSize)))
+            return new SavegameError(kSvgErr_InconsistentFormat, "Failed to decompress component data.");
+        return HSaveError::None();
+    case kCmpStore_Base:
+    {
+        auto it = base_data ? base_data->find(info.Name) : SavegameBaseData::iterator();
+        if (!base_data || it == base_data->end())
+            return new SavegameError(kSvgErr_InconsistentFormat, "Component refers to the base save, but it was not resolved.");
+        data = std::move(it->second);
+        base_data->erase(it);
+        return HSaveError::None();
+    }
+    default:
+        return new SavegameError(kSvgErr_InconsistentFormat,
+            String::FromFormat("Unknown component storage type: %d.", info.Storage));
+    }
+}
+
+// Skips the component's data and the closing tag
+static bool SkipComponent(Stream *in, const ComponentInfo &info)
+{
+    in->Seek(info.DataOffset + info.DataSize, kSeekBegin);
+    return AssertFormatTag(in, info.Name, false);
+}
+
+HSaveError ReadBaseRefs(Stream *in, SavegameVersion svg_version, String &base_save, ComponentHashes &refs)
+{
+    const soff_t list_pos = in->GetPosition();
+    if (!AssertFormatTag(in, ComponentListTag, true))
+        return new SavegameError(kSvgErr_ComponentListOpeningTagFormat);
+    base_save = ReadBaseSaveRef(in, svg_version);
+    while (!in->EOS())
+    {
+        soff_t off = in->GetPosition();
+        if (AssertFormatTag(in, ComponentListTag, false))
+        {
+            in->Seek(list_pos, kSeekBegin);
+            return HSaveError::None();
+        }
+        in->Seek(off, kSeekBegin);
+
+        ComponentInfo info;
+        if (!ReadComponentHeader(in, svg_version, info))
+            return new SavegameError(kSvgErr_ComponentOpeningTagFormat);
+        if (info.Storage == kCmpStore_Base)
+            refs[info.Name] = std::make_pair(info.Version, info.Hash);
+        if (!SkipComponent(in, info))
+            return new SavegameError(kSvgErr_ComponentClosingTagFormat);
+    }
+    return new SavegameError(kSvgErr_ComponentListClosingTagMissing);
+}
+
+HSaveError ReadBaseComponents(Stream *in, SavegameVersion svg_version, ComponentHashes &refs,
+    SavegameBaseData &base_data, String &next_base)
+{
+    if (!AssertFormatTag(in, ComponentListTag, true))
+        return new SavegameError(kSvgErr_ComponentListOpeningTagFormat);
+    next_base = ReadBaseSaveRef(in, svg_version);
+    ComponentHashes deferred; // components which this base takes from its own base
+    while (!in->EOS())
+    {
+        soff_t off = in->GetPosition();
+        if (AssertFormatTag(in, ComponentListTag, false))
+        {
+            if (!refs.empty())
+                return new SavegameError(kSvgErr_BaseSaveMismatch,
+                    String::FromFormat("Component not found: %s", refs.begin()->first.GetCStr()));
+            refs.swap(deferred);
+            return HSaveError::None();
+        }
+        in->Seek(off, kSeekBegin);
+
+        ComponentInfo info;
+        if (!ReadComponentHeader(in, svg_version, info))
+            return new SavegameError(kSvgErr_ComponentOpeningTagFormat);
+        auto it = refs.find(info.Name);
+        if (it != refs.end())
+        {
+            if ((info.Version != it->second.first) || (info.Hash != it->second.second))
+                return new SavegameError(kSvgErr_BaseSaveMismatch,
+                    String::FromFormat("Component does not match: %s", info.Name.GetCStr()));
+            if (info.Storage == kCmpStore_Base)
+            {
+                deferred.insert(*it);
+            }
+            else
+            {
+                std::vector<uint8_t> data;
+                HSaveError err = ReadComponentData(in, info, nullptr, data);
+                if (!err)
+                    return err;
+                if (CalcComponentHash(data) != info.Hash)
+                    return new SavegameError(kSvgErr_BaseSaveMismatch,
+                        String::FromFormat("Component data is corrupt: %s", info.Name.GetCStr()));
+                base_data[info.Name] = std::move(data);
+            }
+            refs.erase(it);
+        }
+        if (!SkipComponent(in, info))
+            return new SavegameError(kSvgErr_ComponentClosingTagFormat);
+    }
+    return new SavegameError(kSvgErr_ComponentListClosingTagMissing);
+}
+
+HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
+{
+    if (!ReadComponentHeader(in, hlp.Version, info))
+        return new SavegameError(kSvgErr_ComponentOpeningTagFormat);
 
     const ComponentHandler *handler = nullptr;
     std::map<String, ComponentHandler>::const_iterator it_hdr = hlp.Handlers.find(info.Name);
@@ -1345,26 +1515,48 @@ HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
         return new SavegameError(kSvgErr_UnsupportedComponent);
     if (info.Version > handler->Version || info.Version < handler->LowestVersion)
         return new SavegameError(kSvgErr_UnsupportedComponentVersion, String::FromFormat("Saved version: %d, supported: %d - %d", info.Version, handler->LowestVersion, handler->Version));
-    HSaveError err = handler->Unserialize(in, info.Version, info.DataSize, hlp.PP, hlp.RData);
-    if (!err)
-        return err;
-    if (in->GetPosition() - info.DataOffset != info.DataSize)
-        return new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %jd, actual: %jd",
-            static_cast<intmax_t>(info.DataSize), static_cast<intmax_t>(in->GetPosition() - info.DataOffset)));
+
+    if (info.Storage == kCmpStore_Raw)
+    {
+        HSaveError err = handler->Unserialize(in, info.Version, info.DataSize, hlp.PP, hlp.RData);
+        if (!err)
+            return err;
+        if (in->GetPosition() - info.DataOffset != info.DataSize)
+            return new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %jd, actual: %jd",
+                static_cast<intmax_t>(info.DataSize), static_cast<intmax_t>(in->GetPosition() - info.DataOffset)));
+    }
+    else
+    {
+        std::vector<uint8_t> data;
+        HSaveError err = ReadComponentData(in, info, hlp.BaseData, data);
+        if (!err)
+            return err;
+        const soff_t data_size = static_cast<soff_t>(data.size());
+        Stream mem_in(std::make_unique<VectorStream>(data));
+        err = handler->Unserialize(&mem_in, info.Version, data_size, hlp.PP, hlp.RData);
+        if (!err)
+            return err;
+        if (mem_in.GetPosition() != data_size)
+            return new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %jd, actual: %jd",
+                static_cast<intmax_t>(data_size), static_cast<intmax_t>(mem_in.GetPosition())));
+    }
     if (!AssertFormatTag(in, info.Name, false))
         return new SavegameError(kSvgErr_ComponentClosingTagFormat);
     return HSaveError::None();
 }
 
-HSaveError ReadAll(Stream *in, SavegameVersion svg_version, const PreservedParams &pp, RestoredData &r_data)
+HSaveError ReadAll(Stream *in, SavegameVersion svg_version, SavegameBaseData &base_data,
+    const PreservedParams &pp, RestoredData &r_data)
 {
     // Prepare a helper struct we will be passing to the block reading proc
     SvgCmpReadHelper hlp(svg_version, pp, r_data);
     GenerateHandlersMap(hlp.Handlers);
+    hlp.BaseData = &base_data;
 
     size_t idx = 0;
     if (!AssertFormatTag(in, ComponentListTag, true))
         return new SavegameError(kSvgErr_ComponentListOpeningTagFormat);
+    ReadBaseSaveRef(in, svg_version); // base save was resolved when opening the savegame
     do
     {
         // Look out for the end of the component list:
@@ -1390,28 +1582,28 @@ HSaveError ReadAll(Stream *in, SavegameVersion svg_version, const PreservedParam
     return new SavegameError(kSvgErr_ComponentListClosingTagMissing);
 }
 
-HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr)
+String ReadBaseSaveName(Stream *in, SavegameVersion svg_version)
 {
-    WriteFormatTag(out, hdlr.Name, true);
-    out->WriteInt32(hdlr.Version);
-    soff_t ref_pos = out->GetPosition();
-    out->WriteInt64(0); // placeholder for the component size
-    HSaveError err = hdlr.Serialize(out);
-    soff_t end_pos = out->GetPosition();
-    out->Seek(ref_pos, kSeekBegin);
-    out->WriteInt64(end_pos - ref_pos - sizeof(int64_t)); // size of serialized component data
-    out->Seek(end_pos, kSeekBegin);
-    if (err)
-        WriteFormatTag(out, hdlr.Name, false);
-    return err;
+    if (!AssertFormatTag(in, ComponentListTag, true))
+        return {};
+    return ReadBaseSaveRef(in, svg_version);
 }
 
-HSaveError WriteAllCommon(Stream *out)
+HSaveError WriteComponent(SavegameComponentData &cmp, ComponentHandler &hdlr)
 {
-    WriteFormatTag(out, ComponentListTag, true);
+    cmp.Name = hdlr.Name;
+    cmp.Version = hdlr.Version;
+    Stream out(std::make_unique<VectorStream>(cmp.Data, kStream_Write));
+    return hdlr.Serialize(&out);
+}
+
+HSaveError WriteAllCommon(SavegameSnapshot &snap)
+{
+    snap.Components.clear();
     for (int type = 0; !ComponentHandlers[type].Name.IsEmpty(); ++type)
     {
-        HSaveError err = WriteComponent(out, ComponentHandlers[type]);
+        snap.Components.emplace_back();
+        HSaveError err = WriteComponent(snap.Components.back(), ComponentHandlers[type]);
         if (!err)
         {
             return new SavegameError(kSvgErr_ComponentSerialization,
@@ -1419,10 +1611,66 @@ HSaveError WriteAllCommon(Stream *out)
                 err);
         }
     }
-    WriteFormatTag(out, ComponentListTag, false);
     return HSaveError::None();
 }
 
+void CalcSnapshotHashes(SavegameSnapshot &snap)
+{
+    for (auto &cmp : snap.Components)
+        cmp.Hash = CalcComponentHash(cmp.Data);
+}
+
+void WriteSnapshotComponent(Stream *out, const SavegameComponentData &cmp, bool in_base)
+{
+    WriteFormatTag(out, cmp.Name, true);
+    out->WriteInt32(cmp.Version);
+    if (in_base)
+    {
+        out->WriteInt8(kCmpStore_Base);
+        out->WriteInt64(cmp.Hash);
+        out->WriteInt64(0); // no data
+    }
+    else if (cmp.Data.size() >= ComponentCompressMinSize)
+    {
+        out->WriteInt8(kCmpStore_Deflate);
+        out->WriteInt64(cmp.Hash);
+        soff_t ref_pos = out->GetPosition();
+        out->WriteInt64(0); // placeholder for the compressed data size
+        out->WriteInt64(cmp.Data.size());
+        deflate_compress(cmp.Data.data(), cmp.Data.size(), 0, out);
+        soff_t end_pos = out->GetPosition();
+        out->Seek(ref_pos, kSeekBegin);
+        out->WriteInt64(end_pos - ref_pos - 2 * sizeof(int64_t));
+        out->Seek(end_pos, kSeekBegin);
+    }
+    else
+    {
+        out->WriteInt8(kCmpStore_Raw);
+        out->WriteInt64(cmp.Hash);
+        out->WriteInt64(cmp.Data.size());
+        out->Write(cmp.Data.data(), cmp.Data.size());
+    }
+    WriteFormatTag(out, cmp.Name, false);
+}
+
+void WriteSnapshot(Stream *out, const SavegameSnapshot &snap, const SavegameBase *base)
+{
+    WriteFormatTag(out, ComponentListTag, true);
+    StrUtil::WriteString(base ? base->Filename : String(), out);
+    for (const auto &cmp : snap.Components)
+    {
+        bool in_base = false;
+        if (base)
+        {
+            auto it = base->Components.find(cmp.Name);
+            in_base = (it != base->Components.end()) &&
+                (it->second.first == cmp.Version) && (it->second.second == cmp.Hash);
+        }
+        WriteSnapshotComponent(out, cmp, in_base);
+    }
+    WriteFormatTag(out, ComponentListTag, false);
+}
+
 } // namespace SavegameBlocks
 } // namespace Engine
 } // namespace AGS
@@ -14,8 +14,10 @@
 #ifndef __AGS_EE_GAME__SAVEGAMECOMPONENTS_H
 #define __AGS_EE_GAME__SAVEGAMECOMPONENTS_H
 
+#include <unordered_map>
 #include "game/savegame.h"
 #include "util/stream.h"
+#include "util/string_types.h"
 
 namespace AGS
 {
@@ -26,6 +28,7 @@ namespace Engine
 {
 
 using Common::Stream;
+using Common::String;
 using Common::Interaction;
 
 struct PreservedParams;
@@ -33,10 +36,42 @@ struct RestoredData;
 
 namespace SavegameComponents
 {
-    // Reads all available components from the stream
-    HSaveError    ReadAll(Stream *in, SavegameVersion svg_version, const PreservedParams &pp, RestoredData &r_data);
-    // Writes a full list of common components to the stream
-    HSaveError    WriteAllCommon(Stream *out);
+    // Component's version and content hash, per component name
+    typedef std::unordered_map<String, std::pair<int32_t, uint64_t>> ComponentHashes;
+
+    // SavegameBase describes a base save for the delta saves: the delta save
+    // only has components which differ from the ones in the base save.
+    struct SavegameBase
+    {
+        // Base save's filename, relative to the delta save location
+        String Filename;
+        ComponentHashes Components;
+    };
+
+    // Reads all available components from the stream; the components stored
+    // in the base saves are taken from base_data, which must be resolved beforehand
+    HSaveError    ReadAll(Stream *in, SavegameVersion svg_version, SavegameBaseData &base_data,
+                          const PreservedParams &pp, RestoredData &r_data);
+    // Reads the name of the base save, and the list of components which the save
+    // takes from it; restores the stream position afterwards
+    HSaveError    ReadBaseRefs(Stream *in, SavegameVersion svg_version, String &base_save, ComponentHashes &refs);
+    // Reads the data of the referenced components from the base save, and checks
+    // their hashes; on success refs are replaced by the components which the base
+    // save takes from its own base save, named by next_base
+    HSaveError    ReadBaseComponents(Stream *in, SavegameVersion svg_version, ComponentHashes &refs,
+                                     SavegameBaseData &base_data, String &next_base);
+    // Reads the name of the base save from the beginning of the component list,
+    // returns empty string if this is not a delta save
+    String        ReadBaseSaveName(Stream *in, SavegameVersion svg_version);
+    // Serializes a full list of common components into the memory snapshot
+    HSaveError    WriteAllCommon(SavegameSnapshot &snap);
+    // Calculates content hashes for all the components in the snapshot
+    void          CalcSnapshotHashes(SavegameSnapshot &snap);
+    // Writes the serialized components to the stream, compressing large ones;
+    // if the base is provided, then skips the components matching the base.
+    // Does not access the game state, so may be called from any thread.
+    void          WriteSnapshot(Stream *out, const SavegameSnapshot &snap,
+                                const SavegameBase *base = nullptr);
 }
 
 } // namespace Engine
@@ -860,6 +860,8 @@ void OGLGraphicsDriver::UnInit()
   DeleteShaderProgram(_transparencyShader);
   DeleteShaderProgram(_tintShader);
   DeleteShaderProgram(_lightShader);
+  _stagingBuffer.clear();
+  _stagingBuffer.shrink_to_fit();
 
   DeleteWindowAndGlContext();
   sys_window_destroy();
@@ -1252,6 +1254,7 @@ void OGLGraphicsDriver::RenderAndPresent(bool clearDrawListAfterwards)
 {
     RenderImpl(clearDrawListAfterwards);
     SDL_GL_SwapWindow(_sdlWindow);
+    ResetTextureUploadStats();
 }
 
 void OGLGraphicsDriver::RenderImpl(bool clearDrawListAfterwards)
@@ -1672,8 +1675,9 @@ void OGLGraphicsDriver::UpdateTextureRegion(OGLTextureTile *tile, const Bitmap *
   }
 
   const bool usingLinearFiltering = _filter->UseLinearFiltering();
-  uint8_t *origPtr = new uint8_t[sizeof(int) * tileWidth * tileHeight];
   const int pitch = tileWidth * sizeof(int);
+  const size_t buf_size = pitch * tileHeight;
+  uint8_t *origPtr = BeginTextureUpload(buf_size);
   uint8_t *memPtr = origPtr + pitch * tiley + tilex * sizeof(int);
 
   TextureTile fixedTile;
@@ -1731,9 +1735,26 @@ void OGLGraphicsDriver::UpdateTextureRegion(OGLTextureTile *tile, const Bitmap *
   }
 
   glBindTexture(GL_TEXTURE_2D, tile->texture);
-  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tileWidth, tileHeight, GL_RGBA, GL_UNSIGNED_BYTE, origPtr);
+  EndTextureUpload(tileWidth, tileHeight, origPtr);
+  _uploadStats.Count++;
+  _uploadStats.Bytes += buf_size;
+}
 
-  delete []origPtr;
+uint8_t *OGLGraphicsDriver::BeginTextureUpload(size_t buf_size)
+{
+  // The buffer is kept between the uploads, so that it's not reallocated
+  // each time; it only grows up to the largest tile size
+  if (_stagingBuffer.size() < buf_size)
+    _stagingBuffer.resize(buf_size);
+  return _stagingBuffer.data();
+}
+
+void OGLGraphicsDriver::EndTextureUpload(int width, int height, const uint8_t *buf)
+{
+  const auto t_start = AGS_Clock::now();
+  // NOTE: the driver copies the pixels from the client memory before returning
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, buf);
+  _uploadStats.StallUs += std::chrono::duration_cast<std::chrono::microseconds>(AGS_Clock::now() - t_start).count();
 }
 
 void OGLGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* ddb, const Bitmap *bitmap)
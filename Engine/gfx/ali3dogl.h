@@ -370,6 +370,10 @@ private:
     OGLSpriteBatches _backupBatches;
     std::vector<OGLDrawListEntry> _backupSpriteList;
 
+    // Texture upload staging: a reusable client memory buffer where the pixels
+    // are converted before passing them to the texture.
+    std::vector<uint8_t> _stagingBuffer;
+
     // Saved blend settings exclusive for alpha channel; for convenience,
     // because GL does not have functions for setting ONLY RGB or ONLY alpha ops.
     GLenum _blendOpAlpha{};
@@ -399,6 +403,10 @@ private:
     void ReleaseDisplayMode();
     void AdjustSizeToNearestSupportedByCard(int *width, int *height);
     void UpdateTextureRegion(OGLTextureTile *tile, const Bitmap *bitmap, bool opaque);
+    // Provides a client memory staging buffer of the requested size for the texture upload
+    uint8_t *BeginTextureUpload(size_t buf_size);
+    // Transfers staged pixels into the currently bound texture
+    void EndTextureUpload(int width, int height, const uint8_t *buf);
     void CreateVirtualScreen();
     void RenderSprite(const OGLDrawListEntry *entry, const glm::mat4 &projection, const glm::mat4 &matGlobal,
         const SpriteColorTransform &color, const Size &rend_sz);
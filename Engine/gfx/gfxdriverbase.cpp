@@ -158,6 +158,12 @@ void GraphicsDriverBase::OnScalingChanged()
     _scaling.Init(_srcRect.GetSize(), _dstRect);
 }
 
+void GraphicsDriverBase::ResetTextureUploadStats()
+{
+    _lastUploadStats = _uploadStats;
+    _uploadStats = TextureUploadStats();
+}
+
 void GraphicsDriverBase::OnSetNativeRes(const GraphicResolution &native_res)
 {
     _srcRect = RectWH(0, 0, native_res.Width, native_res.Height);
@@ -122,6 +122,8 @@ public:
     bool        SetVsync(bool enabled) override;
     bool        GetVsync() const override;
 
+    TextureUploadStats GetTextureUploadStats() const override { return _lastUploadStats; }
+
     void        BeginSpriteBatch(const Rect &viewport, const SpriteTransform &transform,
                     Common::GraphicFlip flip = Common::kFlip_None, PBitmap surface = nullptr, uint32_t filter_flags = 0) override;
     void        BeginSpriteBatch(IDriverDependantBitmap *render_target, const Rect &viewport, const SpriteTransform &transform,
@@ -167,6 +169,8 @@ protected:
 
     void BeginSpriteBatch(const SpriteBatchDesc &desc);
     void OnScalingChanged();
+    // Saves texture upload stats gathered during the current frame, and starts a new count
+    void ResetTextureUploadStats();
 
     DisplayMode         _mode;          // display mode settings
     Rect                _srcRect;       // rendering source rect
@@ -178,6 +182,10 @@ protected:
     // Capability flags
     bool                _capsVsync = false; // is vsync available
 
+    // Texture upload stats for the current and the last rendered frame
+    TextureUploadStats  _uploadStats;
+    TextureUploadStats  _lastUploadStats;
+
     // Callbacks
     GFXDRV_CLIENTCALLBACKEVT _spriteEvtCallback;
     GFXDRV_CLIENTCALLBACKINITGFX _initGfxCallback;
@@ -86,6 +86,14 @@ struct RenderMatrixes
     glm::mat4 Projection;
 };
 
+// Texture upload statistics, gathered over a single rendered frame
+struct TextureUploadStats
+{
+    uint32_t Count = 0u;   // number of texture region updates
+    uint64_t Bytes = 0u;   // amount of pixel data passed to the driver
+    uint64_t StallUs = 0u; // time spent in the driver's texture update calls, in microseconds
+};
+
 
 typedef void (*GFXDRV_CLIENTCALLBACK)();
 typedef bool (*GFXDRV_CLIENTCALLBACKEVT)(int evt, int data);
@@ -142,6 +150,8 @@ public:
   virtual int  GetCompatibleBitmapFormat(int color_depth) = 0;
   // Returns available texture memory in bytes, or 0 if this query is not supported
   virtual uint64_t GetAvailableTextureMemory() = 0;
+  // Returns texture upload statistics for the last rendered frame
+  virtual TextureUploadStats GetTextureUploadStats() const = 0;
 
   // Creates a "raw" DDB, without pixel initialization.
   virtual IDriverDependantBitmap *CreateDDB(int width, int height, int color_depth, bool opaque = false) = 0;
@@ -124,7 +124,22 @@ int GUILabel::PrepareTextToDraw()
 {
     const bool is_translated = (Flags & kGUICtrl_Translated) != 0;
     replace_macro_tokens(is_translated ? get_translation(Text.GetCStr()) : Text.GetCStr(), _textToDraw);
-    return GUI::SplitLinesForDrawing(_textToDraw.GetCStr(), is_translated, Lines, Font, _width);
+    // Reuse previously split lines, unless the text or any layout parameters
+    // changed; the label may be redrawn for many other reasons
+    const bool rtl = is_translated && (game.options[OPT_RIGHTLEFTWRITE] != 0);
+    const int format = get_uformat();
+    const uint32_t version = get_text_layout_version();
+    if (font_supports_layout_cache(Font) && (_linesFont == Font) && (_linesWidth == _width) && (_linesFormat == format) &&
+        (_linesRtl == rtl) && (_linesVersion == version) && (_linesText == _textToDraw))
+        return _lines.Count();
+
+    _linesText = _textToDraw;
+    _linesFont = Font;
+    _linesWidth = _width;
+    _linesFormat = format;
+    _linesRtl = rtl;
+    _linesVersion = version;
+    return GUI::SplitLinesForDrawing(_textToDraw.GetCStr(), is_translated, _lines, Font, _width);
 }
 
 void GUITextBox::DrawTextBoxContents(Bitmap *ds, int x, int y, color_t text_color)
@@ -628,3 +628,12 @@ int apeg_display_video_frame(APEG_STREAM *stream)
 	layer->picture = NULL;
 	return ret;
 }
+
+// Drops the last decoded video frame without displaying it
+int apeg_skip_video_frame(APEG_STREAM *stream)
+{
+	APEG_LAYER *layer = (APEG_LAYER*)stream;
+	int ret = layer->picture ? APEG_OK : APEG_EOF;
+	layer->picture = NULL;
+	return ret;
+}
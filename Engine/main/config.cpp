@@ -197,6 +197,7 @@ void apply_config(const ConfigTree &cfg)
 
         // Custom paths
         usetup.load_latest_save = CfgReadBoolInt(cfg, "misc", "load_latest_save", usetup.load_latest_save);
+        usetup.delta_saves = CfgReadBoolInt(cfg, "misc", "delta_saves", usetup.delta_saves);
         usetup.user_data_dir = CfgReadString(cfg, "misc", "user_data_dir");
         usetup.shared_data_dir = CfgReadString(cfg, "misc", "shared_data_dir");
         usetup.show_fps = CfgReadBoolInt(cfg, "misc", "show_fps");
@@ -208,8 +209,11 @@ void apply_config(const ConfigTree &cfg)
         usetup.clear_cache_on_room_change = CfgReadBoolInt(cfg, "misc", "clear_cache_on_room_change", usetup.clear_cache_on_room_change);
         usetup.SpriteCacheSize = CfgReadInt(cfg, "graphics", "sprite_cache_size", usetup.SpriteCacheSize);
         usetup.TextureCacheSize = CfgReadInt(cfg, "graphics", "texture_cache_size", usetup.TextureCacheSize);
+        usetup.RoomCacheSize = CfgReadInt(cfg, "graphics", "room_cache_size", usetup.RoomCacheSize);
+        usetup.room_prefetch = CfgReadBoolInt(cfg, "misc", "room_prefetch", usetup.room_prefetch);
         usetup.SoundCacheSize = CfgReadInt(cfg, "sound", "cache_size", usetup.SoundCacheSize);
         usetup.SoundLoadAtOnceSize = CfgReadInt(cfg, "sound", "stream_threshold", usetup.SoundLoadAtOnceSize);
+        usetup.SoundPcmCacheSize = CfgReadInt(cfg, "sound", "pcm_cache_size", usetup.SoundPcmCacheSize);
 
         // Mouse options
         usetup.mouse_auto_lock = CfgReadBoolInt(cfg, "mouse", "auto_lock");
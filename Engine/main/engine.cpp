@@ -43,6 +43,7 @@
 #include "ac/path_helper.h"
 #include "ac/route_finder.h"
 #include "ac/sys_events.h"
+#include "ac/roomcache.h"
 #include "ac/roomstatus.h"
 #include "ac/speech.h"
 #include "ac/spritecache.h"
@@ -402,7 +403,8 @@ void engine_init_audio()
     
     if (usetup.audio_enabled)
     {
-        soundcache_set_rules(usetup.SoundLoadAtOnceSize * 1024, usetup.SoundCacheSize * 1024);
+        soundcache_set_rules(usetup.SoundLoadAtOnceSize * 1024, usetup.SoundCacheSize * 1024,
+            usetup.SoundPcmCacheSize * 1024);
     }
     else
     {
@@ -581,11 +583,24 @@ HError engine_init_sprites()
             SpriteFile::DefaultSpriteFileName.GetCStr()));
     }
     auto index_file = AssetMgr->OpenAsset(SpriteFile::DefaultSpriteIndexName);
-    HError err = spriteset.InitFile(std::move(sprite_file), std::move(index_file));
+    // The index rebuilt on one of the previous runs may be found in the game's data dir
+    const String cached_index = Path::ConcatPaths(GetGameAppDataDir().FullDir, SpriteFile::DefaultSpriteIndexName);
+    auto cached_index_file = File::IsFile(cached_index) ? File::OpenFileRead(cached_index) : nullptr;
+    HError err = spriteset.InitFile(std::move(sprite_file), std::move(index_file), std::move(cached_index_file));
     if (!err) 
     {
         return err;
     }
+    // If the sprite index had to be rebuilt, then save it for the next time
+    std::unique_ptr<SpriteFileIndex> rebuilt_index = spriteset.ReleaseRebuiltIndex();
+    if (rebuilt_index)
+    {
+        String index_path = PreparePathForWriting(GetGameAppDataDir(), SpriteFile::DefaultSpriteIndexName);
+        if (!index_path.IsEmpty() && SaveSpriteIndex(index_path, *rebuilt_index) == 0)
+            Debug::Printf(kDbgMsg_Info, "Sprite index was rebuilt and cached in: %s", index_path.GetCStr());
+        else
+            Debug::Printf(kDbgMsg_Warn, "Sprite index was rebuilt, but failed to cache it in the game data dir");
+    }
     if (usetup.SpriteCacheSize > 0)
         spriteset.SetMaxCacheSize(usetup.SpriteCacheSize * 1024);
     Debug::Printf("Sprite cache set: %zu KB", spriteset.GetMaxCacheSize() / 1024);
@@ -1290,6 +1305,7 @@ int initialize_engine(const ConfigTree &startup_opts)
         platform->DisplayAlert("Could not load sprite set file:\n%s", err->FullMessage().GetCStr());
         return EXIT_ERROR;
     }
+    roomcache_set_rules(usetup.RoomCacheSize * 1024, usetup.room_prefetch);
 
     // TODO: move *init_game_settings to game init code unit
     engine_init_game_settings();
@@ -23,6 +23,7 @@
 #include "ac/gamesetup.h"
 #include "ac/gamesetupstruct.h"
 #include "ac/gamestate.h"
+#include "ac/roomcache.h"
 #include "ac/roomstatus.h"
 #include "ac/route_finder.h"
 #include "ac/translation.h"
@@ -32,6 +33,7 @@
 #include "debug/debugger.h"
 #include "debug/out.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "main/config.h"
 #include "main/engine.h"
 #include "main/main.h"
@@ -187,6 +189,10 @@ void quit(const char *quitmsg)
 
     set_our_eip(9900);
 
+    // Let the last savegame be written completely
+    WaitForSavegameWrite();
+    roomcache_shutdown();
+    Pathfinding::ShutdownRouteWorkers();
     video_shutdown();
     quit_shutdown_audio();
 
@@ -32,7 +32,9 @@
 #include "ac/spritecache.h"
 #include "ac/sys_events.h"
 #include "ac/roomobject.h"
+#include "ac/room.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/timer.h"
 #include "ac/viewframe.h"
 #include "ac/walkablearea.h"
@@ -164,7 +166,7 @@ void update_player_view()
 void update_character_move_and_anim(std::vector<int> &followingAsSheep)
 {
 	// move & animate characters
-  for (int aa=0;aa<game.numcharacters;aa++) {
+  for (int aa : get_active_characters()) {
     if (!game.chars[aa].is_enabled()) continue;
 
     CharacterInfo*chi    = &game.chars[aa];
@@ -433,6 +435,9 @@ void update_stuff() {
 
   set_our_eip(22);
 
+  // Start moving characters whose routes were found in background
+  get_room_pathfinder()->PollRoutes();
+
   std::vector<int> followingAsSheep;
 
   update_character_move_and_anim(followingAsSheep);
@@ -13,7 +13,9 @@
 //=============================================================================
 #include "media/audio/audio_core.h"
 #include <math.h>
+#include <algorithm>
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
@@ -23,10 +25,47 @@
 #include "media/audio/sdldecoder.h"
 #include "media/audio/openalsource.h"
 #include "util/memory_compat.h"
+#include "util/threading.h"
 
 using namespace AGS::Common;
 using namespace AGS::Engine;
 
+// Command sent from the game thread to the audio thread
+struct AudioCoreCommand
+{
+    enum Type
+    {
+        kAddSlot,
+        kPlay,
+        kPause,
+        kSeek,
+        kConfigure,
+        kStop
+    };
+
+    Type CmdType = kAddSlot;
+    int Handle = -1;
+    float Args[3] = {};
+    // A new player and its status, passed with kAddSlot
+    AudioPlayer *Player = nullptr;
+    std::shared_ptr<AudioPlayerStatus> Status;
+};
+
+// Audio slot, owned by the audio thread
+// Player is shared with the decoding jobs, which may still run after
+// the slot is removed.
+struct AudioCoreSlot
+{
+    std::shared_ptr<AudioPlayer> Player;
+    std::shared_ptr<AudioPlayerStatus> Status;
+};
+
+// Max commands queued before the game thread has to wait for the audio thread;
+// normally there are few commands per slot per game frame
+static const size_t AudioCoreCommandQueueSize = 1024;
+// Max number of decoding threads
+static const unsigned AudioCoreMaxDecoders = 4;
+
 // Global audio core state and resources
 static struct 
 {
@@ -42,12 +81,39 @@ static struct
     // Sound slot id counter
     int nextId = 0;
 
-    // One mutex to lock them all... any operation on individual decoders
-    // is done under this only mutex, which means that they are currently
-    // polled one by one, any action like pause/resume is also synced.
-    std::mutex mixer_mutex_m;
-    std::condition_variable mixer_cv;
-    std::unordered_map<int, std::unique_ptr<AudioPlayer>> slots_;
+    // Control commands are passed from the game thread to the audio thread
+    // through the lock-free queue. The mutex and condition variable are only
+    // used to let audio thread sleep while it's got nothing to do, and wake
+    // it up when a new command arrives.
+    SpscRingBuffer<AudioCoreCommand> commands_{AudioCoreCommandQueueSize};
+    std::mutex wake_mutex_m;
+    std::condition_variable wake_cv;
+    bool wake_pending = false;
+    // Slots are accessed only by the audio thread
+    std::unordered_map<int, AudioCoreSlot> slots_;
+    // Published player states, accessed only by the game thread
+    std::unordered_map<int, std::shared_ptr<AudioPlayerStatus>> status_;
+
+    // Decoding threads: run the decoding step of players, scheduled by
+    // the audio thread, so that the audio thread itself only passes
+    // decoded data to the OpenAL sources.
+    std::vector<std::thread> decoder_threads;
+    bool decoders_running = false;
+    std::mutex decode_mutex_m;
+    std::condition_variable decode_cv;
+    std::deque<std::shared_ptr<AudioPlayer>> decode_jobs_;
+    // Players handed back by the decoding threads after decoding; these are
+    // released by the audio thread, because a player may have to be destroyed
+    // along with its OpenAL source, which must be done on the audio thread.
+    std::vector<std::shared_ptr<AudioPlayer>> release_jobs_;
+    // Requests to decode whole sounds; these have lower priority than
+    // the players, which may run out of data
+    std::deque<std::shared_ptr<SoundPcmDecodeRequest>> pcm_jobs_;
+
+    // Total number of output underruns, for diagnostics;
+    // counted for the released players, and for all of them
+    uint32_t retired_underruns = 0u;
+    std::atomic<uint32_t> underruns{0u};
 } g_acore;
 
 // Prints any OpenAL errors to the log
@@ -64,6 +130,7 @@ void dump_al_errors()
 // -------------------------------------------------------------------------------------------------
 
 static void audio_core_entry();
+static void audio_core_decoder_entry();
 
 void audio_core_init() 
 {
@@ -102,6 +169,14 @@ void audio_core_init()
 
     g_acore.audio_core_thread_running = true;
 #if !defined(AGS_DISABLE_THREADS)
+    // Leave at least one core for the game and audio threads
+    const unsigned hw_threads = std::thread::hardware_concurrency();
+    const unsigned decoder_count = std::max(1u,
+        std::min(hw_threads > 1u ? hw_threads - 1u : 1u, AudioCoreMaxDecoders));
+    g_acore.decoders_running = true;
+    for (unsigned i = 0; i < decoder_count; ++i)
+        g_acore.decoder_threads.emplace_back(audio_core_decoder_entry);
+    Debug::Printf(kDbgMsg_Info, "AudioCore: started %u decoding thread(s)", decoder_count);
     g_acore.audio_core_thread = std::thread(audio_core_entry);
 #endif
 }
@@ -114,12 +189,35 @@ void audio_core_shutdown()
     Debug::Printf(kDbgMsg_Info, "AudioCore: shutting down...");
     g_acore.audio_core_thread_running = false;
 #if !defined(AGS_DISABLE_THREADS)
+    {
+        std::lock_guard<std::mutex> lk(g_acore.wake_mutex_m);
+        g_acore.wake_pending = true;
+    }
+    g_acore.wake_cv.notify_all();
     if (g_acore.audio_core_thread.joinable())
         g_acore.audio_core_thread.join();
-#endif
 
-    // dispose all the active slots
+    {
+        std::lock_guard<std::mutex> lk(g_acore.decode_mutex_m);
+        g_acore.decoders_running = false;
+    }
+    g_acore.decode_cv.notify_all();
+    for (auto &thread : g_acore.decoder_threads)
+        thread.join();
+    g_acore.decoder_threads.clear();
+#endif
+    g_acore.decode_jobs_.clear();
+    g_acore.pcm_jobs_.clear();
+    g_acore.release_jobs_.clear();
+
+    // dispose all the active slots, including ones still waiting in the queue
+    AudioCoreCommand cmd;
+    while (g_acore.commands_.Pop(cmd))
+        delete cmd.Player;
     g_acore.slots_.clear();
+    g_acore.status_.clear();
+    // dispose all the al buffers, as there are no more sources
+    OpenAlSource::DeleteBuffers();
 
     // SDL_Sound
     Sound_Quit();
@@ -161,12 +259,54 @@ static int avail_slot_id()
     return g_acore.nextId++;
 }
 
+// Passes the command to the audio thread
+static void audio_core_send(const AudioCoreCommand &cmd)
+{
+    while (!g_acore.commands_.Push(cmd))
+    {
+        // The queue is full, which means that the audio thread is stuck;
+        // there's nothing else to do but wait for it.
+#if defined(AGS_DISABLE_THREADS)
+        audio_core_entry_poll();
+#else
+        std::this_thread::yield();
+#endif
+    }
+#if !defined(AGS_DISABLE_THREADS)
+    {
+        std::lock_guard<std::mutex> lk(g_acore.wake_mutex_m);
+        g_acore.wake_pending = true;
+    }
+    g_acore.wake_cv.notify_one();
+#endif
+}
+
+static void audio_core_send(AudioCoreCommand::Type type, int handle,
+    float arg0 = 0.f, float arg1 = 0.f, float arg2 = 0.f)
+{
+    AudioCoreCommand cmd;
+    cmd.CmdType = type;
+    cmd.Handle = handle;
+    cmd.Args[0] = arg0;
+    cmd.Args[1] = arg1;
+    cmd.Args[2] = arg2;
+    audio_core_send(cmd);
+}
+
 static int audio_core_slot_init(std::unique_ptr<SDLDecoder> decoder)
 {
     auto handle = avail_slot_id();
-    std::lock_guard<std::mutex> lk(g_acore.mixer_mutex_m);
-    g_acore.slots_[handle] = std::make_unique<AudioPlayer>(handle, std::move(decoder));
-    g_acore.mixer_cv.notify_all();
+    auto status = std::make_shared<AudioPlayerStatus>();
+    status->DurationMs = decoder->GetDurationMs();
+    status->Frequency = decoder->GetFreq();
+    g_acore.status_[handle] = status;
+
+    AudioCoreCommand cmd;
+    cmd.CmdType = AudioCoreCommand::kAddSlot;
+    cmd.Handle = handle;
+    cmd.Player = new AudioPlayer(handle, std::move(decoder));
+    cmd.Status = status;
+    audio_core_send(cmd);
     return handle;
 }
 
@@ -186,53 +326,262 @@ int audio_core_slot_init(std::unique_ptr<Stream> in, const String &extension_hin
     return audio_core_slot_init(std::move(decoder));
 }
 
-AudioPlayerLock audio_core_get_player(int slot_handle)
+int audio_core_slot_init(std::shared_ptr<const SoundPcmData> pcm, bool repeat)
 {
-    std::unique_lock<std::mutex> ulk(g_acore.mixer_mutex_m);
-    auto it = g_acore.slots_.find(slot_handle);
-    if (it == g_acore.slots_.end())
-        return AudioPlayerLock(nullptr, std::move(ulk), &g_acore.mixer_cv);
-    return AudioPlayerLock(it->second.get(), std::move(ulk), &g_acore.mixer_cv);
+    auto decoder = std::make_unique<SDLDecoder>(pcm, repeat);
+    if (!decoder->Open())
+        return -1;
+    return audio_core_slot_init(std::move(decoder));
+}
+
+// Decodes the whole sound and marks the request as done
+static void audio_core_run_pcm_decode(SoundPcmDecodeRequest &req)
+{
+    try {
+        req.Pcm = SDLDecoder::DecodeAll(*req.Data, req.ExtHint, req.MaxSize);
+    } catch (const std::exception& e) {
+        Debug::Printf(kDbgMsg_Error, "AudioCore decode exception: %s", e.what());
+    }
+    req.Data = nullptr;
+    req.Done.store(true, std::memory_order_release);
+}
+
+void audio_core_decode_pcm(std::shared_ptr<SoundPcmDecodeRequest> req)
+{
+#if defined(AGS_DISABLE_THREADS)
+    audio_core_run_pcm_decode(*req);
+#else
+    {
+        std::lock_guard<std::mutex> lk(g_acore.decode_mutex_m);
+        g_acore.pcm_jobs_.push_back(std::move(req));
+    }
+    g_acore.decode_cv.notify_one();
+#endif
+}
+
+std::shared_ptr<const AudioPlayerStatus> audio_core_get_status(int slot_handle)
+{
+    auto it = g_acore.status_.find(slot_handle);
+    if (it == g_acore.status_.end())
+        return nullptr;
+    return it->second;
+}
+
+void audio_core_slot_play(int slot_handle)
+{
+    audio_core_send(AudioCoreCommand::kPlay, slot_handle);
+}
+
+void audio_core_slot_pause(int slot_handle)
+{
+    audio_core_send(AudioCoreCommand::kPause, slot_handle);
+}
+
+void audio_core_slot_seek(int slot_handle, float pos_ms)
+{
+    audio_core_send(AudioCoreCommand::kSeek, slot_handle, pos_ms);
+}
+
+void audio_core_slot_configure(int slot_handle, float volume, float speed, float panning)
+{
+    audio_core_send(AudioCoreCommand::kConfigure, slot_handle, volume, speed, panning);
 }
 
 void audio_core_slot_stop(int slot_handle)
 {
-    std::lock_guard<std::mutex> lk(g_acore.mixer_mutex_m);
-    g_acore.slots_[slot_handle]->Stop();
-    g_acore.slots_.erase(slot_handle);
-    g_acore.mixer_cv.notify_all();
+    g_acore.status_.erase(slot_handle);
+    audio_core_send(AudioCoreCommand::kStop, slot_handle);
 }
 
 // -------------------------------------------------------------------------------------------------
 // AUDIO PROCESSING
 // -------------------------------------------------------------------------------------------------
 
-void audio_core_entry_poll()
+// Publishes player's current state for the game thread
+static void audio_core_publish(AudioCoreSlot &slot)
+{
+    slot.Status->PositionMs.store(slot.Player->GetPositionMs(), std::memory_order_release);
+    slot.Status->PlayState.store(slot.Player->GetPlayState(), std::memory_order_release);
+}
+
+static void audio_core_process_command(AudioCoreCommand &cmd)
+{
+    if (cmd.CmdType == AudioCoreCommand::kAddSlot)
+    {
+        AudioCoreSlot &slot = g_acore.slots_[cmd.Handle];
+        slot.Player.reset(cmd.Player);
+        slot.Status = std::move(cmd.Status);
+        return;
+    }
+
+    auto it = g_acore.slots_.find(cmd.Handle);
+    if (it == g_acore.slots_.end())
+        return;
+    AudioCoreSlot &slot = it->second;
+    switch (cmd.CmdType)
+    {
+    case AudioCoreCommand::kPlay:
+        slot.Player->Play();
+        break;
+    case AudioCoreCommand::kPause:
+        slot.Player->Pause();
+        break;
+    case AudioCoreCommand::kSeek:
+        slot.Player->Seek(cmd.Args[0]);
+        break;
+    case AudioCoreCommand::kConfigure:
+        slot.Player->SetVolume(cmd.Args[0]);
+        slot.Player->SetSpeed(cmd.Args[1]);
+        slot.Player->SetPanning(cmd.Args[2]);
+        break;
+    case AudioCoreCommand::kStop:
+        slot.Player->Stop();
+        g_acore.retired_underruns += slot.Player->GetUnderrunCount();
+        g_acore.slots_.erase(it);
+        return;
+    default:
+        break;
+    }
+    audio_core_publish(slot);
+}
+
+// Runs the player's decoding step, either on a decoding thread,
+// or right away if threads are disabled
+static void audio_core_schedule_decode(const std::shared_ptr<AudioPlayer> &player)
+{
+#if defined(AGS_DISABLE_THREADS)
+    try {
+        player->Decode();
+    } catch (const std::exception& e) {
+        Debug::Printf(kDbgMsg_Error, "AudioCore decode exception: %s", e.what());
+    }
+#else
+    {
+        std::lock_guard<std::mutex> lk(g_acore.decode_mutex_m);
+        g_acore.decode_jobs_.push_back(player);
+    }
+    g_acore.decode_cv.notify_one();
+#endif
+}
+
+// Processes pending commands and polls all the slots;
+// returns if any of the slots may require further polling
+static bool audio_core_process()
 {
     // burn off any errors for new loop
     dump_al_errors();
 
+#if !defined(AGS_DISABLE_THREADS)
+    // Release players returned by the decoding threads; this is where the
+    // players of the removed slots get destroyed
+    {
+        std::vector<std::shared_ptr<AudioPlayer>> released;
+        {
+            std::lock_guard<std::mutex> lk(g_acore.decode_mutex_m);
+            released.swap(g_acore.release_jobs_);
+        }
+    }
+#endif
+
+    AudioCoreCommand cmd;
+    while (g_acore.commands_.Pop(cmd))
+    {
+        try {
+            audio_core_process_command(cmd);
+        } catch (const std::exception& e) {
+            Debug::Printf(kDbgMsg_Error, "AudioCore command exception: %s", e.what());
+        }
+    }
+
+    bool need_poll = false;
+    uint32_t underruns = g_acore.retired_underruns;
     for (auto &entry : g_acore.slots_) {
         auto &slot = entry.second;
 
         try {
-            slot->Poll();
+            slot.Player->Poll();
         } catch (const std::exception& e) {
             Debug::Printf(kDbgMsg_Error, "AudioCore poll exception: %s", e.what());
         }
+        audio_core_publish(slot);
+        const PlaybackState state = slot.Player->GetPlayState();
+        need_poll |= (state == PlayStateInitial) || (state == PlayStatePlaying);
+        underruns += slot.Player->GetUnderrunCount();
+
+        if (slot.Player->NeedsDecode() && slot.Player->ScheduleDecode())
+            audio_core_schedule_decode(slot.Player);
     }
+    g_acore.underruns.store(underruns, std::memory_order_relaxed);
+    return need_poll;
+}
+
+uint32_t audio_core_get_underrun_count()
+{
+    return g_acore.underruns.load(std::memory_order_relaxed);
+}
+
+void audio_core_entry_poll()
+{
+    audio_core_process();
 }
 
 #if !defined(AGS_DISABLE_THREADS)
 static void audio_core_entry()
 {
-    std::unique_lock<std::mutex> lk(g_acore.mixer_mutex_m);
-
     while (g_acore.audio_core_thread_running) {
 
-        audio_core_entry_poll();
+        const bool need_poll = audio_core_process();
+
+        // Sleep until the next command arrives; if there are active players,
+        // then also wake up in time to feed them with more sound data
+        std::unique_lock<std::mutex> lk(g_acore.wake_mutex_m);
+        if (need_poll)
+            g_acore.wake_cv.wait_for(lk, std::chrono::milliseconds(50),
+                [] { return g_acore.wake_pending; });
+        else
+            g_acore.wake_cv.wait(lk, [] { return g_acore.wake_pending; });
+        g_acore.wake_pending = false;
+    }
+}
 
-        g_acore.mixer_cv.wait_for(lk, std::chrono::milliseconds(50));
+static void audio_core_decoder_entry()
+{
+    std::unique_lock<std::mutex> lk(g_acore.decode_mutex_m);
+    while (true) {
+        g_acore.decode_cv.wait(lk,
+            [] { return !g_acore.decoders_running || !g_acore.decode_jobs_.empty() ||
+                        !g_acore.pcm_jobs_.empty(); });
+        if (!g_acore.decoders_running)
+            break;
+        if (g_acore.decode_jobs_.empty())
+        {
+            auto req = std::move(g_acore.pcm_jobs_.front());
+            g_acore.pcm_jobs_.pop_front();
+            lk.unlock();
+            audio_core_run_pcm_decode(*req);
+            req.reset();
+            lk.lock();
+            continue;
+        }
+        auto player = std::move(g_acore.decode_jobs_.front());
+        g_acore.decode_jobs_.pop_front();
+        lk.unlock();
+
+        try {
+            player->Decode();
+        } catch (const std::exception& e) {
+            Debug::Printf(kDbgMsg_Error, "AudioCore decode exception: %s", e.what());
+        }
+
+        // Let the audio thread pass the new data to the output;
+        // the player is handed back to it, as this may be the last reference
+        lk.lock();
+        g_acore.release_jobs_.push_back(std::move(player));
+        {
+            std::lock_guard<std::mutex> wake_lk(g_acore.wake_mutex_m);
+            g_acore.wake_pending = true;
+        }
+        g_acore.wake_cv.notify_one();
     }
 }
 #endif
@@ -17,18 +17,47 @@
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__AUDIOCORE_H
 #define __AGS_EE_MEDIA__AUDIOCORE_H
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "media/audio/audiodefines.h"
 #include "media/audio/audioplayer.h"
+#include "util/stream.h"
 #include "util/string.h"
-#include "util/threading.h"
 
 
-// AudioPlayerLock wraps a AudioPlayer pointer guarded by a mutex lock.
-// Unlocks the mutex on destruction (e.g. when going out of scope).
-typedef AGS::Engine::LockedObjectPtr<AGS::Engine::AudioPlayer>
-    AudioPlayerLock;
+// AudioPlayerStatus is a player's state, published by the audio thread
+// after processing each command and poll; it may be read by the game thread
+// at any time without locking.
+struct AudioPlayerStatus
+{
+    std::atomic<int>   PlayState{PlayStateInitial};
+    std::atomic<float> PositionMs{0.f};
+    // These are set once when the slot is created
+    float DurationMs = 0.f;
+    float Frequency = 0.f;
+
+    PlaybackState GetPlayState() const
+        { return static_cast<PlaybackState>(PlayState.load(std::memory_order_acquire)); }
+    float GetPositionMs() const
+        { return PositionMs.load(std::memory_order_acquire); }
+};
+
+// SoundPcmDecodeRequest is a request to decode the whole sound at once,
+// which is processed on a decoding thread. The game thread must not access
+// the request's data until it's marked as done.
+struct SoundPcmDecodeRequest
+{
+    // Input: the sound data and its format hint
+    std::shared_ptr<std::vector<uint8_t>> Data;
+    AGS::Common::String ExtHint;
+    size_t MaxSize = 0u;
+    // Output: the decoded sound, or null if decoding failed
+    std::shared_ptr<AGS::Engine::SoundPcmData> Pcm;
+    std::atomic<bool> Done{false};
+
+    bool IsDone() const { return Done.load(std::memory_order_acquire); }
+};
 
 // Initializes audio core system;
 // starts polling on a background thread.
@@ -42,17 +71,37 @@ void audio_core_shutdown();
 void audio_core_set_master_volume(float newvol);
 
 // Audio slot controls: slots are abstract holders for a playback.
+// All the slot controls must be called from the same (game) thread;
+// they pass commands to the audio thread and never wait for them to complete.
 //
 // Initializes playback on a free playback slot.
 // Data array must contain full wave data to play.
 int audio_core_slot_init(std::shared_ptr<std::vector<uint8_t>> &data, const AGS::Common::String &ext_hint, bool repeat);
 // Initializes playback streaming
 int audio_core_slot_init(std::unique_ptr<AGS::Common::Stream> in, const AGS::Common::String &ext_hint, bool repeat);
-// Returns a AudioPlayer from the given slot, wrapped in a auto-locking struct.
-AudioPlayerLock audio_core_get_player(int slot_handle);
+// Initializes playback of the already decoded sound
+int audio_core_slot_init(std::shared_ptr<const AGS::Engine::SoundPcmData> pcm, bool repeat);
+// Schedules decoding of the whole sound on a decoding thread
+void audio_core_decode_pcm(std::shared_ptr<SoundPcmDecodeRequest> req);
+// Returns the published status of the player at the given slot,
+// or null if there's no such slot
+std::shared_ptr<const AudioPlayerStatus> audio_core_get_status(int slot_handle);
+// Begin or resume the playback
+void audio_core_slot_play(int slot_handle);
+// Pause the playback
+void audio_core_slot_pause(int slot_handle);
+// Seek to the given time position
+void audio_core_slot_seek(int slot_handle, float pos_ms);
+// Sets the playback parameters: volume (gain), speed (fraction of normal)
+// and panning (-1.0f to 1.0)
+void audio_core_slot_configure(int slot_handle, float volume, float speed, float panning);
 // Stop and release the audio player at the given slot
 void audio_core_slot_stop(int slot_handle);
 
+// Returns the total number of times the players ran out of decoded data
+// while playing; meant for diagnostics
+uint32_t audio_core_get_underrun_count();
+
 #if defined(AGS_DISABLE_THREADS)
 // Polls the audio core if we have no threads, polled in WaitForNextFrame()
 void audio_core_entry_poll();
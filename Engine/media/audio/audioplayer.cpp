@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include "media/audio/audioplayer.h"
+#include <algorithm>
 #include "util/memory_compat.h"
 
 namespace AGS
@@ -19,6 +20,10 @@ namespace AGS
 namespace Engine
 {
 
+// Number of consecutive polls with the output queue full,
+// after which the decode-ahead amount may be reduced
+static const unsigned DecodeAheadRelaxPolls = 200;
+
 AudioPlayer::AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder)
     : handle_(handle), _decoder(std::move(decoder))
 {
@@ -28,16 +33,54 @@ AudioPlayer::AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder)
 
 void AudioPlayer::Init()
 {
+    std::lock_guard<std::mutex> lk(_decodeMutex);
     bool success;
     if (_decoder->IsValid()) // if already opened, then just seek to start
         success = _decoder->Seek(_onLoadPositionMs) == _onLoadPositionMs;
     else
         success = _decoder->Open(_onLoadPositionMs);
     _playState = success ? _onLoadPlayState : PlayStateError;
+    _decodeEOS = _decoder->EOS();
+    _decodeActive = (_playState == PlayStatePlaying) && !_decoder->GetPcmData();
     if (_playState == PlayStatePlaying)
         _source->Play();
 }
 
+bool AudioPlayer::NeedsDecode() const
+{
+    return _decodeActive && !_decodeEOS && (_decodedCount < _decodeAhead);
+}
+
+void AudioPlayer::Decode()
+{
+    std::lock_guard<std::mutex> lk(_decodeMutex);
+    _decodeScheduled = false;
+    if (!_decodeActive)
+        return;
+    while (!_decoder->EOS() && (_decodedChunks.size() < _decodeAhead))
+    {
+        SoundBuffer buf = _decoder->GetData();
+        if (!buf.Data || (buf.Size == 0))
+            break; // may be an empty buffer at EOS, or a decoding error
+        // Decoder's buffer is reused on each call, so copy the data
+        DecodedChunk chunk;
+        const uint8_t *data = static_cast<const uint8_t*>(buf.Data);
+        chunk.Data.assign(data, data + buf.Size);
+        chunk.Ts = buf.Ts;
+        chunk.DurMs = buf.DurMs;
+        _decodedChunks.push_back(std::move(chunk));
+    }
+    _decodedCount = static_cast<unsigned>(_decodedChunks.size());
+    _decodeEOS = _decoder->EOS();
+}
+
+void AudioPlayer::ClearDecodedChunks()
+{
+    _decodedChunks.clear();
+    _decodedCount = 0u;
+    _decodeEOS = _decoder->EOS();
+}
+
 void AudioPlayer::Poll()
 {
     if (_playState == PlaybackState::PlayStateInitial)
@@ -45,7 +88,30 @@ void AudioPlayer::Poll()
     if (_playState != PlayStatePlaying)
         return;
 
-    // Read data from Decoder and pass into the Al Source
+    if (_decoder->GetPcmData())
+        PollPcmData();
+    else
+        PollDecodedChunks();
+}
+
+void AudioPlayer::PollPcmData()
+{
+    // If the sound is played from the start, then try passing it whole,
+    // which lets reuse the same AL buffer
+    if (!_sharedPlayback && !_bufferPending.Data &&
+        (_decoder->GetPositionMs() == 0.f) && _source->CanPutShared())
+    {
+        _sharedPlayback = _source->PutShared(_decoder->GetPcmData(), _decoder->IsRepeating()) > 0;
+    }
+    if (_sharedPlayback)
+    {
+        _source->Poll();
+        if (_source->IsEmpty())
+            _playState = PlayStateFinished;
+        return;
+    }
+
+    // Decoded data is immutable, so its chunks may be passed without copying
     if (!_bufferPending.Data && !_decoder->EOS())
     { // if no buffer saved, and still something to decode, then read a buffer
         _bufferPending = _decoder->GetData();
@@ -64,6 +130,65 @@ void AudioPlayer::Poll()
     }
 }
 
+void AudioPlayer::PollDecodedChunks()
+{
+    // Pass as many decoded chunks as the output accepts; if the decoder
+    // is busy at the moment, then simply try again on the next poll
+    bool queue_full = false;
+    {
+        std::unique_lock<std::mutex> lk(_decodeMutex, std::try_to_lock);
+        if (lk.owns_lock())
+        {
+            while (!_decodedChunks.empty())
+            {
+                const auto &chunk = _decodedChunks.front();
+                if (_source->PutData(SoundBuffer(chunk.Data.data(), chunk.Data.size(), chunk.Ts, chunk.DurMs)) == 0)
+                {
+                    queue_full = true;
+                    break;
+                }
+                _decodedChunks.pop_front();
+                _started = true;
+            }
+            _decodedCount = static_cast<unsigned>(_decodedChunks.size());
+        }
+    }
+    _source->Poll();
+
+    const bool decode_done = _decodeEOS && (_decodedCount == 0);
+    if (decode_done)
+    {
+        // If both finished decoding and playing, we done here.
+        if (_source->IsEmpty())
+        {
+            _playState = PlayStateFinished;
+            _decodeActive = false;
+        }
+        return;
+    }
+
+    // Adapt the decode-ahead amount: decode more if output ran dry,
+    // and gradually reduce if it's been saturated for long enough
+    // (an underrun is counted once, until the output receives data again)
+    if (_started && _source->IsEmpty())
+    {
+        if (!_starved)
+        {
+            _underruns++;
+            _decodeAhead = std::min(_decodeAhead.load() + 1, MaxDecodeAhead);
+        }
+        _starved = true;
+        _fullPolls = 0u;
+        return;
+    }
+    _starved = false;
+    if (queue_full && (++_fullPolls >= DecodeAheadRelaxPolls))
+    {
+        _fullPolls = 0u;
+        _decodeAhead = std::max(_decodeAhead.load() - 1, MinDecodeAhead);
+    }
+}
+
 void AudioPlayer::Play()
 {
     switch (_playState)
@@ -72,10 +197,17 @@ void AudioPlayer::Play()
         _onLoadPlayState = PlayStatePlaying;
         break;
     case PlayStateStopped:
-        _decoder->Seek(0.0f);
+        {
+            std::lock_guard<std::mutex> lk(_decodeMutex);
+            _decoder->Seek(0.0f);
+            ClearDecodedChunks();
+            _started = false;
+            _starved = false;
+        }
         /* fall-through */
     case PlayStatePaused:
         _playState = PlayStatePlaying;
+        _decodeActive = !_decoder->GetPcmData();
         _source->Play();
         break;
     default:
@@ -108,9 +240,15 @@ void AudioPlayer::Stop()
         break;
     case PlayStatePlaying:
     case PlayStatePaused:
-        _playState = PlayStateStopped;
-        _source->Stop();
-        _bufferPending = SoundBuffer(); // clear
+        {
+            std::lock_guard<std::mutex> lk(_decodeMutex);
+            _playState = PlayStateStopped;
+            _decodeActive = false;
+            _source->Stop();
+            _bufferPending = SoundBuffer(); // clear
+            _sharedPlayback = false;
+            ClearDecodedChunks();
+        }
         break;
     default:
         break;
@@ -128,9 +266,14 @@ void AudioPlayer::Seek(float pos_ms)
     case PlayStatePaused:
     case PlayStateStopped:
         {
+            std::lock_guard<std::mutex> lk(_decodeMutex);
             _source->Stop();
             _bufferPending = SoundBuffer(); // clear
+            _sharedPlayback = false;
             float new_pos = _decoder->Seek(pos_ms);
+            ClearDecodedChunks();
+            _started = false;
+            _starved = false;
             _source->SetPlaybackPosMs(new_pos);
         }
         break;
@@ -16,6 +16,12 @@
 // Controls playback state. Retrieves audio data from decoder and passes into
 // the audio output.
 //
+// Decoding may be done separately from the rest of the playback control:
+// Decode() may be called on a worker thread, and it decodes a number of
+// sound chunks ahead; Poll() only passes already decoded chunks to the
+// audio output. The number of chunks decoded ahead adapts to how often the
+// output runs out of data.
+//
 // TODO: a virtual Decoder and AudioOutput interfaces, to let hide current
 // implementations, and also substitute default implementations
 // (e.g. with plugins).
@@ -23,7 +29,11 @@
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__AUDIOPLAYER_H
 #define __AGS_EE_MEDIA__AUDIOPLAYER_H
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "media/audio/audiodefines.h" // PlaybackState etc
 #include "media/audio/sdldecoder.h"
 #include "media/audio/openalsource.h"
@@ -36,6 +46,10 @@ namespace Engine
 class AudioPlayer
 {
 public:
+    // Min and max number of chunks to decode ahead
+    static const unsigned MinDecodeAhead = 2;
+    static const unsigned MaxDecodeAhead = 8;
+
     AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder);
 
     // Gets current playback state
@@ -46,6 +60,8 @@ public:
     float GetDurationMs() const { return _decoder->GetDurationMs(); }
     // Gets playback position, in ms
     float GetPositionMs() const { return _source->GetPositionMs(); }
+    // Gets the number of times the output ran out of data while playing
+    uint32_t GetUnderrunCount() const { return _underruns; }
 
     // Sets the sound panning (-1.0f to 1.0)
     void SetPanning(float panning) { _source->SetPanning(panning); }
@@ -55,6 +71,14 @@ public:
     // Sets the playback volume (gain)
     void SetVolume(float volume) { _source->SetVolume(volume); }
 
+    // Tells if the player wants more data decoded with Decode()
+    bool NeedsDecode() const;
+    // Marks the player as scheduled for decoding; returns false if it
+    // has already been scheduled and not decoded yet
+    bool ScheduleDecode() { return !_decodeScheduled.exchange(true); }
+    // Decodes more sound chunks ahead; safe to call from another thread
+    void Decode();
+
     // Update state, transfer data from decoder to player if possible
     void Poll();
     // Begin playback
@@ -67,16 +91,48 @@ public:
     void Seek(float pos_ms);
 
 private:
+    // A chunk of sound data decoded ahead
+    struct DecodedChunk
+    {
+        std::vector<uint8_t> Data;
+        float Ts = 0.f;
+        float DurMs = 0.f;
+    };
+
     // Opens decoder and sets up playback state
     void Init();
+    // Passes the already decoded sound data into the output
+    void PollPcmData();
+    // Passes the chunks decoded ahead into the output
+    void PollDecodedChunks();
+    // Drops all the chunks decoded ahead; expects decoder lock
+    void ClearDecodedChunks();
 
     const int handle_ = -1; // for diagnostic purposes only
     std::unique_ptr<SDLDecoder> _decoder;
     std::unique_ptr<OpenAlSource> _source;
     PlaybackState _playState = PlayStateInitial;
     PlaybackState _onLoadPlayState = PlayStatePaused;
-    float _onLoadPositionMs = 0.0f;
+    float _onLoadPositionMs = 0.f;
     SoundBuffer _bufferPending{};
+    // Whether the whole sound was queued at once as a shared buffer
+    bool _sharedPlayback = false;
+
+    // Decoder and decoded chunks are guarded by this mutex
+    std::mutex _decodeMutex;
+    std::deque<DecodedChunk> _decodedChunks;
+    std::atomic<bool> _decodeScheduled{false};
+    std::atomic<bool> _decodeActive{false}; // playing and decoding
+    std::atomic<bool> _decodeEOS{false};
+    std::atomic<unsigned> _decodedCount{0u};
+    std::atomic<unsigned> _decodeAhead{MinDecodeAhead};
+    // Number of polls with the output queue full
+    unsigned _fullPolls = 0u;
+    // Whether any data was passed to the output since start or seek
+    bool _started = false;
+    // Whether the output has run out of data, and did not receive any since
+    bool _starved = false;
+    std::atomic<uint32_t> _underruns{0u};
 };
 
 } // namespace Engine
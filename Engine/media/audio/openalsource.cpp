@@ -14,6 +14,7 @@
 #include "media/audio/openalsource.h"
 #include <algorithm>
 #include <cmath>
+#include <unordered_map>
 #include "debug/out.h"
 
 using namespace AGS::Common;
@@ -83,18 +84,62 @@ static float GetBufferMs(ALuint buf_id)
     return 1000.0f * (float)num_samples / (float)freq;
 }
 
+// An al buffer filled with the whole decoded sound
+struct SharedAlBuffer
+{
+    std::weak_ptr<const SoundPcmData> Pcm;
+    ALuint BufId = 0u;
+};
+
 // Internal OpenAl-related resources
 static struct
 {
     // A record of available al buffers
     std::vector<ALuint> freeBuffers;
+    // Shared buffers, by the sound data they were made of
+    std::unordered_map<const SoundPcmData*, SharedAlBuffer> sharedBuffers;
 } g_oalint;
 
+// Deletes shared buffers whose sound data was disposed; these are not used
+// by any source, as sources keep references to the data while playing
+static void DisposeUnusedSharedBuffers()
+{
+    for (auto it = g_oalint.sharedBuffers.begin(); it != g_oalint.sharedBuffers.end();)
+    {
+        if (it->second.Pcm.expired())
+        {
+            alDeleteBuffers(1, &it->second.BufId);
+            dump_al_errors();
+            it = g_oalint.sharedBuffers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 
 //-----------------------------------------------------------------------------
 // OpenAlSource
 //-----------------------------------------------------------------------------
 
+void OpenAlSource::DeleteBuffers()
+{
+    if (!g_oalint.freeBuffers.empty())
+    {
+        alDeleteBuffers(static_cast<ALsizei>(g_oalint.freeBuffers.size()), g_oalint.freeBuffers.data());
+        dump_al_errors();
+        g_oalint.freeBuffers.clear();
+    }
+    for (auto &shared_buf : g_oalint.sharedBuffers)
+    {
+        alDeleteBuffers(1, &shared_buf.second.BufId);
+        dump_al_errors();
+    }
+    g_oalint.sharedBuffers.clear();
+}
+
 OpenAlSource::OpenAlSource(SDL_AudioFormat format, int channels, int freq)
 {
     _inputFmt.format = format;
@@ -198,6 +243,46 @@ size_t OpenAlSource::PutData(const SoundBuffer &data)
     return data.Size;
 }
 
+size_t OpenAlSource::PutShared(const std::shared_ptr<const SoundPcmData> &pcm, bool loop)
+{
+    Unqueue();
+    if (!CanPutShared() || !pcm || pcm->Data.empty()) { return 0u; }
+
+    // Find existing buffer for this data, or create and fill a new one
+    DisposeUnusedSharedBuffers();
+    ALuint buf_id = 0u;
+    auto it = g_oalint.sharedBuffers.find(pcm.get());
+    if (it != g_oalint.sharedBuffers.end())
+    {
+        buf_id = it->second.BufId;
+    }
+    else
+    {
+        size_t conv_sz = pcm->Data.size();
+        const void *conv = _resampler.Convert(pcm->Data.data(), pcm->Data.size(), conv_sz);
+        if (!conv) { return 0u; }
+        alGenBuffers(1, &buf_id);
+        dump_al_errors();
+        alBufferData(buf_id, _alFormat, conv, conv_sz, _recvFmt.rate);
+        dump_al_errors();
+        SharedAlBuffer shared_buf;
+        shared_buf.Pcm = pcm;
+        shared_buf.BufId = buf_id;
+        g_oalint.sharedBuffers[pcm.get()] = shared_buf;
+    }
+
+    alSourcei(_source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
+    dump_al_errors();
+    alSourceQueueBuffers(_source, 1, &buf_id);
+    dump_al_errors();
+    _queued++;
+    _sharedPcm = pcm;
+    _sharedBuffer = buf_id;
+    _bufferRecords.push_back(BufferRecord(0.f, pcm->DurationMs, _speed));
+    _predictTs = pcm->DurationMs;
+    return pcm->Data.size();
+}
+
 void OpenAlSource::Unqueue()
 {
     for (;;)
@@ -215,6 +300,14 @@ void OpenAlSource::Unqueue()
         assert(_bufferRecords.size() > 0);
         _bufferRecords.pop_front();
 
+        if (buf_id == _sharedBuffer)
+        { // shared buffers are never reused for other data
+            alSourcei(_source, AL_LOOPING, AL_FALSE);
+            dump_al_errors();
+            _sharedBuffer = 0u;
+            _sharedPcm = nullptr;
+            continue;
+        }
         g_oalint.freeBuffers.push_back(buf_id);
     }
 }
@@ -21,6 +21,7 @@
 #ifndef __AGS_EE_MEDIA__OPENALSOURCE_H
 #define __AGS_EE_MEDIA__OPENALSOURCE_H
 #include <deque>
+#include <memory>
 #include "media/audio/audiodefines.h"
 #include "media/audio/openal.h"
 #include "media/audio/sdldecoder.h"
@@ -42,6 +43,10 @@ public:
     OpenAlSource(OpenAlSource&& src);
     ~OpenAlSource();
 
+    // Deletes all the al buffers kept for reuse, including the shared ones;
+    // must be called when there are no more sources, before the context is destroyed
+    static void DeleteBuffers();
+
     // Tells if the al source is valid and usable
     bool IsValid() const { return _source > 0; }
     // Gets current playback state
@@ -54,6 +59,13 @@ public:
     // Try putting data into the queue; returns amount of data copied,
     // or 0 if data cannot be accepted at the moment.
     size_t PutData(const SoundBuffer &data);
+    // Tells if the whole decoded sound may be queued as a shared buffer
+    bool CanPutShared() const { return (_queued == 0) && (_speed == 1.f); }
+    // Queues whole decoded sound, using an immutable AL buffer which is
+    // shared among all sources playing the same data; the buffer is created
+    // on the first use, and kept for as long as the sound data exists.
+    // Returns amount of data queued, or 0 if data cannot be accepted.
+    size_t PutShared(const std::shared_ptr<const SoundPcmData> &pcm, bool loop);
     // Updates the state, processes the sound queue
     ALuint Poll();
 
@@ -88,6 +100,9 @@ private:
     float _speed = 1.f; // change in playback rate
     float _predictTs = 0.f; // next timestamp prediction
     unsigned _queued = 0u;
+    // Shared sound data and the buffer, if one is currently queued
+    std::shared_ptr<const SoundPcmData> _sharedPcm;
+    ALuint _sharedBuffer = 0u;
 
     // SDL resampler state, in case dynamic resampling in necessary
     SDLResampler _resampler;
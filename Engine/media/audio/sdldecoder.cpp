@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include "media/audio/sdldecoder.h"
+#include <algorithm>
 #include "util/sdl2_util.h"
 
 namespace AGS
@@ -73,9 +74,18 @@ SDLDecoder::SDLDecoder(std::unique_ptr<Stream> in,
 {
 }
 
+SDLDecoder::SDLDecoder(std::shared_ptr<const SoundPcmData> pcm, bool repeat)
+    : _pcm(pcm)
+    , _repeat(repeat)
+{
+    _durationMs = _pcm->DurationMs;
+}
+
 SDLDecoder::SDLDecoder(SDLDecoder &&dec)
 {
     _sampleData = (std::move(dec._sampleData));
+    _pcm = std::move(dec._pcm);
+    _pcmOpened = dec._pcmOpened;
     _rwops = std::move(dec._rwops);
     dec._rwops = nullptr;
     _sampleExt = std::move(dec._sampleExt);
@@ -86,6 +96,16 @@ bool SDLDecoder::Open(float pos_ms)
 {
     // Prevent from "reopening" twice
     assert(!_sample);
+    if (_pcm)
+    {
+        _pcmOpened = true;
+        _posBytes = 0u;
+        _posMs = 0.f;
+        if (pos_ms > 0.f)
+            Seek(pos_ms);
+        return true;
+    }
+
     if (_sample && pos_ms > 0.f)
     {
         Seek(pos_ms);
@@ -123,6 +143,8 @@ bool SDLDecoder::Open(float pos_ms)
 
 void SDLDecoder::Close()
 {
+    _pcm = nullptr;
+    _pcmOpened = false;
     _sample.reset();
     _rwops = nullptr; // rwops was closed by the Sound_NewSample
     _sampleData = nullptr;
@@ -130,6 +152,19 @@ void SDLDecoder::Close()
 
 float SDLDecoder::Seek(float pos_ms)
 {
+    if (_pcmOpened)
+    {
+        if (pos_ms < 0.f)
+            return _posMs;
+        // Align to the whole sample frame
+        const size_t frame_sz = SoundHelper::BytesPerSample(_pcm->Format) * _pcm->Channels;
+        size_t pos_bytes = SoundHelper::BytesPerMs(pos_ms, _pcm->Format, _pcm->Channels, _pcm->Freq);
+        pos_bytes = std::min(pos_bytes - pos_bytes % frame_sz, _pcm->Data.size());
+        _posBytes = pos_bytes;
+        _posMs = SoundHelper::MillisecondsFromBytes(_posBytes, _pcm->Format, _pcm->Channels, _pcm->Freq);
+        _EOS = false;
+        return _posMs;
+    }
     if (!_sample || pos_ms < 0.f)
         return _posMs;
     if (Sound_Seek(_sample.get(), static_cast<uint32_t>(pos_ms)) == 0)
@@ -140,8 +175,33 @@ float SDLDecoder::Seek(float pos_ms)
     return pos_ms; // new pos on success
 }
 
+SoundBuffer SDLDecoder::GetPcmChunk()
+{
+    if (_posBytes >= _pcm->Data.size())
+    {
+        if (!_repeat)
+        {
+            _EOS = true;
+            return SoundBuffer();
+        }
+        _posBytes = 0u;
+        _posMs = 0.f;
+    }
+    const float old_pos = _posMs;
+    const size_t sz = std::min<size_t>(SampleDefaultBufferSize, _pcm->Data.size() - _posBytes);
+    const uint8_t *data = _pcm->Data.data() + _posBytes;
+    _posBytes += sz;
+    _posMs = SoundHelper::MillisecondsFromBytes(_posBytes, _pcm->Format, _pcm->Channels, _pcm->Freq);
+    if ((_posBytes >= _pcm->Data.size()) && !_repeat)
+        _EOS = true;
+    return SoundBuffer(data, sz, old_pos,
+        SoundHelper::MillisecondsFromBytes(sz, _pcm->Format, _pcm->Channels, _pcm->Freq));
+}
+
 SoundBuffer SDLDecoder::GetData()
 {
+    if (_pcmOpened)
+        return _EOS ? SoundBuffer() : GetPcmChunk();
     if (!_sample || _EOS)
         return SoundBuffer();
     float old_pos = _posMs;
@@ -171,5 +231,31 @@ SoundBuffer SDLDecoder::GetData()
         SoundHelper::MillisecondsFromBytes(sz, _sample->desired.format, _sample->desired.channels, _sample->desired.rate));
 }
 
+/* static */ std::shared_ptr<SoundPcmData> SDLDecoder::DecodeAll(const std::vector<uint8_t> &data,
+    const String &ext_hint, size_t max_size)
+{
+    SoundSampleUniquePtr sample(Sound_NewSampleFromMem(
+        data.data(), data.size(), ext_hint.GetCStr(), nullptr, SampleDefaultBufferSize));
+    if (!sample)
+        return nullptr;
+    // Test the expected size first, if duration is known
+    const auto &fmt = sample->desired;
+    const int dur = Sound_GetDuration(sample.get());
+    if ((dur < 0) || (SoundHelper::BytesPerMs(static_cast<float>(dur), fmt.format, fmt.channels, fmt.rate) > max_size))
+        return nullptr;
+    const size_t sz = Sound_DecodeAll(sample.get());
+    if (((sample->flags & SOUND_SAMPLEFLAG_ERROR) != 0) || (sz == 0) || (sz > max_size))
+        return nullptr;
+
+    auto pcm = std::make_shared<SoundPcmData>();
+    const uint8_t *buf = static_cast<const uint8_t*>(sample->buffer);
+    pcm->Data.assign(buf, buf + sz);
+    pcm->Format = fmt.format;
+    pcm->Channels = fmt.channels;
+    pcm->Freq = fmt.rate;
+    pcm->DurationMs = SoundHelper::MillisecondsFromBytes(sz, fmt.format, fmt.channels, fmt.rate);
+    return pcm;
+}
+
 } // namespace Engine
 } // namespace AGS
@@ -67,6 +67,17 @@ struct SoundBuffer
     operator bool() const { return Data && Size > 0; }
 };
 
+// SoundPcmData is a fully decoded sound, kept in memory for repeated use;
+// must not be modified after it's been created.
+struct SoundPcmData
+{
+    std::vector<uint8_t> Data;
+    SDL_AudioFormat Format = 0;
+    int Channels = 0;
+    int Freq = 0;
+    float DurationMs = 0.f;
+};
+
 // RAII wrapper over SDL resampling filter;
 // initialized by passing input and desired sound format;
 // tells whether conversion is necessary and performs one on command.
@@ -107,17 +118,29 @@ public:
     SDLDecoder(std::shared_ptr<std::vector<uint8_t>> &data, const String &ext_hint, bool repeat);
     // Initializes decoder with an input stream
     SDLDecoder(const std::unique_ptr<Stream> in, const String &ext_hint, bool repeat);
+    // Initializes decoder with an already decoded sound; such decoder simply
+    // returns parts of the existing data, without any processing
+    SDLDecoder(std::shared_ptr<const SoundPcmData> pcm, bool repeat);
     SDLDecoder(SDLDecoder&& dec);
     ~SDLDecoder() = default;
 
+    // Decodes whole sound data at once; fails if the decoded data would
+    // exceed the given size limit
+    static std::shared_ptr<SoundPcmData> DecodeAll(const std::vector<uint8_t> &data,
+        const String &ext_hint, size_t max_size);
+
     // Tells if the decoder is in a valid state, ready to work
-    bool IsValid() const { return _sample != nullptr; }
+    bool IsValid() const { return (_sample != nullptr) || _pcmOpened; }
     // Gets the audio format
-    SDL_AudioFormat GetFormat() const { return _sample ? _sample->desired.format : 0; }
+    SDL_AudioFormat GetFormat() const { return _pcm ? _pcm->Format : (_sample ? _sample->desired.format : 0); }
     // Gets the number of channels
-    int GetChannels() const { return _sample ? _sample->desired.channels : 0; }
+    int GetChannels() const { return _pcm ? _pcm->Channels : (_sample ? _sample->desired.channels : 0); }
     // Gets the audio rate (frequency)
-    int GetFreq() const { return _sample ? _sample->desired.rate : 0; }
+    int GetFreq() const { return _pcm ? _pcm->Freq : (_sample ? _sample->desired.rate : 0); }
+    // Tells if the sound is played in a loop
+    bool IsRepeating() const { return _repeat; }
+    // Gets the decoded sound data, if decoder was initialized with one
+    const std::shared_ptr<const SoundPcmData> &GetPcmData() const { return _pcm; }
     // Tells if the data reading has reached EOS
     bool EOS() const { return _EOS; }
     // Gets current reading position, in ms
@@ -135,10 +158,15 @@ public:
     SoundBuffer GetData();
 
 private:
+    // Returns the next chunk of the decoded sound data
+    SoundBuffer GetPcmChunk();
+
     SDL_RWops *_rwops = nullptr;
     std::shared_ptr<std::vector<uint8_t>> _sampleData{};
     String _sampleExt = "";
     SoundSampleUniquePtr _sample = nullptr;
+    std::shared_ptr<const SoundPcmData> _pcm;
+    bool _pcmOpened = false;
     float _durationMs = 0.f;
     bool _repeat = false;
     bool _EOS = false;
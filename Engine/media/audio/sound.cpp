@@ -19,6 +19,7 @@
 #include "debug/out.h"
 #include "media/audio/audio_core.h"
 #include "media/audio/audiodefines.h"
+#include "media/audio/sdldecoder.h"
 #include "util/path.h"
 #include "util/resourcecache.h"
 #include "util/stream.h"
@@ -84,21 +85,52 @@ private:
 };
 
 
+// Decoded sound cache, stores most recent used short sounds in PCM format,
+// which lets play them again without decoding.
+class SoundPcmCache final :
+    public ResourceCache<String, std::shared_ptr<const SoundPcmData>>
+{
+public:
+    typedef std::shared_ptr<const SoundPcmData> DataRef;
+
+    SoundPcmCache() : ResourceCache(DEFAULT_SOUNDPCMCACHESIZE_KB)
+    {
+    }
+
+private:
+    size_t CalcSize(const DataRef &item) override
+    {
+        assert(item);
+        return item ? item->Data.size() : 0u;
+    }
+};
+
+
 // Maximal sound asset size which is allowed to be loaded at once;
 // anything larger will be streamed
 static size_t MaxLoadAtOnce = DEFAULT_SOUNDLOADATONCE_KB;
+// Maximal size of a decoded sound, which may be put into the PCM cache
+static const size_t MaxPcmClipSize = 2 * 1024 * 1024;
 static SoundCache SndCache;
+static SoundPcmCache SndPcmCache;
+// Sounds that are being decoded for the PCM cache on the decoding threads;
+// requests that failed are kept here, so that these sounds are not tried again
+static std::unordered_map<String, std::shared_ptr<SoundPcmDecodeRequest>> SndPcmPending;
 
-void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize)
+void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize, size_t max_pcmcachesize)
 {
     MaxLoadAtOnce = max_loadatonce;
     SndCache.SetMaxCacheSize(max_cachesize);
-    Debug::Printf("Sound cache set: %zu KB", max_cachesize / 1024);
+    SndPcmCache.SetMaxCacheSize(max_pcmcachesize);
+    Debug::Printf("Sound cache set: %zu KB, decoded sound cache: %zu KB",
+        max_cachesize / 1024, max_pcmcachesize / 1024);
 }
 
 void soundcache_clear()
 {
     SndCache.Clear();
+    SndPcmCache.Clear();
+    SndPcmPending.clear(); // any running decoding keeps its own request
 }
 
 void soundcache_precache(const AssetPath &apath)
@@ -119,14 +151,70 @@ void soundcache_precache(const AssetPath &apath)
     SndCache.Put(apath.Name, sounddata);
 }
 
+// Tells if the sound of this type may be decoded and cached as PCM
+static bool is_pcm_cacheable(AudioFileType sound_type)
+{
+    // MIDI and tracker music are not fit for this,
+    // and too long to be considered anyway
+    return (sound_type == eAudioFileWAV) || (sound_type == eAudioFileOGG) ||
+        (sound_type == eAudioFileMP3) || (sound_type == eAudioFileFLAC);
+}
+
+// Moves the sound into the PCM cache, if it has finished decoding on a decoding thread
+static std::shared_ptr<const SoundPcmData> collect_decoded_pcm(const String &name)
+{
+    auto it = SndPcmPending.find(name);
+    if ((it == SndPcmPending.end()) || !it->second->IsDone() || !it->second->Pcm)
+        return nullptr;
+    std::shared_ptr<const SoundPcmData> pcm = std::move(it->second->Pcm);
+    SndPcmPending.erase(it);
+    SndPcmCache.Put(name, pcm);
+    SndCache.Dispose(name); // compressed data is no longer needed
+    return pcm;
+}
+
+// Begins decoding of the whole sound on a decoding thread, unless one was already requested
+static void request_decoded_pcm(const String &name, std::shared_ptr<std::vector<uint8_t>> &sounddata,
+    const String &ext_hint)
+{
+    if (SndPcmPending.count(name) > 0)
+        return;
+    auto req = std::make_shared<SoundPcmDecodeRequest>();
+    req->Data = sounddata;
+    req->ExtHint = ext_hint.GetCStr(); // make a separate copy for the other thread
+    req->MaxSize = MaxPcmClipSize;
+    SndPcmPending[name] = req;
+    audio_core_decode_pcm(std::move(req));
+}
+
 SOUNDCLIP *load_sound_clip(const AssetPath &apath, const char *extension_hint, bool loop)
 {
+    const auto asset_ext = AGS::Common::Path::GetFileExtension(apath.Name);
+    const auto ext_hint = asset_ext.IsEmpty() ? String(extension_hint) : asset_ext;
+    const auto sound_type = GuessSoundTypeFromExt(ext_hint);
+
+    // If this sound was decoded before, then simply play decoded data
+    auto pcm = SndPcmCache.Get(apath.Name);
+    if (!pcm)
+        pcm = collect_decoded_pcm(apath.Name);
+    if (pcm)
+    {
+        int slot = audio_core_slot_init(pcm, loop);
+        if (slot < 0) { return nullptr; }
+        return new SOUNDCLIP(slot, sound_type, loop);
+    }
+
     size_t asset_size;
     std::unique_ptr<Stream> s_in;
     auto sounddata = SndCache.Get(apath.Name);
     if (sounddata)
     {
         asset_size = sounddata->size();
+        // The sound is played repeatedly: if it's short, then decode it once
+        // in the background and keep decoded, so that subsequent plays won't
+        // have to; this time it is played from the compressed data
+        if ((SndPcmCache.GetMaxCacheSize() > 0) && is_pcm_cacheable(sound_type))
+            request_decoded_pcm(apath.Name, sounddata, ext_hint);
     }
     else
     {
@@ -136,9 +224,6 @@ SOUNDCLIP *load_sound_clip(const AssetPath &apath, const char *extension_hint, b
         asset_size = static_cast<size_t>(s_in->GetLength());
     }
 
-    const auto asset_ext = AGS::Common::Path::GetFileExtension(apath.Name);
-    const auto ext_hint = asset_ext.IsEmpty() ? String(extension_hint) : asset_ext;
-
     int slot{};
     // If sound data was cached, or asset's size is small enough to load at once,
     // then load/use it and update the cache if necessary
@@ -159,7 +244,5 @@ SOUNDCLIP *load_sound_clip(const AssetPath &apath, const char *extension_hint, b
     }
 
     if (slot < 0) { return nullptr; }
-
-    const auto sound_type = GuessSoundTypeFromExt(ext_hint);
     return new SOUNDCLIP(slot, sound_type, loop);
 }
@@ -25,11 +25,14 @@
 const size_t DEFAULT_SOUNDLOADATONCE_KB = 1024u;
 // Sound cache limit, in KB
 const size_t DEFAULT_SOUNDCACHESIZE_KB = 1024u * 32; // 32 MB
+// Decoded sound cache limit, in KB
+const size_t DEFAULT_SOUNDPCMCACHESIZE_KB = 1024u * 16; // 16 MB
 
 // Sets sound loading and caching rules:
 // * max_loadatonce - threshold in bytes for loading sounds immediately, vs streaming
 // * max_cachesize - sound cache limit, in bytes
-void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize);
+// * max_pcmcachesize - decoded sound cache limit, in bytes
+void soundcache_set_rules(size_t max_loadatonce, size_t max_cachesize, size_t max_pcmcachesize);
 void soundcache_clear();
 void soundcache_precache(const AssetPath &apath);
 
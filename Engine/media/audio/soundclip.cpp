@@ -38,9 +38,9 @@ SOUNDCLIP::SOUNDCLIP(int slot, AudioFileType snd_type, bool loop)
     pos = posMs = -1;
     paramsChanged = true;
 
-    const auto player = audio_core_get_player(slot);
-    lengthMs = (int)std::round(player->GetDurationMs());
-    freq = player->GetFrequency();
+    status_ = audio_core_get_status(slot);
+    lengthMs = status_ ? (int)std::round(status_->DurationMs) : 0;
+    freq = status_ ? status_->Frequency : 0;
 }
 
 SOUNDCLIP::~SOUNDCLIP()
@@ -61,9 +61,9 @@ void SOUNDCLIP::pause()
 {
     if (!is_ready())
         return;
-    auto player = audio_core_get_player(slot_);
-    player->Pause();
-    state = player->GetPlayState();
+    audio_core_slot_pause(slot_);
+    if (state == PlaybackState::PlayStatePlaying)
+        state = PlaybackState::PlayStatePaused;
 }
 
 void SOUNDCLIP::resume()
@@ -110,14 +110,13 @@ void SOUNDCLIP::seek(int pos_)
 void SOUNDCLIP::seek_ms(int pos_ms)
 {
     if (slot_ < 0) { return; }
-    auto player = audio_core_get_player(slot_);
-    player->Pause();
+    audio_core_slot_pause(slot_);
     // TODO: for backward compatibility and MOD/XM music support
     // need to reimplement seeking to a position which units
     // are defined according to the sound type
-    player->Seek((float)pos_ms);
-    float posms_f = player->GetPositionMs();
-    posMs = static_cast<int>(posms_f);
+    audio_core_slot_seek(slot_, (float)pos_ms);
+    // The seek is done asynchronously, assume the requested position for now
+    posMs = pos_ms;
     pos = posms_to_pos(posMs);
 }
 
@@ -125,7 +124,6 @@ bool SOUNDCLIP::update()
 {
     if (!is_ready()) return false;
 
-    auto player = audio_core_get_player(slot_);
     if (paramsChanged)
     {
         auto vol_f = static_cast<float>(get_final_volume()) / 255.0f;
@@ -140,14 +138,12 @@ bool SOUNDCLIP::update()
         if (panning_f < -1.0f) { panning_f = -1.0f; }
         if (panning_f > 1.0f) { panning_f = 1.0f; }
 
-        player->SetVolume(vol_f);
-        player->SetSpeed(speed_f);
-        player->SetPanning(panning_f);
+        audio_core_slot_configure(slot_, vol_f, speed_f, panning_f);
         paramsChanged = false;
     }
 
-    PlaybackState core_state = player->GetPlayState();
-    float posms_f = player->GetPositionMs();
+    PlaybackState core_state = status_->GetPlayState();
+    float posms_f = status_->GetPositionMs();
     posMs = static_cast<int>(posms_f);
     pos = posms_to_pos(posMs);
     if (state == core_state || IsPlaybackDone(core_state))
@@ -159,8 +155,9 @@ bool SOUNDCLIP::update()
     switch (state)
     {
     case PlaybackState::PlayStatePlaying:
-        player->Play();
-        state = player->GetPlayState();
+        // The playback will start asynchronously; keep the requested state,
+        // until the audio core reports the change
+        audio_core_slot_play(slot_);
         break;
     default: /* do nothing */
         break;
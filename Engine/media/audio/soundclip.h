@@ -36,9 +36,12 @@
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__SOUNDCLIP_H__
 #define __AGS_EE_MEDIA__SOUNDCLIP_H__
+#include <memory>
 #include "ac/dynobj/scriptaudioclip.h"
 #include "media/audio/audiodefines.h"
 
+struct AudioPlayerStatus;
+
 class SOUNDCLIP final
 {
 public:
@@ -182,6 +185,8 @@ private:
 
     // audio core slot handle
     const int slot_;
+    // player's state, published by the audio core
+    std::shared_ptr<const AudioPlayerStatus> status_;
     // Frequency, needed for position handling
     int freq;
     // current playback state
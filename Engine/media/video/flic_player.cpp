@@ -25,6 +25,7 @@ using namespace Common;
 
 FlicPlayer::~FlicPlayer()
 {
+    StopBuffering();
     CloseImpl();
 }
 
@@ -39,6 +39,9 @@ private:
     void CloseImpl() override;
     // Retrieves next video frame, implementation-specific
     bool NextVideoFrame(Common::Bitmap *dst) override;
+    // Allegro's FLI player keeps a global state, and updates the palette
+    // with each frame, so FLIC is decoded on the game thread
+    bool CanDecodeOnThread() const override { return false; }
 
     PACKFILE *_pf = nullptr;
     RGB _oldpal[256]{};
@@ -15,6 +15,9 @@
 
 #ifndef AGS_NO_VIDEO_PLAYER
 
+#include <mutex>
+#include "gfx/bitmapdata.h"
+
 namespace AGS
 {
 namespace Engine
@@ -24,9 +27,15 @@ using namespace Common;
 
 TheoraPlayer::~TheoraPlayer()
 {
+    StopBuffering();
     CloseImpl();
 }
 
+// APEG keeps the stream settings in global variables, which are applied
+// when the stream is opened or reset; guard these from concurrent use,
+// as the streams may be reset by the video buffering threads.
+static std::mutex apeg_settings_mutex;
+
 //
 // Theora stream reader callbacks. We need these because APEG library does not
 // provide means to supply user's PACKFILE directly.
@@ -51,6 +60,44 @@ void apeg_stream_skip(int bytes, void *ptr)
 }
 //
 
+//
+// Theora display callbacks. These convert decoded YUV frames into 32-bit
+// bitmap directly, which is faster than APEG's own generic conversion.
+//
+// Init display: create the frame bitmap, return 0 on success, -1 on error,
+// or 1 to let APEG use its own conversion.
+int apeg_display_init_argb(APEG_STREAM *stream, int coded_w, int coded_h, void * /*ptr*/)
+{
+    if (stream->pixel_format != APEG_STREAM::APEG_420)
+        return 1;
+    if (stream->bitmap)
+        destroy_bitmap(stream->bitmap);
+    stream->bitmap = create_bitmap_ex(32, coded_w, coded_h);
+    if (!stream->bitmap)
+    {
+        snprintf(stream->apeg_error, sizeof(stream->apeg_error), "Couldn't create internal bitmap");
+        return -1;
+    }
+    clear_to_color(stream->bitmap, makecol_depth(32, 0, 0, 0));
+    stream->frame_updated = -1;
+    set_clip_rect(stream->bitmap, 0, 0, stream->w - 1, stream->h - 1);
+    return 0;
+}
+// Display frame: convert YUV 4:2:0 planes into the frame bitmap;
+// planes are sized after the coded frame, and chroma planes are half as wide.
+void apeg_display_argb(APEG_STREAM *stream, unsigned char **src, void * /*ptr*/)
+{
+    BITMAP *bmp = stream->bitmap;
+    const int chroma_w = bmp->w / 2;
+    for (int y = 0; y < stream->h; ++y)
+    {
+        PixelOp::ConvertYUVRowToARGB(reinterpret_cast<uint32_t*>(bmp->line[y]),
+            src[0] + y * bmp->w, src[1] + (y / 2) * chroma_w, src[2] + (y / 2) * chroma_w,
+            stream->w);
+    }
+}
+//
+
 HError TheoraPlayer::OpenImpl(std::unique_ptr<Stream> data_stream,
     const String &name, int &flags, int target_depth)
 {
@@ -77,14 +124,10 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
 
     // NOTE: following settings affect only next apeg_open_stream* or
     // apeg_reset_stream.
-    apeg_set_stream_reader(apeg_stream_init, apeg_stream_read, apeg_stream_skip);
-    apeg_set_display_depth(target_depth);
-    // we must disable length detection, otherwise it takes ages to start
-    // playing if the file is large because it seeks through the whole thing
-    apeg_disable_length_detection(TRUE);
-    apeg_ignore_audio((flags & kVideo_EnableAudio) == 0);
-
+    std::unique_lock<std::mutex> lk(apeg_settings_mutex);
+    ApplyAPEGSettings(flags, target_depth);
     APEG_STREAM* apeg_stream = apeg_open_stream_ex(data_stream);
+    lk.unlock();
     if (!apeg_stream)
     {
         return new Error(String::FromFormat("Failed to open theora video '%s'; could be an invalid or unsupported format", name.GetCStr()));
@@ -128,6 +171,21 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     return HError::None();
 }
 
+void TheoraPlayer::ApplyAPEGSettings(int flags, int target_depth)
+{
+    apeg_set_stream_reader(apeg_stream_init, apeg_stream_read, apeg_stream_skip);
+    apeg_set_display_depth(target_depth);
+    // Use our own optimized conversion for 32-bit frames
+    if (target_depth == 32)
+        apeg_set_display_callbacks(apeg_display_init_argb, apeg_display_argb, nullptr);
+    else
+        apeg_set_display_callbacks(nullptr, nullptr, nullptr);
+    // we must disable length detection, otherwise it takes ages to start
+    // playing if the file is large because it seeks through the whole thing
+    apeg_disable_length_detection(TRUE);
+    apeg_ignore_audio((flags & kVideo_EnableAudio) == 0);
+}
+
 void TheoraPlayer::CloseImpl()
 {
     apeg_close_stream(_apegStream);
@@ -136,7 +194,13 @@ void TheoraPlayer::CloseImpl()
 
 bool TheoraPlayer::RewindImpl()
 {
-    if (apeg_reset_stream(_apegStream) != APEG_OK)
+    int ret;
+    {
+        std::lock_guard<std::mutex> lk(apeg_settings_mutex);
+        ApplyAPEGSettings(_usedFlags, _usedDepth);
+        ret = apeg_reset_stream(_apegStream);
+    }
+    if (ret != APEG_OK)
     {
         OpenAPEGStream(_dataStream.get(), GetName(), _usedFlags, _usedDepth);
     }
@@ -172,6 +236,27 @@ bool TheoraPlayer::NextVideoFrame(Bitmap *dst)
     return true;
 }
 
+bool TheoraPlayer::SkipVideoFrame()
+{
+    assert(_apegStream);
+    if ((_apegStream->flags & APEG_HAS_VIDEO) == 0)
+        return false;
+
+    // reset some data
+    _apegStream->frame_updated = -1;
+
+    // Read video frame (encoded)
+    int ret = apeg_get_video_frame(_apegStream);
+    if (ret == APEG_ERROR)
+        return false;
+
+    // Update frame count
+    ++(_apegStream->frame);
+
+    // Drop the decoded frame without converting it to RGB
+    return apeg_skip_video_frame(_apegStream) == APEG_OK;
+}
+
 SoundBuffer TheoraPlayer::NextAudioFrame()
 {
     assert(_apegStream);
@@ -46,10 +46,14 @@ private:
     bool RewindImpl() override;
     // Retrieves next video frame, implementation-specific
     bool NextVideoFrame(Common::Bitmap *dst) override;
+    // Skips next video frame without converting it to RGB
+    bool SkipVideoFrame() override;
     // Retrieves next audio frame, implementation-specific
     SoundBuffer NextAudioFrame() override;
 
     Common::HError OpenAPEGStream(Stream *data_stream, const String &name, int flags, int target_depth);
+    // Assigns APEG global settings, which are used when opening or resetting a stream
+    static void ApplyAPEGSettings(int flags, int target_depth);
 
     std::unique_ptr<Stream> _dataStream;
     int _usedFlags = 0;
@@ -16,8 +16,6 @@
 //
 // TODO:
 //     - multiple working threads.
-//     - separate thread(s) for buffering, so that it continues even while
-//       the videoplayer is being synchronized with the game logic.
 //
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__VIDEOCORE_H
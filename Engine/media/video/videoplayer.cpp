@@ -65,11 +65,15 @@ HError VideoPlayer::Open(std::unique_ptr<Common::Stream> data_stream,
     // TODO: actually support dynamic FPS, need to adjust audio speed
     _targetFrameTime = 1000.f / _targetFPS;
     _resetStartTime = true;
+    // NOTE: buffering is started on the first Play or NextFrame call,
+    // so that the caller could set up the target frame first
     return HError::None();
 }
 
 void VideoPlayer::SetTargetFrame(const Size &target_sz)
 {
+    std::lock_guard<std::mutex> dlk(_decodeMutex);
+    std::lock_guard<std::mutex> qlk(_queueMutex);
     _targetSize = target_sz.IsNull() ? _frameSize : target_sz;
 
     // Create helper bitmaps in case of stretching or color depth conversion
@@ -94,12 +98,16 @@ void VideoPlayer::SetTargetFrame(const Size &target_sz)
         _hicolBuf.reset();
     }
 
-    // TODO: resize the buffered queue?
-
+    // Drop the frames made for the previous target, and any pooled bitmaps
+    _videoFrameQueue.clear();
+    _videoFramePool = std::stack<std::unique_ptr<Bitmap>>();
+    _bufferCV.notify_all();
 }
 
 void VideoPlayer::Stop()
 {
+    StopBuffering();
+
     if (IsPlaybackReady(_playState)) // keep any error state
         _playState = PlayStateStopped;
 
@@ -111,7 +119,9 @@ void VideoPlayer::Stop()
     _vframeBuf = nullptr;
     _hicolBuf = nullptr;
     _videoFramePool = std::stack<std::unique_ptr<Bitmap>>();
-    _videoFrameQueue = std::deque<std::unique_ptr<Bitmap>>();
+    _videoFrameQueue = std::deque<VideoFrame>();
+    _audioQueue = std::deque<std::vector<uint8_t>>();
+    _audioFrame.clear();
 }
 
 void VideoPlayer::Play()
@@ -125,6 +135,7 @@ void VideoPlayer::Play()
         ResumeImpl();
         /* fallthrough */
     case PlayStateInitial:
+        StartBuffering();
         if (_audioOut)
             _audioOut->Play();
         _playState = PlayStatePlaying;
@@ -143,6 +154,7 @@ void VideoPlayer::Pause()
         _audioOut->Pause();
     _playState = PlayStatePaused;
     _pauseTs = AGS_Clock::now();
+    _skipToFrame = 0u; // don't let decoder skip frames while paused
 }
 
 float VideoPlayer::Seek(float pos_ms)
@@ -170,16 +182,15 @@ std::unique_ptr<Bitmap> VideoPlayer::NextFrame()
     if (_playState != PlaybackState::PlayStatePaused)
         Pause();
 
-    BufferVideo();
-
-    auto frame = NextFrameFromQueue();
+    StartBuffering();
+    auto frame = NextFrameFromQueue(true);
     if (!frame)
     {
         // TODO: rewind should be done on reading from decoder, not when playing!
         // see how AudioPlayer does this
         if (IsLooping() && Rewind())
         {
-            frame = NextFrameFromQueue();
+            frame = NextFrameFromQueue(true);
         }
         else
         {
@@ -248,6 +259,7 @@ std::unique_ptr<Bitmap> VideoPlayer::GetEmptyFrame()
 
 void VideoPlayer::ReleaseFrame(std::unique_ptr<Common::Bitmap> frame)
 {
+    std::lock_guard<std::mutex> lk(_queueMutex);
     _videoFramePool.push(std::move(frame));
 }
 
@@ -256,11 +268,10 @@ bool VideoPlayer::Poll()
     if (!IsPlaybackReady(_playState))
         return false;
 
-    // Buffer always when ready, even if we are paused
-    if (HasVideo())
-        BufferVideo();
-    if (HasAudio())
-        BufferAudio();
+    // If there's no buffering thread, then buffer always when ready,
+    // even if we are paused
+    if (!_bufferRunning)
+        BufferFrames();
 
     if (_playState != PlayStatePlaying)
         return false;
@@ -297,9 +308,25 @@ bool VideoPlayer::Poll()
 
 bool VideoPlayer::Rewind()
 {
+    std::lock_guard<std::mutex> dlk(_decodeMutex);
     if (!RewindImpl())
         return false;
 
+    // Drop everything that was decoded ahead, and restart buffering
+    {
+        std::lock_guard<std::mutex> qlk(_queueMutex);
+        for (auto &frame : _videoFrameQueue)
+            _videoFramePool.push(std::move(frame.Bmp));
+        _videoFrameQueue.clear();
+        _audioQueue.clear();
+        _videoEOF = false;
+        _audioEOF = false;
+        _framesDecoded = 0u;
+        _skipToFrame = 0u;
+    }
+    _audioFrame.clear();
+    _bufferCV.notify_all();
+
     // TODO: this cannot be done on Rewind itself if we rewind not after
     // everything is played, but after everything is buffered!
     // See how this is implemented in the AudioPlayer!
@@ -323,10 +350,72 @@ void VideoPlayer::ResumeImpl()
     // must Seek to frame, or audio will fall behind
 }
 
-void VideoPlayer::BufferVideo()
+void VideoPlayer::StartBuffering()
 {
-    if (_videoFrameQueue.size() >= _videoQueueMax)
+#if !defined(AGS_DISABLE_THREADS)
+    if (_bufferRunning || !CanDecodeOnThread())
         return;
+    _bufferRunning = true;
+    _bufferThread = std::thread(&VideoPlayer::BufferingEntry, this);
+#endif
+}
+
+void VideoPlayer::StopBuffering()
+{
+    {
+        std::lock_guard<std::mutex> lk(_queueMutex);
+        _bufferRunning = false;
+    }
+    _bufferCV.notify_all();
+    if (_bufferThread.joinable())
+        _bufferThread.join();
+}
+
+void VideoPlayer::BufferingEntry()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lk(_queueMutex);
+            _bufferCV.wait(lk, [this]() { return !_bufferRunning || CanBuffer(); });
+            if (!_bufferRunning)
+                break;
+        }
+        BufferFrames();
+    }
+}
+
+bool VideoPlayer::CanBuffer() const
+{
+    return (HasVideo() && !_videoEOF && (_videoFrameQueue.size() < _videoQueueMax)) ||
+        (HasAudio() && !_audioEOF && (_audioQueue.size() < _audioQueueMax));
+}
+
+void VideoPlayer::BufferFrames()
+{
+    std::lock_guard<std::mutex> dlk(_decodeMutex);
+    bool want_video, want_audio;
+    {
+        std::lock_guard<std::mutex> qlk(_queueMutex);
+        want_video = HasVideo() && !_videoEOF && (_videoFrameQueue.size() < _videoQueueMax);
+        want_audio = HasAudio() && !_audioEOF && (_audioQueue.size() < _audioQueueMax);
+    }
+    if (want_video)
+        BufferVideo();
+    if (want_audio)
+        BufferAudio();
+}
+
+void VideoPlayer::BufferVideo()
+{
+    // Optionally skip the frames which are already late,
+    // converting them into bitmaps would be a waste of time
+    if ((_flags & kVideo_DropFrames) != 0)
+    {
+        const uint32_t skip_to = _skipToFrame;
+        while ((_framesDecoded < skip_to) && SkipVideoFrame())
+            _framesDecoded++;
+    }
 
     // Get one frame from the pool, if present, otherwise allocate a new one
     std::unique_ptr<Bitmap> target_frame = GetPooledFrame();
@@ -337,7 +426,12 @@ void VideoPlayer::BufferVideo()
     Bitmap *usebuf = must_conv ? _vframeBuf.get() : target_frame.get();
     if (!NextVideoFrame(usebuf))
     { // failed to get frame, so move prepared target frame into the pool for now
-        _videoFramePool.push(std::move(target_frame));
+        {
+            std::lock_guard<std::mutex> lk(_queueMutex);
+            _videoFramePool.push(std::move(target_frame));
+            _videoEOF = true;
+        }
+        _frameReadyCV.notify_all();
         return;
     }
 
@@ -358,15 +452,30 @@ void VideoPlayer::BufferVideo()
     }
 
     // Push final frame to the queue
-    _videoFrameQueue.push_back(std::move(target_frame));
+    {
+        std::lock_guard<std::mutex> lk(_queueMutex);
+        VideoFrame frame;
+        frame.Bmp = std::move(target_frame);
+        frame.Index = _framesDecoded++;
+        _videoFrameQueue.push_back(std::move(frame));
+    }
+    _frameReadyCV.notify_all();
 }
 
 void VideoPlayer::BufferAudio()
 {
-    if (_audioFrame)
-        return; // still got one queued
-
-    _audioFrame = NextAudioFrame();
+    // Copy the decoded data, as the decoder will reuse its buffer
+    SoundBuffer buf = NextAudioFrame();
+    std::lock_guard<std::mutex> lk(_queueMutex);
+    if (buf)
+    {
+        const uint8_t *data = static_cast<const uint8_t*>(buf.Data);
+        _audioQueue.emplace_back(data, data + buf.Size);
+    }
+    else
+    {
+        _audioEOF = true;
+    }
 }
 
 void VideoPlayer::UpdateTime()
@@ -381,6 +490,13 @@ void VideoPlayer::UpdateTime()
     _playbackDuration = _pollTs - _startTs;
     _wantFrameIndex = std::chrono::duration_cast<std::chrono::milliseconds>(_playbackDuration).count()
         / _targetFrameTime;
+    // If there's audio, and it is still playing, then use its position as a clock;
+    // video frames will be held or dropped to keep in sync with audio.
+    if (HasAudio() && _audioOut && (!_audioOut->IsEmpty() || !_audioFrame.empty()))
+    {
+        _wantFrameIndex = static_cast<uint32_t>(_audioOut->GetPositionMs() / _frameTime);
+    }
+    _skipToFrame = _wantFrameIndex;
     /*Debug::Printf("VIDEO TIME: playdur %lld, target frame time %.2f, want frame = %u, played frame = %u",
         std::chrono::duration_cast<std::chrono::milliseconds>(_playbackDuration).count(),
         _targetFrameTime,
@@ -390,58 +506,86 @@ void VideoPlayer::UpdateTime()
 
 std::unique_ptr<Bitmap> VideoPlayer::GetPooledFrame()
 {
-    if (_videoFramePool.empty())
     {
-        return std::make_unique<Bitmap>(_targetSize.Width, _targetSize.Height, _targetDepth);
-    }
-    else
-    {
-        auto frame = std::move(_videoFramePool.top());
-        _videoFramePool.pop();
-        return frame;
+        std::lock_guard<std::mutex> lk(_queueMutex);
+        if (!_videoFramePool.empty())
+        {
+            auto frame = std::move(_videoFramePool.top());
+            _videoFramePool.pop();
+            return frame;
+        }
     }
+    return std::make_unique<Bitmap>(_targetSize.Width, _targetSize.Height, _targetDepth);
 }
 
-std::unique_ptr<Bitmap> VideoPlayer::NextFrameFromQueue()
+std::unique_ptr<Bitmap> VideoPlayer::NextFrameFromQueue(bool wait)
 {
-    if (_videoFrameQueue.empty())
-        return nullptr;
-    auto frame = std::move(_videoFrameQueue.front());
-    _videoFrameQueue.pop_front();
-    _framesPlayed++;
-    return frame;
+    if (wait && !_bufferRunning && _videoFrameQueue.empty())
+        BufferFrames();
+    VideoFrame frame;
+    {
+        std::unique_lock<std::mutex> lk(_queueMutex);
+        if (wait && _bufferRunning)
+            _frameReadyCV.wait(lk, [this]() { return !_videoFrameQueue.empty() || _videoEOF; });
+        if (_videoFrameQueue.empty())
+            return nullptr;
+        frame = std::move(_videoFrameQueue.front());
+        _videoFrameQueue.pop_front();
+    }
+    _bufferCV.notify_all();
+    // Frame index may skip ahead, if decoder dropped some frames
+    _framesPlayed = frame.Index + 1;
+    return std::move(frame.Bmp);
 }
 
 bool VideoPlayer::ProcessVideo()
 {
     // Optionally drop late frames, but leave at least 1 for display
+    std::unique_lock<std::mutex> lk(_queueMutex);
     if ((_flags & kVideo_DropFrames) != 0)
     {
+        bool dropped = false;
         while ((_videoFrameQueue.size() > 1) &&
-            (_framesPlayed /*+ 1*/ < _wantFrameIndex))
+            (_videoFrameQueue.front().Index /*+ 1*/ < _wantFrameIndex))
         {
-            auto frame = NextFrameFromQueue();
-            assert(frame);
-            _videoFramePool.push(std::move(frame));
+            auto &frame = _videoFrameQueue.front();
+            _framesPlayed = frame.Index + 1;
+            _videoFramePool.push(std::move(frame.Bmp));
+            _videoFrameQueue.pop_front();
+            dropped = true;
             //Debug::Printf("DROPPED LATE FRAME, queue size: %d", _videoFrameQueue.size());
         }
+        if (dropped)
+            _bufferCV.notify_all();
     }
-    // We are good so long as there's a ready frame in queue
-    return !_videoFrameQueue.empty();
+    // We are good so long as there's a ready frame in queue, or more to decode
+    return !_videoFrameQueue.empty() || !_videoEOF;
 }
 
 bool VideoPlayer::ProcessAudio()
 {
-    if (!_audioFrame)
+    if (!_audioOut)
         return false;
 
-    assert(_audioOut);
-    if (_audioOut->PutData(_audioFrame) > 0u)
+    bool more_data;
+    {
+        std::lock_guard<std::mutex> lk(_queueMutex);
+        if (_audioFrame.empty() && !_audioQueue.empty())
+        {
+            _audioFrame = std::move(_audioQueue.front());
+            _audioQueue.pop_front();
+            _bufferCV.notify_all();
+        }
+        more_data = !_audioQueue.empty() || !_audioEOF;
+    }
+
+    if (!_audioFrame.empty() &&
+        (_audioOut->PutData(SoundBuffer(_audioFrame.data(), _audioFrame.size())) > 0u))
     {
-        _audioFrame = SoundBuffer(); // clear received buffer
+        _audioFrame.clear(); // clear received buffer
     }
     _audioOut->Poll();
-    return true;
+    return !_audioFrame.empty() || more_data;
 }
 
 } // namespace Engine
@@ -17,13 +17,17 @@
 // where active bitmap is switched each next time.
 // Renders audio frames using OpenAlSource output.
 //
+// Video and audio frames are decoded ahead on a separate buffering thread
+// (unless threads are disabled), which fills the bounded frame queues;
+// the ready frames are retrieved from these queues by the engine.
+// If there's audio, then the audio playback position is used as a clock
+// for the video frames, because audio is more time-sensitive in human
+// perception. With kVideo_DropFrames flag the late video frames are dropped,
+// and decoder is allowed to skip the frames which are already late without
+// converting them to a bitmap.
+//
 // TODO: separate Video Decoder class, would be useful e.g. for plugins.
 // TODO:
-//     - allow skip frames if late (add to settings);
-//     - a video-audio sync mechanism; perhaps rely on audio,
-//       because it's more time-sensitive in human perception;
-//       drop video frames if video is lagging. But this also may have to
-//       be done in decoder to avoid converting vframe to a bitmap (yuv->rgb).
 //     - other options: slow down playback speed until video-audio
 //       relation stabilizes.
 //
@@ -36,17 +40,19 @@
 //       that would require modifying the video decoding lib (or using other).
 //       but then there also has to be a reverse conversion made in case
 //       someone would like to use the frame for raw drawing.
-//     - expose buffering in video player's interface, and guard buffer queues
-//       with mutexes. This would allow to keep buffering constantly even
-//       during next ready frame retrieval by the engine.
 //
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__VIDEOPLAYER_H
 #define __AGS_EE_MEDIA__VIDEOPLAYER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <stack>
+#include <thread>
+#include <vector>
 #include "ac/timer.h"
 #include "gfx/bitmap.h"
 #include "media/audio/audiodefines.h"
@@ -150,10 +156,17 @@ protected:
     virtual bool RewindImpl() { return false; }
     // Retrieves next video frame, implementation-specific
     virtual bool NextVideoFrame(Common::Bitmap *dst) { return false; };
+    // Skips next video frame without converting it into a bitmap;
+    // returns false if frame could not be skipped, in which case it should
+    // be retrieved normally.
+    virtual bool SkipVideoFrame() { return false; }
     // Retrieves next audio frame, implementation-specific
     // TODO: change return type to a proper allocated buffer
     // when we support a proper audio queue here.
     virtual SoundBuffer NextAudioFrame() { return SoundBuffer(); };
+    // Tells if the frames may be decoded on a separate buffering thread;
+    // otherwise they are decoded on the thread which polls the player
+    virtual bool CanDecodeOnThread() const { return true; }
 
     // Audio internals
     int _audioChannels = 0;
@@ -169,22 +182,43 @@ protected:
     uint32_t _frameCount = 0;
     float _durationMs = 0.f;
 
+    // Stops the buffering thread; must be called by the derived classes
+    // in their destructors, before the decoder is closed
+    void StopBuffering();
+
 private:
+    // Decoded video frame, along with its index in the video
+    struct VideoFrame
+    {
+        std::unique_ptr<Common::Bitmap> Bmp;
+        uint32_t Index = 0u;
+    };
+
     // Rewind the stream to start and reset playback pos
     bool Rewind();
     // Resume after pause
     void ResumeImpl();
-    // Read and queue video frames
+    // Starts a buffering thread, if threads are enabled,
+    // and the decoder supports that
+    void StartBuffering();
+    // Buffering thread's entry point
+    void BufferingEntry();
+    // Tells if there's space for more frames in the queues;
+    // must be called with the queue lock
+    bool CanBuffer() const;
+    // Decodes the next video and audio frames, if there's space in their queues
+    void BufferFrames();
+    // Read and queue video frames; must be called with the decoder lock
     void BufferVideo();
-    // Read and queue audio frames
+    // Read and queue audio frames; must be called with the decoder lock
     void BufferAudio();
     // Update playback timing
     void UpdateTime();
     // Retrieve a frame from the pool, or create a new one
     std::unique_ptr<Common::Bitmap> GetPooledFrame();
-    // Retrieve first available frame from queue,
-    // advance output frame counter
-    std::unique_ptr<Common::Bitmap> NextFrameFromQueue();
+    // Retrieve first available frame from queue, advance output frame counter;
+    // optionally waits until the frame is decoded, or the video is over
+    std::unique_ptr<Common::Bitmap> NextFrameFromQueue(bool wait = false);
     // Process buffered video frame(s);
     // returns if should continue working
     bool ProcessVideo();
@@ -201,7 +235,7 @@ private:
     float _targetFPS = 0.f;
     float _targetFrameTime = 0.f; // frame duration in ms for "target fps"
     uint32_t _videoQueueMax = 5u;
-    uint32_t _audioQueueMax = 0u; // we don't have a real queue atm
+    uint32_t _audioQueueMax = 8u;
     // Playback state
     PlaybackState _playState = PlayStateInitial;
     // Playback position, depends on how much data did we played
@@ -217,9 +251,26 @@ private:
     AGS_Clock::duration _playbackDuration; // full playback time
     AGS_Clock::time_point _pauseTs; // time when the playback was paused
     uint32_t _wantFrameIndex = 0u; // expected video frame at this time
+    // Frame index before which the decoder may skip late frames
+    std::atomic<uint32_t> _skipToFrame{0u};
+    // Buffering thread, and the synchronization objects:
+    // decoder mutex guards the decoder and the helper buffers,
+    // queue mutex guards the frame queues, pool and the decoding state.
+    // When both are locked, the decoder mutex must be locked first.
+    std::thread _bufferThread;
+    bool _bufferRunning = false;
+    std::mutex _decodeMutex;
+    std::mutex _queueMutex;
+    std::condition_variable _bufferCV; // wakes the buffering thread
+    std::condition_variable _frameReadyCV; // notifies about new decoded frame
+    bool _videoEOF = false;
+    bool _audioEOF = false;
+    uint32_t _framesDecoded = 0u; // index of the next video frame to decode
     // Audio
-    // Audio queue (single frame for now, because output buffers too)
-    SoundBuffer _audioFrame{};
+    // Decoded audio frames, copied from the decoder's buffer
+    std::deque<std::vector<uint8_t>> _audioQueue;
+    // Audio frame which is being passed to the output
+    std::vector<uint8_t> _audioFrame;
     // Audio output object
     std::unique_ptr<OpenAlSource> _audioOut;
     // Video
@@ -230,7 +281,7 @@ private:
     std::unique_ptr<Common::Bitmap> _hicolBuf;
     // Buffered frame queue
     std::stack<std::unique_ptr<Common::Bitmap>> _videoFramePool;
-    std::deque<std::unique_ptr<Common::Bitmap>> _videoFrameQueue;
+    std::deque<VideoFrame> _videoFrameQueue;
 };
 
 } // namespace Engine
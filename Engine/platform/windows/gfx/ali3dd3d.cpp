@@ -1304,6 +1304,7 @@ void D3DGraphicsDriver::RenderAndPresent(bool clearDrawListAfterwards)
 {
     RenderImpl(clearDrawListAfterwards);
     direct3ddevice->Present(NULL, NULL, NULL, NULL);
+    ResetTextureUploadStats();
 }
 
 void D3DGraphicsDriver::RenderImpl(bool clearDrawListAfterwards)
@@ -1734,7 +1735,9 @@ void D3DGraphicsDriver::UpdateTextureRegion(D3DTextureTile *tile, const Bitmap *
   auto &texture = tile->texture;
 
   D3DLOCKED_RECT lockedRegion;
+  auto t_start = AGS_Clock::now();
   HRESULT hr = texture->LockRect(0, &lockedRegion, NULL, D3DLOCK_NOSYSLOCK | D3DLOCK_DISCARD);
+  auto lock_dur = AGS_Clock::now() - t_start;
   if (hr != D3D_OK)
   {
     throw Ali3DException("Unable to lock texture");
@@ -1748,7 +1751,12 @@ void D3DGraphicsDriver::UpdateTextureRegion(D3DTextureTile *tile, const Bitmap *
   else
     BitmapToVideoMem(bitmap, tile, memPtr, lockedRegion.Pitch, usingLinearFiltering);
 
+  t_start = AGS_Clock::now();
   texture->UnlockRect(0);
+  _uploadStats.StallUs += std::chrono::duration_cast<std::chrono::microseconds>(
+      lock_dur + (AGS_Clock::now() - t_start)).count();
+  _uploadStats.Count++;
+  _uploadStats.Bytes += lockedRegion.Pitch * tile->height;
 }
 
 void D3DGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap *ddb, const Bitmap *bitmap)
@@ -232,6 +232,13 @@ void ccInstance::FreeInstanceStack()
     InstThreads.clear();
 }
 
+int ccInstance::GetInstructionArgCount(int32_t code)
+{
+    if (code < 0 || code >= CC_NUM_SCCMDS)
+        return -1;
+    return sccmd_info[code].ArgCount;
+}
+
 ccInstance *ccInstance::CreateFromScript(PScript scri)
 {
     return CreateEx(scri, nullptr);
@@ -170,6 +170,9 @@ public:
     static ccInstance *CreateFromScript(PScript script);
     static ccInstance *CreateEx(PScript scri, const ccInstance * joined);
     static void SetExecTimeout(unsigned sys_poll_ms, unsigned abort_ms, unsigned abort_loops);
+    // returns number of arguments of the given bytecode instruction,
+    // or -1 if this is not a valid instruction
+    static int GetInstructionArgCount(int32_t code);
     static const JointRTTI *GetRTTI() { return _rtti.get(); }
     static const Engine::RTTIHelper *GetRTTIHelper() { return _rttiHelper.get(); }
     // Joins custom provided RTTI into the global collection;
@@ -87,6 +87,20 @@ void RTTIHelper::Generate(const RTTI &rtti)
         ref.field_num = _managedOffsets.size() - man_findex;
         _managedFieldsRef.push_back(ref);
     }
+
+    // Update runtime types in place, because existing objects may have pointers to these;
+    // this is necessary as "generated" types may be replaced when joining RTTI.
+    if (_runtimeTypes.size() < types.size())
+        _runtimeTypes.resize(types.size());
+    for (uint32_t type_id = 0; type_id < types.size(); ++type_id)
+    {
+        const auto &fref = _managedFieldsRef[type_id];
+        auto &rt = _runtimeTypes[type_id];
+        rt.this_id = type_id;
+        rt.managed_offsets.assign(_managedOffsets.begin() + fref.field_index,
+            _managedOffsets.begin() + fref.field_index + fref.field_num);
+        rt.has_refs = !rt.managed_offsets.empty();
+    }
 }
 
 std::pair<std::vector<uint32_t>::const_iterator, std::vector<uint32_t>::const_iterator>
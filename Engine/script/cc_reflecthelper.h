@@ -22,6 +22,7 @@
 #ifndef __AGS_EE_SCRIPT__REFLECTHELPER_H
 #define __AGS_EE_SCRIPT__REFLECTHELPER_H
 
+#include <deque>
 #include "script/cc_reflect.h"
 
 namespace AGS
@@ -29,6 +30,19 @@ namespace AGS
 namespace Engine
 {
 
+// RuntimeType is a script type's descriptor, containing data generated from
+// RTTI, prepared for the quick use at runtime.
+// Joint RTTI never removes types, so once created a RuntimeType is never
+// deleted or moved in memory, and may be referenced by a pointer.
+struct RuntimeType
+{
+    uint32_t this_id = 0u;
+    // tells whether this type contains any managed pointers
+    bool has_refs = false;
+    // offsets of all the managed pointers, including ones in the nested structs
+    std::vector<uint32_t> managed_offsets;
+};
+
 class RTTIHelper
 {
 public:
@@ -48,11 +62,19 @@ public:
     // containing a list of managed fields offsets for the given type
     std::pair<std::vector<uint32_t>::const_iterator, std::vector<uint32_t>::const_iterator>
         GetManagedOffsetsForType(uint32_t type_id) const;
+    // Returns a runtime type descriptor, or null if there's no such type
+    const RuntimeType *GetRuntimeType(uint32_t type_id) const
+    {
+        return type_id < _runtimeTypes.size() ? &_runtimeTypes[type_id] : nullptr;
+    }
 
 private:
     // Quick-reference for the managed pointer fields in types
     std::vector<TypeFieldsRef> _managedFieldsRef;
     std::vector<uint32_t> _managedOffsets; // includes nested regular structs!
+    // Runtime type descriptors, indexed by type id;
+    // deque is used to keep the elements in place when new types are added
+    std::deque<RuntimeType> _runtimeTypes;
 };
 
 }
@@ -35,6 +35,7 @@
 #include "ac/mouse.h"
 #include "ac/room.h"
 #include "ac/roomobject.h"
+#include "ac/translation.h"
 #include "script/cc_common.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
@@ -254,6 +255,10 @@ int create_global_script() {
 
     ccSetOption(SCOPT_AUTOIMPORT, 0);
 
+    // Let translation cache lookups of the script's string literals
+    for (const auto &inst : all_insts)
+        translation_register_static_text(inst->strings, inst->stringssize);
+
     // Optionally dump script's TOC into the log
     if (logScriptTOC)
     {
@@ -518,6 +523,14 @@ void FreeAllScriptInstances()
     ccInstance::FreeInstanceStack();
     FreeRoomScriptInstance();
 
+    for (const auto &inst : moduleInst)
+        if (inst)
+            translation_unregister_static_text(inst->strings);
+    if (gameinst)
+        translation_unregister_static_text(gameinst->strings);
+    if (dialogScriptsInst)
+        translation_unregister_static_text(dialogScriptsInst->strings);
+
     // NOTE: don't know why, but Forks must be deleted prior to primary inst,
     // or bad things will happen; TODO: investigate and make this less fragile
     gameinstFork.reset();
@@ -529,6 +542,8 @@ void FreeAllScriptInstances()
 
 void FreeRoomScriptInstance()
 {
+    if (roominst)
+        translation_unregister_static_text(roominst->strings);
     // NOTE: don't know why, but Forks must be deleted prior to primary inst,
     // or bad things will happen; TODO: investigate and make this less fragile
     roominstFork.reset();
@@ -0,0 +1,115 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2024 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/route_finder_jps.inl"
+
+using namespace AGS::Engine;
+
+// Generates a random walkable map: a mostly walkable field with
+// random rectangular walls and some single blocked cells
+static std::vector<unsigned char> MakeRandomMap(std::mt19937 &rng, int width, int height)
+{
+    std::vector<unsigned char> map(width * height, 1);
+    std::uniform_int_distribution<int> rand_x(0, width - 1);
+    std::uniform_int_distribution<int> rand_y(0, height - 1);
+    std::uniform_int_distribution<int> rand_len(1, std::max(width, height) / 3);
+    const int walls = (width + height) / 8;
+    for (int i = 0; i < walls; ++i)
+    {
+        const int x0 = rand_x(rng), y0 = rand_y(rng);
+        const bool horz = (rng() & 1) != 0;
+        const int w = horz ? rand_len(rng) : 1 + (rng() % 3);
+        const int h = horz ? 1 + (rng() % 3) : rand_len(rng);
+        for (int y = y0; y < std::min(y0 + h, height); ++y)
+            for (int x = x0; x < std::min(x0 + w, width); ++x)
+                map[y * width + x] = 0;
+    }
+    const int cells = width * height / 50;
+    for (int i = 0; i < cells; ++i)
+        map[rand_y(rng) * width + rand_x(rng)] = 0;
+    return map;
+}
+
+static void AssignMap(Navigation &nav, const std::vector<unsigned char> &map, int width, int height)
+{
+    nav.Resize(width, height);
+    for (int y = 0; y < height; ++y)
+        nav.SetMapRow(y, &map[y * width]);
+}
+
+// Tests that jump points found by scanning grid words give exactly
+// same routes as the reference cell by cell scanning
+TEST(RouteFinder, JPSScanByWordsMatchesByCell) {
+    std::mt19937 rng(12345);
+    // include sizes which are not multiple of the grid word,
+    // and the ones smaller than a word
+    const int sizes[][2] = { { 40, 30 }, { 64, 64 }, { 130, 70 }, { 200, 150 }, { 321, 199 } };
+    for (const auto &size : sizes)
+    {
+        const int width = size[0], height = size[1];
+        std::uniform_int_distribution<int> rand_x(0, width - 1);
+        std::uniform_int_distribution<int> rand_y(0, height - 1);
+        for (int map_i = 0; map_i < 4; ++map_i)
+        {
+            const auto map = MakeRandomMap(rng, width, height);
+            Navigation nav_words, nav_cells;
+            nav_cells.SetScanByCell(true);
+            AssignMap(nav_words, map, width, height);
+            AssignMap(nav_cells, map, width, height);
+
+            for (int route_i = 0; route_i < 30; ++route_i)
+            {
+                const int sx = rand_x(rng), sy = rand_y(rng);
+                const int ex = rand_x(rng), ey = rand_y(rng);
+                std::vector<int> path_words, cpath_words, path_cells, cpath_cells;
+                const auto res_words = nav_words.NavigateRefined(sx, sy, ex, ey, path_words, cpath_words);
+                const auto res_cells = nav_cells.NavigateRefined(sx, sy, ex, ey, path_cells, cpath_cells);
+                ASSERT_EQ(res_cells, res_words);
+                ASSERT_EQ(cpath_cells, cpath_words);
+                ASSERT_EQ(path_cells, path_words);
+            }
+        }
+    }
+}
+
+// Tests that assigning a changed map of the same size updates the grid
+// same as if it was assigned to a new navigation
+TEST(RouteFinder, JPSReassignChangedMap) {
+    std::mt19937 rng(54321);
+    const int width = 150, height = 100;
+    std::uniform_int_distribution<int> rand_x(0, width - 1);
+    std::uniform_int_distribution<int> rand_y(0, height - 1);
+    Navigation nav_reused;
+    for (int map_i = 0; map_i < 6; ++map_i)
+    {
+        const auto map = MakeRandomMap(rng, width, height);
+        Navigation nav_new;
+        AssignMap(nav_new, map, width, height);
+        AssignMap(nav_reused, map, width, height);
+
+        for (int route_i = 0; route_i < 30; ++route_i)
+        {
+            const int sx = rand_x(rng), sy = rand_y(rng);
+            const int ex = rand_x(rng), ey = rand_y(rng);
+            std::vector<int> path_new, cpath_new, path_reused, cpath_reused;
+            const auto res_new = nav_new.NavigateRefined(sx, sy, ex, ey, path_new, cpath_new);
+            const auto res_reused = nav_reused.NavigateRefined(sx, sy, ex, ey, path_reused, cpath_reused);
+            ASSERT_EQ(res_new, res_reused);
+            ASSERT_EQ(cpath_new, cpath_reused);
+            ASSERT_EQ(path_new, path_reused);
+        }
+    }
+}
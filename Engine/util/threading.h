@@ -17,8 +17,10 @@
 //=============================================================================
 #ifndef __AGS_EE_UTIL__THREADING_H
 #define __AGS_EE_UTIL__THREADING_H
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 
 namespace AGS
 {
@@ -65,6 +67,61 @@ private:
     std::condition_variable *_cv = nullptr;
 };
 
+// SpscRingBuffer is a fixed-size lock-free queue, which is safe to use
+// by exactly one producer thread and exactly one consumer thread.
+// Capacity is rounded up to the power of two.
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    SpscRingBuffer(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        _items.resize(size);
+        _mask = size - 1;
+    }
+
+    // Tells if the queue is empty; reliable only when called by the consumer
+    bool IsEmpty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    // Puts an item into the queue; returns false if the queue is full.
+    // Must be called only by the producer thread.
+    bool Push(const T &item)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) > _mask)
+            return false; // full
+        _items[tail & _mask] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Takes an item from the queue; returns false if the queue is empty.
+    // Must be called only by the consumer thread.
+    bool Pop(T &item)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false; // empty
+        item = std::move(_items[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> _items;
+    size_t _mask = 0u;
+    // Head is advanced by the consumer, tail by the producer;
+    // both increase monotonically, and are wrapped by mask when indexing
+    std::atomic<size_t> _head{0u};
+    std::atomic<size_t> _tail{0u};
+};
+
 } // namespace Engine
 } // namespace AGS
 